@@ -3,15 +3,10 @@
 
 #include <boost/scoped_ptr.hpp>
 
-// FIXME: in a real example an installed version of the adapter has to be used,
-// which has the headers installed under the namespace folder
-//#include <ControlSystemAdapter/DevicePVManager.h>
-//#include <ControlSystemAdapter/ProcessScalar.h>
-//#include <ControlSystemAdapter/DeviceSynchronizationUtility.h>
-//#include <ControlSystemAdapter/SynchronizationDirection.h>
+// FIXME: in a real example an installed version of the adapter has to be used
 #include <ChimeraTK/ControlSystemAdapter/DevicePVManager.h>
 #include <ChimeraTK/ControlSystemAdapter/DeviceSynchronizationUtility.h>
-#include <ChimeraTK/ControlSystemAdapter/ProcessScalar.h>
+#include <ChimeraTK/ControlSystemAdapter/ProcessArray.h>
 #include <ChimeraTK/ControlSystemAdapter/SynchronizationDirection.h>
 
 /** Some dummy "hardware". You can read/write a voltage (int). */
@@ -35,13 +30,16 @@ class IndependentControlCore {
   ChimeraTK::DevicePVManager::SharedPtr _processVariableManager;
 
   /** The target voltage to be transmitted to the hardware */
-  ChimeraTK::ProcessScalar<int>::SharedPtr _targetVoltage;
+  ChimeraTK::ProcessArray<int>::SharedPtr _targetVoltage;
 
   /** The monitor voltage which is read back from the hardware */
-  ChimeraTK::ProcessScalar<int>::SharedPtr _monitorVoltage;
+  ChimeraTK::ProcessArray<int>::SharedPtr _monitorVoltage;
 
   Hardware _hardware; ///< Some hardware
 
+  /** Synchronises the process variables with the control system */
+  boost::scoped_ptr<ChimeraTK::DeviceSynchronizationUtility> _syncUtil;
+
   boost::scoped_ptr<boost::thread> _deviceThread;
 
   void mainLoop();
@@ -54,14 +52,21 @@ class IndependentControlCore {
   IndependentControlCore(boost::shared_ptr<ChimeraTK::DevicePVManager> const& processVariableManager)
   // initialise all process variables, using the factory
   : _processVariableManager(processVariableManager),
-    _targetVoltage(
-        processVariableManager->createProcessScalar<int>(ChimeraTK::controlSystemToDevice, "TARGET_VOLTAGE")),
-    _monitorVoltage(
-        processVariableManager->createProcessScalar<int>(ChimeraTK::deviceToControlSystem, "MONITOR_VOLTAGE")) {
+    _targetVoltage(processVariableManager->createProcessArray<int>(
+        ChimeraTK::SynchronizationDirection::controlSystemToDevice, "TARGET_VOLTAGE", 1)),
+    _monitorVoltage(processVariableManager->createProcessArray<int>(
+        ChimeraTK::SynchronizationDirection::deviceToControlSystem, "MONITOR_VOLTAGE", 1)) {
     // initialise the hardware here
-    *_targetVoltage = 0;
-    *_monitorVoltage = 0;
-    _hardware.setVoltage(*_targetVoltage);
+    _targetVoltage->accessData(0) = 0;
+    _monitorVoltage->accessData(0) = 0;
+    _hardware.setVoltage(_targetVoltage->accessData(0));
+
+    // all process variables have been created, so the synchronisation utility can be set up
+    _syncUtil.reset(new ChimeraTK::DeviceSynchronizationUtility(processVariableManager));
+
+    // a callback is called for each new value of the process variable
+    _syncUtil->addReceiveNotificationListener("TARGET_VOLTAGE",
+        [this](const ChimeraTK::ProcessVariable::SharedPtr&) { _hardware.setVoltage(_targetVoltage->accessData(0)); });
 
     // start the device thread, which is executing the main loop
     _deviceThread.reset(new boost::thread(boost::bind(&IndependentControlCore::mainLoop, this)));
@@ -69,21 +74,31 @@ class IndependentControlCore {
 
   ~IndependentControlCore() {
     // stop the device thread before any other destructors are called
-    _deviceThread->interrupt();
+    _syncUtil->interrupt();
     _deviceThread->join();
   }
 };
 
 inline void IndependentControlCore::mainLoop() {
-  ChimeraTK::DeviceSynchronizationUtility syncUtil(_processVariableManager);
-
-  while(!boost::this_thread::interruption_requested()) {
-    syncUtil.receiveAll();
-    *_monitorVoltage = _hardware.getVoltage();
-
-    _hardware.setVoltage(*_targetVoltage);
-    syncUtil.sendAll();
-    boost::this_thread::sleep_for(boost::chrono::milliseconds(100));
+  try {
+    // publish the initial monitor value
+    _syncUtil->markModified(_monitorVoltage);
+
+    while(true) {
+      // send the monitor value if it has changed
+      int voltage = _hardware.getVoltage();
+      if(voltage != _monitorVoltage->accessData(0)) {
+        _monitorVoltage->accessData(0) = voltage;
+        _syncUtil->markModified(_monitorVoltage);
+      }
+      _syncUtil->sendAll();
+
+      // sleep until the control system sends a new target voltage, no polling needed
+      _syncUtil->receiveAll();
+    }
+  }
+  catch(boost::thread_interrupted&) {
+    // interrupted by the destructor
   }
 }
 
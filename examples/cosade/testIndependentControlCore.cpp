@@ -4,7 +4,7 @@
 // Only after defining the name include the unit test header.
 #include <boost/test/included/unit_test.hpp>
 
-#include <ChimeraTK/ControlSystemAdapter/ControlSystemSynchronizationUtility.h>
+#include <ChimeraTK/ControlSystemAdapter/ControlSystemPVManager.h>
 
 #include "IndependentControlCore.h"
 
@@ -21,52 +21,21 @@ BOOST_AUTO_TEST_CASE(independentControlCoreTest) {
 
   IndependentControlCore controlCore(devManager);
 
-  ControlSystemSynchronizationUtility syncUtil(csManager);
+  ProcessArray<int>::SharedPtr targetVoltage = csManager->getProcessArray<int>("TARGET_VOLTAGE");
+  ProcessArray<int>::SharedPtr monitorVoltage = csManager->getProcessArray<int>("MONITOR_VOLTAGE");
 
-  ProcessScalar<int>::SharedPtr targetVoltage = csManager->getProcessScalar<int>("TARGET_VOLTAGE");
-  ProcessScalar<int>::SharedPtr monitorVoltage = csManager->getProcessScalar<int>("MONITOR_VOLTAGE");
-
-  // start with -1 for both voltages
-  *targetVoltage = -1;
-  *monitorVoltage = -1;
-
-  // the other side has a timeout of 100 ms, so we wait 1 second to be safe,
-  // but we look every 10 ms (not too frequent, but only with 10 % of additional
-  // latency)
-  // syncUtil.waitForNotifications(1000000, 10000);
-  // Note: as waitForNotification does not work as expected, the functionality
-  // is
-  // done manually for just the one variable we are receiving.
-  for(size_t i = 0; i < 100; ++i) {
-    boost::this_thread::sleep_for(boost::chrono::milliseconds(10));
-    if(monitorVoltage->receive()) {
-      break;
-    }
-  }
-
-  // the target voltage must not have changed
-  BOOST_CHECK(*targetVoltage == -1);
+  // The control core sends the initial monitor value right away. The read blocks until it has arrived, no sleeping or
+  // polling is needed.
+  monitorVoltage->read();
   // the monitor voltage has to be 0 now, like in the hardware
-  BOOST_CHECK(*monitorVoltage == 0);
-
-  *targetVoltage = 42;
-  targetVoltage->send();
+  BOOST_CHECK_EQUAL(monitorVoltage->accessData(0), 0);
 
-  // Wait until we read something back and check that the expected value is
-  // there. This is not nevessarily the case on the first read, so we put a
-  // limit to 10. Note that the number of actual receive attempty is higher,
-  // because we read every 10 ms while the other side is sending every 100 ms.
-  for(size_t receiveCounter = 0; receiveCounter < 10; /*empty*/) {
-    boost::this_thread::sleep_for(boost::chrono::milliseconds(10));
-    if(monitorVoltage->receive()) {
-      ++receiveCounter;
-      if(*monitorVoltage == 42) {
-        break;
-      }
-    }
-  }
+  targetVoltage->accessData(0) = 42;
+  targetVoltage->write();
 
-  BOOST_CHECK(*monitorVoltage == 42);
+  // The control core wakes up on the new target voltage and sends back the new monitor value.
+  monitorVoltage->read();
+  BOOST_CHECK_EQUAL(monitorVoltage->accessData(0), 42);
 }
 
 BOOST_AUTO_TEST_SUITE_END()
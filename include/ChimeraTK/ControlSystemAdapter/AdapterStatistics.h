@@ -0,0 +1,130 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include "ProcessArray.h"
+
+#include <ChimeraTK/RegisterPath.h>
+
+#include <boost/thread.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace ChimeraTK {
+
+  class DevicePVManager;
+
+  namespace detail {
+
+    /** Global flag if the adapter statistics are collected. Set while at least one StatisticsPublisher exists. */
+    extern std::atomic<bool> adapterStatisticsEnabled; // std::atomic<bool> defaults to false
+
+    /** Flag set in the thread of the StatisticsPublisher, so its own writes are not counted. */
+    extern thread_local bool adapterStatisticsSuppressedInThread;
+
+    /** Check whether the adapter statistics are currently collected for operations of the calling thread. */
+    inline bool isAdapterStatisticsEnabled() {
+      return adapterStatisticsEnabled.load(std::memory_order_relaxed) && !adapterStatisticsSuppressedInThread;
+    }
+
+    /** Counters collected by the process arrays and the persistent data storage. All counters are updated with relaxed
+     *  atomic operations. */
+    struct AdapterStatisticsCounters {
+      /** Total number of write operations of all process arrays */
+      std::atomic<uint64_t> writes{0};
+
+      /** Total number of read operations of all process arrays which have received new data */
+      std::atomic<uint64_t> reads{0};
+
+      /** Total number of values which have been overwritten in a full queue before being read */
+      std::atomic<uint64_t> dataLost{0};
+
+      /** Total number of values discarded by multi-producer process arrays with MultiProducerOrdering::orderedByVersion
+       *  because another producer has already sent a newer version */
+      std::atomic<uint64_t> discarded{0};
+
+      /** Maximum number of values seen in a queue right after a write. Reset by the StatisticsPublisher. */
+      std::atomic<uint64_t> maxQueueOccupancy{0};
+
+      /** Duration of the last flush of the persistent data storage in nanoseconds */
+      std::atomic<uint64_t> persistenceFlushDuration{0};
+
+      /** Size of the persistency file after the last flush in bytes */
+      std::atomic<uint64_t> persistenceFileSize{0};
+    };
+
+    /** The global instance of the counters */
+    extern AdapterStatisticsCounters adapterStatisticsCounters;
+
+    /** Update the maximum queue occupancy, if the given value is larger than the current maximum. */
+    inline void updateMaxQueueOccupancy(uint64_t occupancy) {
+      auto& maxOccupancy = adapterStatisticsCounters.maxQueueOccupancy;
+      auto current = maxOccupancy.load(std::memory_order_relaxed);
+      while(occupancy > current && !maxOccupancy.compare_exchange_weak(current, occupancy, std::memory_order_relaxed)) {
+      }
+    }
+
+  } // namespace detail
+
+  /**
+   * Periodically publishes the adapter statistics to a set of process variables. Instances are created through
+   * DevicePVManager::enableStatistics(), which also creates the process variables.
+   *
+   * The following process variables are created below the given prefix (all device to control system):
+   *  - writesPerSecond (float64): Write operations of all process arrays per second
+   *  - readsPerSecond (float64): Read operations with new data of all process arrays per second
+   *  - dataLossCount (uint64): Total number of values lost due to full queues
+   *  - discardCount (uint64): Total number of values discarded by multi-producer process arrays because a newer
+   *    version had already been sent
+   *  - maxQueueOccupancy (uint32): Maximum number of values queued in any process array during the last interval
+   *  - persistenceFlushDuration (float64): Duration of the last persistency file write in milliseconds
+   *  - persistenceFileSize (uint64): Size of the persistency file in bytes
+   *  - residentMemory (uint64): Resident set size of the process in bytes
+   *
+   * The writes performed by the publisher itself are not counted. Reads of the statistics variables by the control
+   * system are counted like any other read.
+   *
+   * The counters are process-wide. If several PV managers in one process have enabled the statistics (e.g. the
+   * applications of a MultiApplicationHost), each publisher reports the totals over all of them. The counters are
+   * updated while at least one publisher exists, the process arrays stop counting when the last one is destroyed.
+   */
+  class StatisticsPublisher {
+   public:
+    StatisticsPublisher(DevicePVManager& pvManager, const RegisterPath& prefix, std::chrono::milliseconds interval);
+
+    /** Stops the publishing thread. */
+    ~StatisticsPublisher();
+
+    StatisticsPublisher(const StatisticsPublisher&) = delete;
+    StatisticsPublisher& operator=(const StatisticsPublisher&) = delete;
+
+   private:
+    void publisherThreadFunction();
+
+    /** Publish the current values. Called once per interval from the publisher thread. */
+    void publish(double secondsSinceLastUpdate);
+
+    ProcessArray<double>::SharedPtr _writesPerSecond;
+    ProcessArray<double>::SharedPtr _readsPerSecond;
+    ProcessArray<uint64_t>::SharedPtr _dataLossCount;
+    ProcessArray<uint64_t>::SharedPtr _discardCount;
+    ProcessArray<uint32_t>::SharedPtr _maxQueueOccupancy;
+    ProcessArray<double>::SharedPtr _persistenceFlushDuration;
+    ProcessArray<uint64_t>::SharedPtr _persistenceFileSize;
+    ProcessArray<uint64_t>::SharedPtr _residentMemory;
+
+    /** Counter values at the last update, used to compute the rates */
+    uint64_t _lastWrites{0};
+    uint64_t _lastReads{0};
+
+    std::chrono::milliseconds const _interval;
+
+    boost::thread _publisherThread;
+  };
+
+  /** Return the resident set size of the process in bytes, or 0 if it cannot be determined. */
+  uint64_t getResidentMemory();
+
+} // namespace ChimeraTK
@@ -4,7 +4,11 @@
 #ifndef CHIMERA_TK_CONTROL_SYSTEM_ADAPTER_APPLICATION_BASE_H
 #define CHIMERA_TK_CONTROL_SYSTEM_ADAPTER_APPLICATION_BASE_H
 
+#include <functional>
 #include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
 
 #include "DevicePVManager.h"
 
@@ -37,6 +41,10 @@ namespace ChimeraTK {
      * manager. */
     virtual void initialise() = 0;
 
+    /** Call initialise() inside the startup phase "ApplicationBase::initialise" (see StartupPhase). Control system
+     *  adapters should call this instead of initialise(), so the largest part of the startup is always profiled. */
+    void initialiseProfiled();
+
     /** Optimise unmapped variables to avoid unnecessary copies. The application must implement this function. The
      *  ControlSystemAdapter implementation should call it with a list of PV names which are not mapped, i.e. the
      *  Application does not need to update the values of these PVs. If this function is not called, no such optimisation
@@ -53,8 +61,8 @@ namespace ChimeraTK {
      * operation. */
     virtual void run() = 0;
 
-    /** This will remove the global pointer to the instance and allows creating
-     * another instance afterwards. This is mostly useful for writing tests, as it
+    /** This will remove the global pointer to the instance (if it points to this
+     * application) and allows creating another instance afterwards. This is mostly useful for writing tests, as it
      * allows to run several applications sequentially in the same executable. It
      * is mandatory to call this function inside the descructor of the
      * implemention of this class. */
@@ -68,12 +76,38 @@ namespace ChimeraTK {
     boost::shared_ptr<ChimeraTK::DevicePVManager> getPVManager() { return _processVariableManager; }
 
     /** Obtain instance of the application. Will throw an exception if called
-     * before the instance has been created by the control system adapter. */
+     * before the instance has been created by the control system adapter.
+     * While a MultiApplicationHost is calling initialise(),
+     * optimiseUnmappedVariables() or run() of one of its applications, this
+     * returns that application in the calling thread. */
     static ApplicationBase& getInstance();
 
     /** Return the name of the application */
     [[nodiscard]] const std::string& getName() const { return _applicationName; }
 
+    /** Register a module for the staged initialisation. The initialisation
+     * function of the module is called by initialiseModules() with a
+     * DevicePVManager placing all process variables below the given prefix
+     * (the PV set of the module), after the initialisation functions of all
+     * modules listed as dependencies have completed. Modules without mutual
+     * dependencies are initialised in parallel, so their initialisation
+     * functions must not access shared state without synchronisation (the PV
+     * creation itself is thread safe). Registering two modules with the same
+     * name throws a ChimeraTK::logic_error. */
+    void registerInitialisationModule(const std::string& name, const std::vector<std::string>& dependencies,
+        std::function<void(DevicePVManager&)> initialiseFunction, const ChimeraTK::RegisterPath& pvPrefix = "/");
+
+    /** Initialise all modules registered with registerInitialisationModule()
+     * on a pool of the given number of threads. This is intended to be called
+     * from initialise(). The function returns after all modules have been
+     * initialised, so everything is complete before run() is called. If an
+     * initialisation function throws, no further modules are started and the
+     * first exception is rethrown once all running modules have completed.
+     * Unknown dependencies and dependency cycles are detected before any
+     * module is started and result in a ChimeraTK::logic_error. The list of
+     * registered modules is cleared afterwards. */
+    void initialiseModules(size_t nThreads = std::thread::hardware_concurrency());
+
     /** Obtain the PersistentDataStorage object. You can specify the write interval in seconds. */
     boost::shared_ptr<PersistentDataStorage> getPersistentDataStorage(unsigned int writeInterval = PersistentDataStorage::DEFAULT_WRITE_INTERVAL) {
       if(!_persistentDataStorage) {
@@ -96,16 +130,38 @@ namespace ChimeraTK {
     /** Flag if shutdown() has been called. */
     bool _hasBeenShutdown{false};
 
+    /** Module for the staged initialisation, see registerInitialisationModule() */
+    struct InitialisationModule {
+      std::string name;
+      std::vector<std::string> dependencies;
+      std::function<void(DevicePVManager&)> initialiseFunction;
+      ChimeraTK::RegisterPath pvPrefix;
+    };
+
+    /** Modules registered for the staged initialisation */
+    std::vector<InitialisationModule> _initialisationModules;
+
     /** Pointer to the only instance of the Application */
     static ApplicationBase* instance;
 
     /** Mutex for thread-safety when setting the instance pointer */
     static std::recursive_mutex instanceMutex;
 
+    /** Flag to signal to the constructor that the application is being created by
+     * a MultiApplicationHost, so the global instance pointer is not set.
+     * Protected by the instanceMutex. */
+    static bool _hostIsCreating;
+
+    /** Application of a MultiApplicationHost which is currently being called in
+     * this thread, see getInstance(). */
+    static thread_local ApplicationBase* _hostedInstance;
+
     template<typename APPLICATION_TYPE>
     friend class ApplicationFactory;
 
     friend class ApplicationFactoryBase;
+
+    friend class MultiApplicationHost;
   };
 
 } /* namespace ChimeraTK */
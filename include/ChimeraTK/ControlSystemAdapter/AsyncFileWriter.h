@@ -0,0 +1,57 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include <memory>
+#include <string>
+
+namespace ChimeraTK {
+
+  /**
+   * Asynchronous writer which atomically replaces a file. Used by the PersistentDataStorage, so the serialisation of
+   * the next part of the file overlaps with the I/O of the previous part.
+   *
+   * The content is written to a temporary file next to the target (name of the target plus ".new") in chunks, which
+   * are submitted with append() and written in the background. commit() then flushes the data with fdatasync() and
+   * renames the temporary file to the target, so the target is always either the old or the complete new file.
+   *
+   * If the library has been built with liburing and the kernel supports it, the chunks are submitted to an io_uring
+   * and the fdatasync and rename are submitted as one linked chain after all writes. Otherwise a helper thread performs
+   * the same operations with the normal system calls.
+   *
+   * The writer can be used for any number of files one after another, but only by one thread at a time.
+   */
+  class AsyncFileWriter {
+   public:
+    /** Create the writer. If allowIoUring is false, the helper thread is used even if io_uring is available. */
+    explicit AsyncFileWriter(bool allowIoUring = true);
+    ~AsyncFileWriter();
+
+    AsyncFileWriter(const AsyncFileWriter&) = delete;
+    AsyncFileWriter& operator=(const AsyncFileWriter&) = delete;
+
+    /** Start writing a new version of the given file. Throws std::system_error if the temporary file cannot be
+     *  created. A previous file must have been committed or aborted. */
+    void open(const std::string& fileName);
+
+    /** Submit the next chunk of the file. Returns without waiting for the chunk to be written. Errors are reported by
+     *  commit(). */
+    void append(std::string&& chunk);
+
+    /** Wait until all chunks have been written, flush the file to the disk and replace the target file. Throws
+     *  std::system_error if any of the operations has failed. In this case the target file is left unchanged. */
+    void commit();
+
+    /** Discard the new file, e.g. if the serialisation has failed. The target file is left unchanged. */
+    void abort() noexcept;
+
+    /** Check whether the chunks are written through io_uring. */
+    [[nodiscard]] bool isUsingIoUring() const;
+
+    class Backend;
+
+   private:
+    std::unique_ptr<Backend> _backend;
+  };
+
+} // namespace ChimeraTK
@@ -137,6 +137,12 @@ namespace ChimeraTK {
 
     void interrupt() override { _receiver->interrupt(); }
 
+    void setPublishCounter(std::atomic<uint64_t>* counter) override {
+      if(_sender) {
+        _sender->setPublishCounter(counter);
+      }
+    }
+
     /**
      * Returns a unique ID of this process variable, which will be indentical
      * for the receiver and sender side of the same variable but different for
@@ -249,6 +255,9 @@ namespace ChimeraTK {
     TransferElement::_readQueue = _receiver->getReadQueue().template then<void>(
         [this] {
           if(_receiver->_localBuffer.versionNumber < TransferElement::getVersionNumber()) {
+            if(detail::isTransferTracingEnabled()) {
+              detail::recordTraceInstant("reject", this->traceNameId());
+            }
             if(_valueRejectCallback) {
               _valueRejectCallback();
             }
@@ -293,6 +302,7 @@ namespace ChimeraTK {
       // our internal validity flag
       TransferElement::setDataValidity(_receiver->dataValidity());
       _sender->setDataValidity(TransferElement::dataValidity());
+      this->publishLatestValue();
 
       // If we have a persistent data-storage, we have to update it. We have to
       // do this because a (new) value received from the other side should be
@@ -348,12 +358,16 @@ namespace ChimeraTK {
       sendInitialValue = true;
     }
     _persistentDataStorage = storage;
-    _persistentDataStorageID = _persistentDataStorage->registerVariable<T>(
-        ChimeraTK::TransferElement::getName(), ChimeraTK::NDRegisterAccessor<T>::getNumberOfSamples());
+    {
+      StartupPhase phase("PersistentDataStorage::registerVariable");
+      _persistentDataStorageID = _persistentDataStorage->registerVariable<T>(
+          ChimeraTK::TransferElement::getName(), ChimeraTK::NDRegisterAccessor<T>::getNumberOfSamples());
+    }
     if(sendInitialValue) {
+      StartupPhase phase("setPersistentDataStorage initial value write");
       ChimeraTK::NDRegisterAccessor<T>::buffer_2D[0] =
           _persistentDataStorage->retrieveValue<T>(_persistentDataStorageID);
-      doWriteTransfer({});
+      doWriteTransfer(VersionNumberBatch::next());
     }
   }
 
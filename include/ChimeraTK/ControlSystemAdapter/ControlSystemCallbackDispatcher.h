@@ -0,0 +1,127 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include "ControlSystemPVManager.h"
+#include "ProcessVariable.h"
+
+#include <ChimeraTK/cppext/future_queue.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ChimeraTK {
+
+  /**
+   * Shared update path for control system adapters: callbacks are registered per process variable and executed on a
+   * pool of worker threads each time the process variable has received a new value from the device side. This replaces
+   * the reader threads each adapter would otherwise implement.
+   *
+   * One dispatcher thread waits for the notifications of all registered process variables. It does not read the values
+   * itself but combines the process variables which have pending values into tasks of up to maxBatchSize process
+   * variables. The tasks are distributed over the queues of the worker threads. Idle workers steal tasks from the
+   * queues of the others.
+   *
+   * The worker executing a task reads one value of each of its process variables with readNonBlocking() and calls the
+   * callback, until no values are pending. A process variable is part of at most one task at a time, so its values are
+   * received and its callbacks are called in order and never concurrently. Callbacks of different process variables
+   * run concurrently.
+   *
+   * The registered process variables must not be read by anything else while the dispatcher is running, and must not be
+   * part of a ReadAnyGroup or another dispatcher. Only process variables with AccessMode::wait_for_new_data can be
+   * registered. Exceptions thrown by callbacks are printed and otherwise ignored.
+   */
+  class ControlSystemCallbackDispatcher {
+   public:
+    /** Callback type. The argument is the process variable which has received the new value. */
+    using Callback = std::function<void(const ProcessVariable::SharedPtr&)>;
+
+    /** Create the dispatcher with the given number of worker threads. Zero uses one worker per hardware thread. */
+    explicit ControlSystemCallbackDispatcher(const boost::shared_ptr<ControlSystemPVManager>& pvManager,
+        size_t nWorkers = 0, size_t maxBatchSize = 16);
+
+    /** Stop the dispatcher, see stop(). */
+    ~ControlSystemCallbackDispatcher();
+
+    ControlSystemCallbackDispatcher(const ControlSystemCallbackDispatcher&) = delete;
+    ControlSystemCallbackDispatcher& operator=(const ControlSystemCallbackDispatcher&) = delete;
+
+    /** Register a callback for the process variable with the given name. Replaces a previously registered callback for
+     *  the same variable. Throws a ChimeraTK::logic_error if there is no readable process variable with
+     *  AccessMode::wait_for_new_data with the given name, or if the dispatcher has already been started. */
+    void addCallback(const ChimeraTK::RegisterPath& processVariableName, Callback callback);
+
+    /** Start the dispatcher and worker threads. Values which have been received before are dispatched immediately.
+     *  Throws a ChimeraTK::logic_error if the dispatcher has already been started. */
+    void start();
+
+    /** Stop all threads. Running callbacks are completed, queued tasks are discarded. The dispatcher cannot be started
+     *  again. */
+    void stop();
+
+   private:
+    struct Entry {
+      ProcessVariable::SharedPtr processVariable;
+      Callback callback;
+
+      /** Number of values notified by the dispatcher thread but not yet read by a worker. The process variable is part
+       *  of a task while this is non-zero. */
+      std::atomic<size_t> nPending{0};
+    };
+
+    using Task = std::vector<size_t>;
+
+    /** Task queue of one worker. The owner takes tasks from the front, others steal from the back. */
+    struct WorkerQueue {
+      std::mutex mutex;
+      std::deque<Task> tasks;
+    };
+
+    void dispatcherThreadFunction();
+    void workerThreadFunction(size_t workerIndex);
+
+    /** Distribute the task to the queues of the workers in turn. */
+    void enqueue(Task task);
+
+    /** Take a task from the worker's own queue, or steal it from another worker. Returns false if all are empty. */
+    bool takeTask(size_t workerIndex, Task& task);
+
+    /** Read all pending values of the entry and call its callback for each of them. */
+    void process(Entry& entry);
+
+    boost::shared_ptr<ControlSystemPVManager> _pvManager;
+    size_t _nWorkers;
+    size_t _maxBatchSize;
+
+    /** Registered process variables, in the order of registration. The index is also the index in the when_any. */
+    std::vector<std::unique_ptr<Entry>> _entries;
+    std::map<std::string, size_t> _entryIndices;
+
+    /** Queue pushed to by stop(). It is the last queue of the when_any, so its index is _entries.size(). */
+    cppext::future_queue<void> _stopQueue{1};
+
+    /** Indices of the process variables which have received a value, in the order of the notifications */
+    cppext::future_queue<size_t> _notifications;
+
+    std::vector<std::unique_ptr<WorkerQueue>> _workerQueues;
+    size_t _nextWorkerQueue{0}; // only used by the dispatcher thread
+
+    /** Number of tasks in all worker queues which have not been claimed by a worker yet, and the shutdown flag */
+    std::mutex _mutex;
+    std::condition_variable _workerCondition;
+    size_t _nUnclaimedTasks{0};
+    bool _shutdown{false};
+
+    bool _started{false};
+    std::thread _dispatcherThread;
+    std::vector<std::thread> _workerThreads;
+  };
+
+} // namespace ChimeraTK
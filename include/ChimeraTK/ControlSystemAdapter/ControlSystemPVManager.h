@@ -67,6 +67,18 @@ namespace ChimeraTK {
     template<class T>
     typename ProcessArray<T>::SharedPtr getProcessArray(const ChimeraTK::RegisterPath& processVariableName) const;
 
+    /**
+     * Like getProcessArray(const ChimeraTK::RegisterPath&), but takes the name
+     * as std::string, std::string_view or string literal. Names which are
+     * already normalised (see PVManager::isNormalisedName()) are looked up
+     * without constructing a ChimeraTK::RegisterPath, which avoids an
+     * allocation per lookup.
+     */
+    template<class T, typename NAME, typename = detail::EnableIfStringName<NAME>>
+    typename ProcessArray<T>::SharedPtr getProcessArray(const NAME& processVariableName) const {
+      return withPersistentDataStorage(_pvManager->getProcessArray<T>(std::string_view(processVariableName)).first);
+    }
+
     /**
      * Returns a reference to a process scalar or array that has been created
      * earlier using the
@@ -91,6 +103,15 @@ namespace ChimeraTK {
      */
     ProcessVariable::SharedPtr getProcessVariable(const ChimeraTK::RegisterPath& processVariableName) const;
 
+    /**
+     * Like getProcessVariable(const ChimeraTK::RegisterPath&), but takes the
+     * name as string, see getProcessArray(const NAME&).
+     */
+    template<typename NAME, typename = detail::EnableIfStringName<NAME>>
+    ProcessVariable::SharedPtr getProcessVariable(const NAME& processVariableName) const {
+      return withPersistentDataStorage(_pvManager->getProcessVariable(std::string_view(processVariableName)).first);
+    }
+
     /**
      * Checks whether a process scalar or array with the specified name exists.
      */
@@ -98,6 +119,15 @@ namespace ChimeraTK {
       return _pvManager->hasProcessVariable(processVariableName);
     }
 
+    /**
+     * Like hasProcessVariable(ChimeraTK::RegisterPath const&), but takes the
+     * name as string, see getProcessArray(const NAME&).
+     */
+    template<typename NAME, typename = detail::EnableIfStringName<NAME>>
+    bool hasProcessVariable(const NAME& processVariableName) const {
+      return _pvManager->hasProcessVariable(std::string_view(processVariableName));
+    }
+
     /**
      * Returns a vector containing all process variables that are registered
      * with this PV manager.
@@ -113,7 +143,104 @@ namespace ChimeraTK {
       _persistentDataStorage = ApplicationBase::getInstance().getPersistentDataStorage(writeInterval);
     }
 
+    /**
+     * Use the given persistent data storage for all process variables below the
+     * given prefix instead of the one enabled with enablePersistentDataStorage().
+     * This is used by the MultiApplicationHost, so each hosted application keeps
+     * its own persistency file.
+     */
+    void enablePersistentDataStorage(
+        const ChimeraTK::RegisterPath& prefix, boost::shared_ptr<PersistentDataStorage> storage) {
+      _prefixedPersistentDataStorages[std::string(prefix) + "/"] = std::move(storage);
+    }
+
+    /**
+     * Set the persistence policy of the process variable with the given name in the persistent data storage
+     * responsible for it, see PersistentDataStorage::setPersistencePolicy(). Throws a ChimeraTK::logic_error if no
+     * persistent data storage has been enabled for the variable.
+     */
+    void setPersistencePolicy(const ChimeraTK::RegisterPath& processVariableName, PersistencePolicy policy);
+
+    /**
+     * Returns the executor for synchronisation functions, which is shared with
+     * the DevicePVManager. Control system adapters lock the groups of the
+     * process variables they access (see
+     * SynchronisationExecutor::lockProcessVariables()) instead of one global
+     * lock.
+     */
+    [[nodiscard]] SynchronisationExecutor& getSynchronisationExecutor() const {
+      return _pvManager->getSynchronisationExecutor();
+    }
+
+    /**
+     * Returns the table with the publish counters of all process variables.
+     * Use a PublishCounterScanner to find the process variables which have
+     * received new values from the device side.
+     */
+    [[nodiscard]] const PublishCounterTable& getPublishCounterTable() const {
+      return _pvManager->getPublishCounterTable();
+    }
+
+    /**
+     * Interrupts all threads blocked in a read of a control system side
+     * process variable, see TransferElement::interrupt(). Returns the number
+     * of interrupted process variables.
+     */
+    size_t interruptAll() { return _pvManager->interruptAll(true, false); }
+
+    /**
+     * Prepares a fast shutdown: stops the writer threads of the persistent
+     * data storages (aborting a periodic write in progress, the final write
+     * is still done when the storage is destroyed) and interrupts all blocked
+     * readers on both the control system and the device side. The process
+     * variables stay usable, reads of interrupted process variables throw
+     * boost::thread_interrupted once. If a transfer trace file has been set,
+     * the trace is written now (see dumpTransferTrace()).
+     */
+    void shutdown();
+
+    /**
+     * Waits until the device side has published the initial values of its
+     * process variables with DevicePVManager::publishInitialValues(). Control
+     * system adapters can call this before starting to read the process
+     * variables, so they receive the initial values in one go instead of
+     * waking up for each of them. Applications which do not call
+     * publishInitialValues() never give the signal, so a timeout should be
+     * used unless the application is known to call it.
+     */
+    void waitForInitialValues() const { _pvManager->waitForInitialValues(std::chrono::steady_clock::duration::max()); }
+
+    /**
+     * Like waitForInitialValues(), but waits at most for the given time.
+     * Returns whether the initial values have been published.
+     */
+    bool waitForInitialValues(std::chrono::steady_clock::duration timeout) const {
+      return _pvManager->waitForInitialValues(timeout);
+    }
+
    private:
+    /**
+     * Attach the responsible persistent data storage to the process variable,
+     * if it is writeable and a storage is enabled for it. Returns the process
+     * variable.
+     */
+    template<typename PV>
+    PV withPersistentDataStorage(PV pv) const {
+      if(pv->isWriteable()) {
+        auto storage = getPersistentDataStorage(pv->getName());
+        if(storage) {
+          pv->setPersistentDataStorage(storage);
+        }
+      }
+      return pv;
+    }
+
+    /**
+     * Return the persistent data storage responsible for the process variable
+     * with the given name, or nullptr if none is enabled.
+     */
+    [[nodiscard]] boost::shared_ptr<PersistentDataStorage> getPersistentDataStorage(const std::string& name) const;
+
     /**
      * Reference to the PVManager backing this facade for the control
      * system.
@@ -128,16 +255,19 @@ namespace ChimeraTK {
      * outside, thus this is a legit use of the mutable qualifier.
      */
     mutable boost::shared_ptr<PersistentDataStorage> _persistentDataStorage;
+
+    /**
+     * Persistent data storages for prefixes, see
+     * enablePersistentDataStorage(const ChimeraTK::RegisterPath&, boost::shared_ptr<PersistentDataStorage>).
+     * The key is the prefix including a trailing slash.
+     */
+    std::map<std::string, boost::shared_ptr<PersistentDataStorage>> _prefixedPersistentDataStorages;
   };
 
   template<class T>
   typename ProcessArray<T>::SharedPtr ControlSystemPVManager::getProcessArray(
       const ChimeraTK::RegisterPath& processVariableName) const {
-    auto pv = _pvManager->getProcessArray<T>(processVariableName).first;
-    if(_persistentDataStorage && pv->isWriteable()) {
-      pv->setPersistentDataStorage(_persistentDataStorage);
-    }
-    return pv;
+    return withPersistentDataStorage(_pvManager->getProcessArray<T>(processVariableName).first);
   }
 
 } // namespace ChimeraTK
@@ -3,13 +3,16 @@
 
 namespace ChimeraTK {
   class DevicePVManager;
+  class StatisticsPublisher;
 } // namespace ChimeraTK
 
+#include <chrono>
 #include <map>
 #include <string>
 
 #include <boost/shared_ptr.hpp>
 
+#include "DirtyTrackingAccessor.h"
 #include "PVManager.h"
 #include "SynchronizationDirection.h"
 
@@ -38,7 +41,7 @@ namespace ChimeraTK {
      * Private constructor. Construction should be done through the
      * {@link createPVManager()} function.
      */
-    explicit DevicePVManager(boost::shared_ptr<PVManager> pvManager);
+    explicit DevicePVManager(boost::shared_ptr<PVManager> pvManager, ChimeraTK::RegisterPath prefix = "/");
 
     /**
      * Disable copy-construction.
@@ -103,6 +106,44 @@ namespace ChimeraTK {
         const std::string& unit = ChimeraTK::TransferElement::unitNotSet, const std::string& description = "",
         std::size_t numberOfBuffers = 3, const AccessModeFlags& flags = {AccessMode::wait_for_new_data});
 
+    /**
+     * Creates a new bidirectional process array based on a single shared value
+     * slot (see SharedSlotProcessArray), which is much cheaper than the one
+     * created by createProcessArray() with
+     * SynchronizationDirection::bidirectional. Values written on one side
+     * before the other side has read the previous one are merged, so it is
+     * intended for small setpoints.
+     */
+    template<class T>
+    typename ProcessArray<T>::SharedPtr createSharedSlotProcessArray(const ChimeraTK::RegisterPath& processVariableName,
+        std::size_t size, const std::string& unit = ChimeraTK::TransferElement::unitNotSet,
+        const std::string& description = "", T initialValue = T());
+
+    /**
+     * Creates a new device-to-control-system process array which can be
+     * written by several device threads without an extra aggregation thread.
+     * The returned process array is the sender for the calling thread, each
+     * further thread must obtain its own sender through
+     * createAdditionalProducer(). See createMultiProducerProcessArray() for the
+     * meaning of the ordering.
+     */
+    template<class T>
+    typename ProcessArray<T>::SharedPtr createMultiProducerProcessArray(
+        const ChimeraTK::RegisterPath& processVariableName, std::size_t size,
+        MultiProducerOrdering ordering = MultiProducerOrdering::lastWriterWins,
+        const std::string& unit = ChimeraTK::TransferElement::unitNotSet, const std::string& description = "",
+        T initialValue = T(), std::size_t numberOfBuffers = 3,
+        const AccessModeFlags& flags = {AccessMode::wait_for_new_data});
+
+    /**
+     * Returns a new sender for a process array created with
+     * createMultiProducerProcessArray(), to be used by one further producer
+     * thread. Throws a \c ChimeraTK::logic_error if the process array does not
+     * exist, has a different type or does not support multiple producers.
+     */
+    template<class T>
+    typename ProcessArray<T>::SharedPtr createAdditionalProducer(const ChimeraTK::RegisterPath& processVariableName);
+
     /**
      * Returns a reference to a process array that has been created earlier
      * using the
@@ -119,6 +160,19 @@ namespace ChimeraTK {
     template<class T>
     typename ProcessArray<T>::SharedPtr getProcessArray(const ChimeraTK::RegisterPath& processVariableName) const;
 
+    /**
+     * Like getProcessArray(const ChimeraTK::RegisterPath&), but takes the name
+     * as std::string, std::string_view or string literal. For the root
+     * manager, names which are already normalised (see
+     * PVManager::isNormalisedName()) are looked up without constructing a
+     * ChimeraTK::RegisterPath. Sub managers still need to prepend their prefix.
+     */
+    template<class T, typename NAME, typename = detail::EnableIfStringName<NAME>>
+    typename ProcessArray<T>::SharedPtr getProcessArray(const NAME& processVariableName) const {
+      return withFullName(processVariableName,
+          [&](std::string_view fullName) { return _pvManager->getProcessArray<T>(fullName).second; });
+    }
+
     /**
      * Returns a reference to a process scalar or array that has been created
      * earlier using the
@@ -147,25 +201,188 @@ namespace ChimeraTK {
     [[nodiscard]] ProcessVariable::SharedPtr getProcessVariable(
         const ChimeraTK::RegisterPath& processVariableName) const;
 
+    /**
+     * Like getProcessVariable(const ChimeraTK::RegisterPath&), but takes the
+     * name as string, see getProcessArray(const NAME&).
+     */
+    template<typename NAME, typename = detail::EnableIfStringName<NAME>>
+    [[nodiscard]] ProcessVariable::SharedPtr getProcessVariable(const NAME& processVariableName) const {
+      return withFullName(processVariableName,
+          [&](std::string_view fullName) { return _pvManager->getProcessVariable(fullName).second; });
+    }
+
     /**
      * Checks whether a process scalar or array with the specified name exists.
      */
     [[nodiscard]] bool hasProcessVariable(ChimeraTK::RegisterPath const& processVariableName) const {
-      return _pvManager->hasProcessVariable(processVariableName);
+      return _pvManager->hasProcessVariable(_prefix / processVariableName);
+    }
+
+    /**
+     * Like hasProcessVariable(ChimeraTK::RegisterPath const&), but takes the
+     * name as string, see getProcessArray(const NAME&).
+     */
+    template<typename NAME, typename = detail::EnableIfStringName<NAME>>
+    [[nodiscard]] bool hasProcessVariable(const NAME& processVariableName) const {
+      return withFullName(
+          processVariableName, [&](std::string_view fullName) { return _pvManager->hasProcessVariable(fullName); });
     }
 
     /**
      * Returns a vector containing all process variables that are registered
-     * with this PV manager.
+     * with this PV manager. For a sub manager (see getSubManager()), only the
+     * process variables below its prefix are returned.
      */
     [[nodiscard]] std::vector<ProcessVariable::SharedPtr> getAllProcessVariables() const;
 
+    /**
+     * Enable the self-monitoring statistics of the adapter layer. This creates a
+     * set of device-to-control-system process variables below the given prefix
+     * (see StatisticsPublisher for the list) and starts a thread which updates
+     * them in the given interval. The statistics are only collected while at
+     * least one PV manager has enabled them, so there is no overhead
+     * otherwise. The counters are process-wide, see StatisticsPublisher.
+     *
+     * Like the creation of any other process variable, this must be called
+     * before the control system starts using the ControlSystemPVManager.
+     * Calling this function a second time is an error and causes an
+     * \c ChimeraTK::logic_error exception to be thrown.
+     */
+    void enableStatistics(const ChimeraTK::RegisterPath& prefix = "/Adapter/Statistics",
+        std::chrono::milliseconds updateInterval = std::chrono::milliseconds(1000));
+
+    /**
+     * Returns a DevicePVManager for the same PV manager which places all process
+     * variables below the given prefix. All names passed to the returned manager
+     * are relative to the prefix. This allows to host several applications in
+     * one process, see MultiApplicationHost.
+     */
+    [[nodiscard]] boost::shared_ptr<DevicePVManager> getSubManager(const ChimeraTK::RegisterPath& prefix) const;
+
+    /**
+     * Returns the prefix of this manager, which is "/" unless the manager has
+     * been obtained through getSubManager().
+     */
+    [[nodiscard]] const ChimeraTK::RegisterPath& getPrefix() const { return _prefix; }
+
+    /**
+     * Returns an accessor for the device-to-control-system process array with
+     * the specified name which adds the process array to the dirty set of this
+     * manager whenever its buffer is modified through the accessor. Throws a
+     * \c ChimeraTK::logic_error if the process array does not exist, has a
+     * different type or is not writeable.
+     *
+     * Applications mirroring hardware state can use these accessors for all
+     * outputs and call publishDirty() once per cycle, which only writes the
+     * outputs which have actually changed.
+     */
+    template<class T>
+    DirtyTrackingAccessor<T> getDirtyTrackingAccessor(const ChimeraTK::RegisterPath& processVariableName);
+
+    /**
+     * Adds the writeable process variable with the specified name to the dirty
+     * set, e.g. after its buffer has been modified directly. Throws a
+     * \c ChimeraTK::logic_error if the process variable does not exist or is
+     * not writeable.
+     */
+    void markDirty(const ChimeraTK::RegisterPath& processVariableName);
+
+    /**
+     * Writes all process variables in the dirty set with one common version
+     * number and clears the dirty set. Returns the number of process variables
+     * written. The cost only depends on the number of dirty process variables
+     * (plus one bit per tracked process variable).
+     */
+    size_t publishDirty();
+
+    /**
+     * Writes the current values of all writeable process variables of this
+     * manager (below its prefix for a sub manager) with one common version
+     * number, then signals the control system side that the initial values
+     * are available (see ControlSystemPVManager::waitForInitialValues()).
+     * This is intended to be called once at the end of
+     * ApplicationBase::initialise(), instead of writing each process variable
+     * individually. Returns the number of process variables written.
+     *
+     * When several applications share one PV manager (see
+     * MultiApplicationHost), each of them publishes the process variables
+     * below its prefix. The signal is only given once the initial values of
+     * all process variables of the PV manager have been published.
+     */
+    size_t publishInitialValues();
+
+    /**
+     * Interrupts all threads blocked in a read of a device side process
+     * variable of this manager (below its prefix for a sub manager), see
+     * TransferElement::interrupt(). Returns the number of interrupted process
+     * variables.
+     */
+    size_t interruptAll();
+
+    /**
+     * Returns the executor for synchronisation functions of the PV manager.
+     * It is shared with the ControlSystemPVManager, so the control system
+     * adapter locks the same groups. Group and process variable names passed
+     * to the executor directly are absolute, i.e. the prefix of this manager
+     * is not prepended.
+     */
+    [[nodiscard]] SynchronisationExecutor& getSynchronisationExecutor() const {
+      return _pvManager->getSynchronisationExecutor();
+    }
+
+    /**
+     * Assigns the process variable with the specified name to the given
+     * synchronisation group. Both names are relative to the prefix of this
+     * manager.
+     */
+    void addToSynchronisationGroup(
+        const ChimeraTK::RegisterPath& group, const ChimeraTK::RegisterPath& processVariableName);
+
+    /**
+     * Executes the synchronisation function while holding the locks of the
+     * given groups (relative to the prefix of this manager), see
+     * SynchronisationExecutor. Functions locking other groups run
+     * concurrently. Pass SynchronisationExecutor::AccessMode::readOnly for
+     * functions which do not modify the process variables.
+     */
+    void executeSynchronisationFunction(const std::vector<ChimeraTK::RegisterPath>& groups,
+        const std::function<void()>& function,
+        SynchronisationExecutor::AccessMode mode = SynchronisationExecutor::AccessMode::readWrite);
+
    private:
+    /**
+     * Call the given function with the name including the prefix of this
+     * manager. The root manager passes the name on unchanged.
+     */
+    template<typename FUNCTION>
+    auto withFullName(std::string_view processVariableName, FUNCTION function) const {
+      if(_prefix == "/") {
+        return function(processVariableName);
+      }
+      return function(static_cast<std::string>(_prefix / ChimeraTK::RegisterPath(std::string(processVariableName))));
+    }
+
     /**
      * Reference to the {@link PVManager} backing this facade for the device
      * library.
      */
     boost::shared_ptr<PVManager> _pvManager;
+
+    /**
+     * Publisher of the adapter statistics, if enabled.
+     */
+    boost::shared_ptr<StatisticsPublisher> _statisticsPublisher;
+
+    /**
+     * Prefix prepended to all process variable names.
+     */
+    ChimeraTK::RegisterPath _prefix;
+
+    /**
+     * Dirty set for publishDirty(). Shared with the DirtyTrackingAccessor
+     * instances.
+     */
+    boost::shared_ptr<detail::DirtySet> _dirtySet;
   };
 
   template<class T>
@@ -176,18 +393,18 @@ namespace ChimeraTK {
     switch(synchronizationDirection) {
       case SynchronizationDirection::controlSystemToDevice:
         return _pvManager
-            ->createProcessArrayControlSystemToDevice<T>(
-                processVariableName, std::vector<T>(size, initialValue), unit, description, numberOfBuffers, flags)
+            ->createProcessArrayControlSystemToDevice<T>(_prefix / processVariableName,
+                std::vector<T>(size, initialValue), unit, description, numberOfBuffers, flags)
             .second;
       case SynchronizationDirection::deviceToControlSystem:
         return _pvManager
-            ->createProcessArrayDeviceToControlSystem<T>(
-                processVariableName, std::vector<T>(size, initialValue), unit, description, numberOfBuffers, flags)
+            ->createProcessArrayDeviceToControlSystem<T>(_prefix / processVariableName,
+                std::vector<T>(size, initialValue), unit, description, numberOfBuffers, flags)
             .second;
       case SynchronizationDirection::bidirectional:
         return _pvManager
-            ->createBidirectionalProcessArray<T>(
-                processVariableName, std::vector<T>(size, initialValue), unit, description, numberOfBuffers)
+            ->createBidirectionalProcessArray<T>(_prefix / processVariableName,
+                std::vector<T>(size, initialValue), unit, description, numberOfBuffers)
             .second;
     }
     std::cerr << "unrecoverable error: invalid syncrhonization direction in DevicePVManager::createProcessArray()"
@@ -204,25 +421,64 @@ namespace ChimeraTK {
       case SynchronizationDirection::controlSystemToDevice:
         return _pvManager
             ->createProcessArrayControlSystemToDevice<T>(
-                processVariableName, initialValue, unit, description, numberOfBuffers, {}, {}, flags)
+                _prefix / processVariableName, initialValue, unit, description, numberOfBuffers, {}, {}, flags)
             .second;
       case SynchronizationDirection::deviceToControlSystem:
         return _pvManager
             ->createProcessArrayDeviceToControlSystem<T>(
-                processVariableName, initialValue, unit, description, numberOfBuffers, {}, {}, flags)
+                _prefix / processVariableName, initialValue, unit, description, numberOfBuffers, {}, {}, flags)
             .second;
       case SynchronizationDirection::bidirectional:
         return _pvManager
-            ->createBidirectionalProcessArray<T>(processVariableName, initialValue, unit, description, numberOfBuffers)
+            ->createBidirectionalProcessArray<T>(
+                _prefix / processVariableName, initialValue, unit, description, numberOfBuffers)
             .second;
     }
     assert(false); // one of the switch cases should have returned
   }
 
+  template<class T>
+  typename ProcessArray<T>::SharedPtr DevicePVManager::createSharedSlotProcessArray(
+      const ChimeraTK::RegisterPath& processVariableName, std::size_t size, const std::string& unit,
+      const std::string& description, T initialValue) {
+    return _pvManager
+        ->createSharedSlotBidirectionalProcessArray<T>(
+            _prefix / processVariableName, std::vector<T>(size, initialValue), unit, description)
+        .second;
+  }
+
+  template<class T>
+  typename ProcessArray<T>::SharedPtr DevicePVManager::createMultiProducerProcessArray(
+      const ChimeraTK::RegisterPath& processVariableName, std::size_t size, MultiProducerOrdering ordering,
+      const std::string& unit, const std::string& description, T initialValue, std::size_t numberOfBuffers,
+      const AccessModeFlags& flags) {
+    return _pvManager
+        ->createMultiProducerProcessArrayDeviceToControlSystem<T>(_prefix / processVariableName,
+            std::vector<T>(size, initialValue), unit, description, ordering, numberOfBuffers, flags)
+        .second;
+  }
+
+  template<class T>
+  typename ProcessArray<T>::SharedPtr DevicePVManager::createAdditionalProducer(
+      const ChimeraTK::RegisterPath& processVariableName) {
+    auto sender = boost::dynamic_pointer_cast<UnidirectionalProcessArray<T>>(getProcessArray<T>(processVariableName));
+    if(!sender) {
+      throw ChimeraTK::logic_error(
+          "Process variable " + std::string(_prefix / processVariableName) + " does not support multiple producers.");
+    }
+    return sender->createAdditionalSender();
+  }
+
   template<class T>
   typename ProcessArray<T>::SharedPtr DevicePVManager::getProcessArray(
       const ChimeraTK::RegisterPath& processVariableName) const {
-    return _pvManager->getProcessArray<T>(processVariableName).second;
+    return _pvManager->getProcessArray<T>(_prefix / processVariableName).second;
+  }
+
+  template<class T>
+  DirtyTrackingAccessor<T> DevicePVManager::getDirtyTrackingAccessor(
+      const ChimeraTK::RegisterPath& processVariableName) {
+    return DirtyTrackingAccessor<T>(getProcessArray<T>(processVariableName), _dirtySet);
   }
 
 } // namespace ChimeraTK
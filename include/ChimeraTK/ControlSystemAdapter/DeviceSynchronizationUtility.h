@@ -0,0 +1,108 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include "DevicePVManager.h"
+#include "DirtyTrackingAccessor.h"
+#include "ProcessVariable.h"
+
+#include <ChimeraTK/ReadAnyGroup.h>
+
+#include <functional>
+#include <map>
+#include <vector>
+
+namespace ChimeraTK {
+
+  /**
+   * Event-driven synchronisation of all process variables of a DevicePVManager, for simple device cores which do not
+   * want to deal with the individual process variables.
+   *
+   * receiveAll() blocks until at least one control-system-to-device process variable has received a new value and then
+   * receives all process variables which have changed, without touching the others. Callbacks can be registered per
+   * process variable and are called after the new value has been received.
+   *
+   * sendAll() sends only those device-to-control-system process variables which have been marked as modified with
+   * markModified() since the last call. The bookkeeping is the same as for DevicePVManager::markDirty().
+   *
+   * The set of process variables is determined when the utility is constructed, so all process variables must have been
+   * created before. Like the process variables themselves, the utility must only be used by a single device thread,
+   * except for interrupt().
+   */
+  class DeviceSynchronizationUtility {
+   public:
+    /** Callback type for the receive notifications. The argument is the process variable which has been received. */
+    using ReceiveCallback = std::function<void(const ProcessVariable::SharedPtr&)>;
+
+    explicit DeviceSynchronizationUtility(const DevicePVManager::SharedPtr& pvManager);
+
+    /** Register a callback which is called by receiveAll() each time the process variable with the given name has
+     *  received a new value. Replaces a previously registered callback for the same variable. Throws a
+     *  ChimeraTK::logic_error if there is no readable process variable with the given name. */
+    void addReceiveNotificationListener(const ChimeraTK::RegisterPath& processVariableName, ReceiveCallback callback);
+
+    /** Remove the callback for the process variable with the given name, if any. */
+    void removeReceiveNotificationListener(const ChimeraTK::RegisterPath& processVariableName);
+
+    /** Block until at least one process variable has a new value, then receive all process variables with new values.
+     *  Returns the received process variables. A variable which has received more than one value is only listed once,
+     *  but its callback is called for each value. Process variables without AccessMode::wait_for_new_data cannot notify
+     *  about new values, so they are polled with readLatest() each time. For them, readLatest() only waits until the
+     *  initial value has arrived and returns immediately afterwards, so they are listed in each result.
+     *
+     *  Blocking requires at least one readable process variable with AccessMode::wait_for_new_data, otherwise a loop
+     *  calling receiveAll() would spin. Throws a ChimeraTK::logic_error if there is none, use receiveAllNonBlocking()
+     *  in that case. Throws boost::thread_interrupted if interrupt() is called while waiting. */
+    std::vector<ProcessVariable::SharedPtr> receiveAll();
+
+    /** Like receiveAll(), but returns an empty list instead of blocking if no process variable has a new value. */
+    std::vector<ProcessVariable::SharedPtr> receiveAllNonBlocking();
+
+    /** Mark the process variable with the given name as modified, so it is sent by the next call to sendAll(). Throws a
+     *  ChimeraTK::logic_error if there is no writeable process variable with the given name. */
+    void markModified(const ChimeraTK::RegisterPath& processVariableName);
+
+    /** Mark the given process variable as modified, so it is sent by the next call to sendAll(). */
+    void markModified(const ProcessVariable::SharedPtr& processVariable);
+
+    /** Send all process variables which have been marked as modified since the last call, using the same version
+     *  number for all of them. The variables are sent in the order of the PV manager. Returns the number of variables
+     *  sent. */
+    size_t sendAll();
+
+    /** Interrupt a blocking receiveAll(). May be called from any thread. */
+    void interrupt();
+
+   private:
+    /** Receive all pending values after the first one (with the given ID) has already been read. */
+    std::vector<ProcessVariable::SharedPtr> receivePending(TransferElementID id);
+
+    /** Prefix of the PV manager, names passed to the utility are relative to it */
+    ChimeraTK::RegisterPath _prefix;
+
+    /** Readable process variables, in the order of the PV manager */
+    std::vector<ProcessVariable::SharedPtr> _receivers;
+
+    /** Callbacks per receiver, same index as _receivers */
+    std::vector<ReceiveCallback> _callbacks;
+
+    /** Index of the receivers by ID, used to map the result of the ReadAnyGroup */
+    std::map<TransferElementID, size_t> _receiverIndices;
+
+    /** Readable process variables without wait_for_new_data */
+    std::vector<size_t> _pollReceivers;
+
+    /** Group of all readable process variables with wait_for_new_data */
+    ReadAnyGroup _readAnyGroup;
+
+    /** Whether _readAnyGroup contains any elements */
+    bool _hasPushReceivers{false};
+
+    /** Writeable process variables with their modified flags, in the order of the PV manager */
+    detail::DirtySet _senders;
+
+    /** Index of the senders in _senders by name */
+    std::map<std::string, size_t> _senderIndices;
+  };
+
+} // namespace ChimeraTK
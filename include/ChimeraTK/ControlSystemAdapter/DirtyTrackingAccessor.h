@@ -0,0 +1,123 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include "ProcessArray.h"
+#include "ProcessVariable.h"
+
+#include <boost/shared_ptr.hpp>
+
+#include <cassert>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+namespace ChimeraTK {
+
+  namespace detail {
+
+    /**
+     * Set of sending process variables with one dirty bit each. The members are numbered in the order they are added,
+     * and the dirty bits are kept in a bitmap with one bit per member, so marking is a single OR and publishing only
+     * needs to visit the set bits.
+     *
+     * Not thread safe, must only be used by the device thread owning the DevicePVManager.
+     */
+    class DirtySet {
+     public:
+      /** Add the given process variable to the set and return its index. If it is already a member, its existing index
+       *  is returned. */
+      size_t add(const ProcessVariable::SharedPtr& processVariable);
+
+      /** Mark the member with the given index as dirty. */
+      void mark(size_t index) { _bits[index >> 6] |= uint64_t(1) << (index & 63); }
+
+      /** Mark the given process variable as dirty. Throws a ChimeraTK::logic_error if it is not a member. */
+      void mark(const ProcessVariable::SharedPtr& processVariable);
+
+      /** Write all dirty members with one common version number and clear their dirty bits. Returns the number of
+       *  process variables written. */
+      size_t publish();
+
+     private:
+      /** Members of the set, index as returned by add() */
+      std::vector<ProcessVariable::SharedPtr> _members;
+
+      /** Index of the members by their address */
+      std::map<const ProcessVariable*, size_t> _indices;
+
+      /** One bit per member */
+      std::vector<uint64_t> _bits;
+    };
+
+  } // namespace detail
+
+  /*********************************************************************************************************************/
+
+  /**
+   * Accessor for the buffer of a sending process array which marks the process array as dirty in the dirty set of its
+   * DevicePVManager whenever the buffer is modified through it. All dirty process arrays are written at once by
+   * DevicePVManager::publishDirty().
+   *
+   * Read-only access through get() and readData() does not mark the process array. set() only marks it if the new
+   * value differs from the current content of the buffer, which is what applications mirroring hardware state need.
+   *
+   * Obtain instances through DevicePVManager::getDirtyTrackingAccessor().
+   */
+  template<class T>
+  class DirtyTrackingAccessor {
+   public:
+    DirtyTrackingAccessor(typename ProcessArray<T>::SharedPtr processArray, boost::shared_ptr<detail::DirtySet> dirtySet)
+    : _processArray(std::move(processArray)), _dirtySet(std::move(dirtySet)), _index(_dirtySet->add(_processArray)) {}
+
+    /** Modifiable access to a single element, marks the process array as dirty. */
+    T& accessData(size_t sample) {
+      markDirty();
+      return _processArray->accessData(sample);
+    }
+
+    /** Modifiable access to the whole buffer, marks the process array as dirty. */
+    std::vector<T>& accessVector() {
+      markDirty();
+      return _processArray->accessChannel(0);
+    }
+
+    /** Read-only access to a single element. */
+    const T& readData(size_t sample) const { return _processArray->accessData(sample); }
+
+    /** Read-only access to the whole buffer. */
+    const std::vector<T>& get() const { return _processArray->accessChannel(0); }
+
+    /** Set a single element, marks the process array as dirty only if the value has changed. */
+    void set(size_t sample, const T& value) {
+      auto& element = _processArray->accessData(sample);
+      if(element != value) {
+        element = value;
+        markDirty();
+      }
+    }
+
+    /** Set the whole buffer, marks the process array as dirty only if the value has changed. The size of the vector
+     *  must match the size of the process array. */
+    void set(const std::vector<T>& value) {
+      auto& buffer = _processArray->accessChannel(0);
+      assert(value.size() == buffer.size());
+      if(buffer != value) {
+        buffer = value;
+        markDirty();
+      }
+    }
+
+    /** Mark the process array as dirty without modifying it. */
+    void markDirty() { _dirtySet->mark(_index); }
+
+    /** Return the underlying process array. Modifications made directly to it are not tracked. */
+    const typename ProcessArray<T>::SharedPtr& getProcessArray() const { return _processArray; }
+
+   private:
+    typename ProcessArray<T>::SharedPtr _processArray;
+    boost::shared_ptr<detail::DirtySet> _dirtySet;
+    size_t _index;
+  };
+
+} // namespace ChimeraTK
@@ -0,0 +1,197 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include <ChimeraTK/TransferElement.h>
+#include <ChimeraTK/VersionNumber.h>
+
+#include <boost/shared_ptr.hpp>
+
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace ChimeraTK {
+
+  /**
+   * Snapshot of the latest value of a process variable, see LatestValueView.
+   */
+  template<class T>
+  struct LatestValue {
+    /** The value */
+    std::vector<T> value;
+
+    /** Time stamp of the version number of the value */
+    std::chrono::system_clock::time_point timeStamp;
+
+    /** Data validity of the value */
+    DataValidity dataValidity{DataValidity::ok};
+
+    /** Number of values published so far, including the value present when the view was created */
+    uint64_t updateCount{0};
+  };
+
+  namespace detail {
+
+    /**
+     * Storage of the latest value of a process variable. There is a single writer (the thread reading the process
+     * variable) and any number of concurrent readers.
+     *
+     * Trivially copyable types are stored in a seqlock: the elements are atomics, written with relaxed stores between
+     * two increments of a sequence number. Readers copy the elements and retry if the sequence number was odd or has
+     * changed meanwhile. Neither side allocates or takes a lock.
+     */
+    template<class T, bool = std::is_trivially_copyable_v<T>>
+    class LatestValueSlot {
+     public:
+      LatestValueSlot(const std::vector<T>& value, const VersionNumber& version, DataValidity validity)
+      : _size(value.size()), _value(new std::atomic<T>[value.size()]) {
+        publish(value, version, validity);
+      }
+
+      /** Store a new value. Must only be called by a single thread. */
+      void publish(const std::vector<T>& value, const VersionNumber& version, DataValidity validity) {
+        assert(value.size() == _size);
+        auto sequence = _sequence.load(std::memory_order_relaxed);
+        _sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for(size_t i = 0; i < _size; ++i) {
+          _value[i].store(value[i], std::memory_order_relaxed);
+        }
+        _timeStamp.store(version.getTime().time_since_epoch().count(), std::memory_order_relaxed);
+        _dataValidity.store(validity, std::memory_order_relaxed);
+        _sequence.store(sequence + 2, std::memory_order_release);
+      }
+
+      /** Copy the latest value. May be called by any number of threads concurrently. */
+      void read(LatestValue<T>& snapshot) const {
+        snapshot.value.resize(_size);
+        while(true) {
+          auto sequence = _sequence.load(std::memory_order_acquire);
+          if(sequence & 1) {
+            std::this_thread::yield(); // the writer is in the middle of an update
+            continue;
+          }
+          for(size_t i = 0; i < _size; ++i) {
+            snapshot.value[i] = _value[i].load(std::memory_order_relaxed);
+          }
+          auto timeStamp = _timeStamp.load(std::memory_order_relaxed);
+          auto validity = _dataValidity.load(std::memory_order_relaxed);
+          std::atomic_thread_fence(std::memory_order_acquire);
+          if(_sequence.load(std::memory_order_relaxed) == sequence) {
+            snapshot.timeStamp =
+                std::chrono::system_clock::time_point(std::chrono::system_clock::duration(timeStamp));
+            snapshot.dataValidity = validity;
+            snapshot.updateCount = sequence / 2;
+            return;
+          }
+        }
+      }
+
+      [[nodiscard]] uint64_t getUpdateCount() const { return _sequence.load(std::memory_order_acquire) / 2; }
+
+      [[nodiscard]] size_t getNumberOfSamples() const { return _size; }
+
+     private:
+      /** Sequence number, odd while an update is in progress */
+      std::atomic<uint64_t> _sequence{0};
+
+      size_t _size;
+      std::unique_ptr<std::atomic<T>[]> _value;
+      std::atomic<std::chrono::system_clock::duration::rep> _timeStamp{0};
+      std::atomic<DataValidity> _dataValidity{DataValidity::ok};
+    };
+
+    /**
+     * Storage of the latest value for types which are not trivially copyable (strings). Each update publishes a new
+     * immutable snapshot through an atomic shared pointer (read-copy-update). Readers copy the value out of the
+     * snapshot they have obtained, which stays valid while they hold it.
+     */
+    template<class T>
+    class LatestValueSlot<T, false> {
+     public:
+      LatestValueSlot(const std::vector<T>& value, const VersionNumber& version, DataValidity validity) {
+        publish(value, version, validity);
+      }
+
+      /** Store a new value. Must only be called by a single thread. */
+      void publish(const std::vector<T>& value, const VersionNumber& version, DataValidity validity) {
+        auto snapshot = std::make_shared<LatestValue<T>>();
+        snapshot->value = value;
+        snapshot->timeStamp = version.getTime();
+        snapshot->dataValidity = validity;
+        snapshot->updateCount = ++_updateCount;
+        std::atomic_store_explicit(
+            &_snapshot, std::shared_ptr<const LatestValue<T>>(std::move(snapshot)), std::memory_order_release);
+      }
+
+      /** Copy the latest value. May be called by any number of threads concurrently. */
+      void read(LatestValue<T>& snapshot) const {
+        snapshot = *std::atomic_load_explicit(&_snapshot, std::memory_order_acquire);
+      }
+
+      [[nodiscard]] uint64_t getUpdateCount() const {
+        return std::atomic_load_explicit(&_snapshot, std::memory_order_acquire)->updateCount;
+      }
+
+      [[nodiscard]] size_t getNumberOfSamples() const {
+        return std::atomic_load_explicit(&_snapshot, std::memory_order_acquire)->value.size();
+      }
+
+     private:
+      std::shared_ptr<const LatestValue<T>> _snapshot;
+
+      /** Only used by the writer */
+      uint64_t _updateCount{0};
+    };
+
+  } // namespace detail
+
+  /*********************************************************************************************************************/
+
+  /**
+   * Thread-safe view of the latest value of a process variable, obtained through ProcessArray::getLatestValueView().
+   * The view is updated by each read of the process array which receives new data, so control system adapters serving
+   * many client threads do not need their own locked value cache: one thread reads the process variable as usual, any
+   * number of client threads get the current value from the view concurrently.
+   *
+   * Views are cheap to copy and can be passed to other threads. A view stays usable after the process array has been
+   * destroyed, it then keeps the last value.
+   */
+  template<class T>
+  class LatestValueView {
+   public:
+    /** Create an empty view, which must not be used except for assigning another view. */
+    LatestValueView() = default;
+
+    explicit LatestValueView(boost::shared_ptr<detail::LatestValueSlot<T>> slot) : _slot(std::move(slot)) {}
+
+    /** Copy the latest value into the given snapshot. The vector of the snapshot is reused, so repeated calls with the
+     *  same snapshot do not allocate (except for strings). */
+    void get(LatestValue<T>& snapshot) const { _slot->read(snapshot); }
+
+    /** Return a copy of the latest value. */
+    [[nodiscard]] LatestValue<T> get() const {
+      LatestValue<T> snapshot;
+      _slot->read(snapshot);
+      return snapshot;
+    }
+
+    /** Return the number of values published so far. Can be used to check cheaply for new values. */
+    [[nodiscard]] uint64_t getUpdateCount() const { return _slot->getUpdateCount(); }
+
+    [[nodiscard]] size_t getNumberOfSamples() const { return _slot->getNumberOfSamples(); }
+
+    /** Check whether the view has been obtained from a process array. */
+    explicit operator bool() const { return static_cast<bool>(_slot); }
+
+   private:
+    boost::shared_ptr<detail::LatestValueSlot<T>> _slot;
+  };
+
+} // namespace ChimeraTK
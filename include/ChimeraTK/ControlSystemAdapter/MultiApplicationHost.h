@@ -0,0 +1,150 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include "ApplicationBase.h"
+#include "ControlSystemPVManager.h"
+#include "DevicePVManager.h"
+
+#include <ChimeraTK/Exception.h>
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace ChimeraTK {
+
+  /**
+   * Host for several independent applications in one process. Each application gets its own DevicePVManager (a sub
+   * manager placing all its process variables below a name prefix), its own persistency file and its own threads. All
+   * applications share one ControlSystemPVManager, so a single control system adapter exports all of them.
+   *
+   * The hosted applications do not set the global instance pointer of ApplicationBase. ApplicationBase::getInstance()
+   * returns the right application only while the host is calling its initialise(), optimiseUnmappedVariables() or
+   * run(). Applications which call getInstance() in their constructor or from their own threads cannot be hosted.
+   *
+   * Usage by the control system adapter:
+   *
+   *   MultiApplicationHost host;
+   *   host.addApplication<MyApplication>("/app1", "app1");
+   *   host.addApplication<MyApplication>("/app2", "app2");
+   *   host.initialise();
+   *   host.enablePersistentDataStorage();
+   *   // ... map host.getControlSystemPVManager()->getAllProcessVariables() to the control system ...
+   *   host.run();
+   */
+  class MultiApplicationHost {
+   public:
+    /** Create the host with a new PV manager. */
+    MultiApplicationHost();
+
+    /** Destroys the applications in the reverse order of their creation. */
+    ~MultiApplicationHost();
+
+    MultiApplicationHost(const MultiApplicationHost&) = delete;
+    MultiApplicationHost& operator=(const MultiApplicationHost&) = delete;
+
+    /** Create an application of the given type with the given constructor arguments. All process variables of the
+     *  application will be placed below the given prefix. Prefixes and application names must be unique, otherwise a
+     *  ChimeraTK::logic_error is thrown. */
+    template<typename APPLICATION_TYPE, typename... APPLICATION_ARGS>
+    APPLICATION_TYPE& addApplication(const ChimeraTK::RegisterPath& prefix, APPLICATION_ARGS&&... args);
+
+    /** Call initialise() of all applications, in the order they have been added. Each call is profiled as startup
+     *  phase, see ApplicationBase::initialiseProfiled(). */
+    void initialise();
+
+    /** Enable a separate persistent data storage for each application. The files are named after the application
+     *  names and contain the variable names without the prefix, so they are compatible with standalone operation. */
+    void enablePersistentDataStorage(unsigned int writeInterval = PersistentDataStorage::DEFAULT_WRITE_INTERVAL);
+
+    /** Call optimiseUnmappedVariables() of all applications. The names are the full names including the prefixes, each
+     *  application only receives the names below its prefix (with the prefix removed). */
+    void optimiseUnmappedVariables(const std::set<std::string>& unmappedVariables);
+
+    /** Call run() of all applications, in the order they have been added. */
+    void run();
+
+    /** Obtain the control system side PV manager shared by all applications. */
+    boost::shared_ptr<ControlSystemPVManager> getControlSystemPVManager() { return _csManager; }
+
+    /** Number of hosted applications */
+    [[nodiscard]] size_t getNumberOfApplications() const { return _applications.size(); }
+
+    /** Obtain the application with the given index (in the order they have been added). */
+    ApplicationBase& getApplication(size_t index) { return *_applications.at(index).application; }
+
+    /** Obtain the prefix of the application with the given index. */
+    [[nodiscard]] const ChimeraTK::RegisterPath& getPrefix(size_t index) const {
+      return _applications.at(index).prefix;
+    }
+
+   private:
+    struct HostedApplication {
+      ChimeraTK::RegisterPath prefix;
+      std::unique_ptr<ApplicationBase> application;
+    };
+
+    /** Check uniqueness of the prefix and the application name (if not empty). Throws a logic_error on violation. */
+    void checkUnique(const ChimeraTK::RegisterPath& prefix, const std::string& applicationName) const;
+
+    /** Call the given function for each application, with ApplicationBase::getInstance() returning the application. */
+    template<typename FUNCTION>
+    void forEachApplication(FUNCTION function);
+
+    boost::shared_ptr<ControlSystemPVManager> _csManager;
+    boost::shared_ptr<DevicePVManager> _devManager;
+    std::vector<HostedApplication> _applications;
+
+    /** RAII helper setting the thread-local hosted instance of ApplicationBase */
+    class HostedInstanceScope {
+     public:
+      explicit HostedInstanceScope(ApplicationBase* application) : _previous(ApplicationBase::_hostedInstance) {
+        ApplicationBase::_hostedInstance = application;
+      }
+      ~HostedInstanceScope() { ApplicationBase::_hostedInstance = _previous; }
+      HostedInstanceScope(const HostedInstanceScope&) = delete;
+      HostedInstanceScope& operator=(const HostedInstanceScope&) = delete;
+
+     private:
+      ApplicationBase* _previous;
+    };
+  };
+
+  /*********************************************************************************************************************/
+
+  template<typename APPLICATION_TYPE, typename... APPLICATION_ARGS>
+  APPLICATION_TYPE& MultiApplicationHost::addApplication(
+      const ChimeraTK::RegisterPath& prefix, APPLICATION_ARGS&&... args) {
+    checkUnique(prefix, {});
+    std::unique_ptr<APPLICATION_TYPE> application;
+    {
+      std::lock_guard<std::recursive_mutex> lock(ApplicationBase::instanceMutex);
+      ApplicationBase::_hostIsCreating = true;
+      try {
+        application = std::make_unique<APPLICATION_TYPE>(std::forward<APPLICATION_ARGS>(args)...);
+      }
+      catch(...) {
+        ApplicationBase::_hostIsCreating = false;
+        throw;
+      }
+      ApplicationBase::_hostIsCreating = false;
+    }
+    auto& applicationRef = *application;
+    checkUnique(prefix, application->getName());
+    application->setPVManager(_devManager->getSubManager(prefix));
+    _applications.push_back({prefix, std::move(application)});
+    return applicationRef;
+  }
+
+  /*********************************************************************************************************************/
+
+  template<typename FUNCTION>
+  void MultiApplicationHost::forEachApplication(FUNCTION function) {
+    for(auto& hosted : _applications) {
+      HostedInstanceScope scope(hosted.application.get());
+      function(hosted);
+    }
+  }
+
+} // namespace ChimeraTK
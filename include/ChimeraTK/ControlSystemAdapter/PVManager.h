@@ -1,7 +1,13 @@
 #ifndef CHIMERA_TK_CONTROL_SYSTEM_ADAPTER_PV_MANAGER_H
 #define CHIMERA_TK_CONTROL_SYSTEM_ADAPTER_PV_MANAGER_H
 
+#include <chrono>
+#include <condition_variable>
 #include <list>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <type_traits>
 #include <utility>
 
 #include <boost/lockfree/queue.hpp>
@@ -15,9 +21,23 @@
 #include "PVManagerDecl.h"
 #include "UnidirectionalProcessArray.h"
 #include "ProcessVariable.h"
+#include "PublishCounterTable.h"
+#include "SharedSlotProcessArray.h"
+#include "StartupProfiler.h"
+#include "SynchronisationExecutor.h"
 
 namespace ChimeraTK {
 
+  namespace detail {
+    /**
+     * Enables the lookup overloads taking the name as string for all types convertible to std::string_view. Plain
+     * overloads for std::string_view would be ambiguous with those taking a ChimeraTK::RegisterPath when called with a
+     * std::string or a string literal.
+     */
+    template<typename NAME>
+    using EnableIfStringName = std::enable_if_t<std::is_convertible_v<const NAME&, std::string_view>>;
+  } // namespace detail
+
   // These declarations should actually be in the respective header files,
   // however this would cause problems with incomplete definitions due to
   // circular dependencies.
@@ -91,6 +111,16 @@ namespace ChimeraTK {
         const std::string& unit = ChimeraTK::TransferElement::unitNotSet, const std::string& description = "",
         std::size_t numberOfBuffers = 2);
 
+    /**
+     * Like createBidirectionalProcessArray(), but uses the single-slot
+     * implementation SharedSlotProcessArray instead of BidirectionalProcessArray.
+     */
+    template<class T>
+    std::pair<typename ProcessArray<T>::SharedPtr, typename ProcessArray<T>::SharedPtr>
+        createSharedSlotBidirectionalProcessArray(ChimeraTK::RegisterPath const& processVariableName,
+            const std::vector<T>& initialValue, const std::string& unit = ChimeraTK::TransferElement::unitNotSet,
+            const std::string& description = "");
+
     /**
      * Creates a new process array for transferring data from the device library
      * to the control system and registers it with the PV manager.
@@ -119,6 +149,17 @@ namespace ChimeraTK {
             const std::string& description = "", std::size_t numberOfBuffers = 3,
             const AccessModeFlags& flags = {AccessMode::wait_for_new_data});
 
+    /**
+     * Like createProcessArrayDeviceToControlSystem(), but the device side can
+     * be written by several threads. See createMultiProducerProcessArray() for
+     * details.
+     */
+    template<class T>
+    std::pair<typename ProcessArray<T>::SharedPtr, typename ProcessArray<T>::SharedPtr>
+        createMultiProducerProcessArrayDeviceToControlSystem(ChimeraTK::RegisterPath const& processVariableName,
+            const std::vector<T>& initialValue, const std::string& unit, const std::string& description,
+            MultiProducerOrdering ordering, std::size_t numberOfBuffers, const AccessModeFlags& flags);
+
     /**
      * Creates a new process array for transferring data from the control system
      * to the device library and registers it with the PV manager.
@@ -160,11 +201,26 @@ namespace ChimeraTK {
     std::pair<typename ProcessArray<T>::SharedPtr, typename ProcessArray<T>::SharedPtr> getProcessArray(
         ChimeraTK::RegisterPath const& processVariableName) const;
 
+    /**
+     * Like getProcessArray(ChimeraTK::RegisterPath const&), but takes the name
+     * as string. Names which are already normalised (see isNormalisedName())
+     * are looked up without constructing a ChimeraTK::RegisterPath.
+     */
+    template<class T>
+    std::pair<typename ProcessArray<T>::SharedPtr, typename ProcessArray<T>::SharedPtr> getProcessArray(
+        std::string_view processVariableName) const;
+
     /**
      * Checks whether a process scalar or array with the specified name exists.
      */
     bool hasProcessVariable(ChimeraTK::RegisterPath const& processVariableName) const;
 
+    /**
+     * Like hasProcessVariable(ChimeraTK::RegisterPath const&), but takes the
+     * name as string, see getProcessArray(std::string_view).
+     */
+    bool hasProcessVariable(std::string_view processVariableName) const;
+
     /**
      * Returns a reference to a process scalar or array that has been created
      * earlier using one of the <code>createProcessScalar...</code> or
@@ -179,9 +235,25 @@ namespace ChimeraTK {
     std::pair<ProcessVariable::SharedPtr, ProcessVariable::SharedPtr> getProcessVariable(
         ChimeraTK::RegisterPath const& processVariableName) const;
 
+    /**
+     * Like getProcessVariable(ChimeraTK::RegisterPath const&), but takes the
+     * name as string, see getProcessArray(std::string_view).
+     */
+    std::pair<ProcessVariable::SharedPtr, ProcessVariable::SharedPtr> getProcessVariable(
+        std::string_view processVariableName) const;
+
+    /**
+     * Checks whether the name is in the normalised form used as key of the
+     * process variable map: it starts with a slash, does not end with a slash
+     * and does not contain empty path components.
+     */
+    static bool isNormalisedName(std::string_view name);
+
     /**
      * Returns the map containing all process variables, using the names as
-     * keys and the respective process variables as values.
+     * keys and the respective process variables as values. The returned
+     * reference must not be used while other threads are still creating
+     * process variables.
      * Each value in the map is a pair which has a reference to the process
      * variable instance intended for the control system as its first and a
      * reference to the instance intended for the device library as its second
@@ -189,11 +261,91 @@ namespace ChimeraTK {
      */
     const ProcessVariableMap& getAllProcessVariables() const;
 
+    /**
+     * Returns the executor for synchronisation functions, which is shared by
+     * the control system and the device side.
+     */
+    SynchronisationExecutor& getSynchronisationExecutor() { return _synchronisationExecutor; }
+
+    /**
+     * Returns the table with the publish counters of all process variables.
+     */
+    const PublishCounterTable& getPublishCounterTable() const { return _publishCounterTable; }
+
+    /**
+     * Interrupt all blocked readers of the process variables with
+     * AccessMode::wait_for_new_data on the selected sides, see
+     * TransferElement::interrupt(). Returns the number of interrupted process
+     * variables.
+     */
+    size_t interruptAll(bool controlSystemSide, bool deviceSide);
+
+    /**
+     * Signal that the device side has published the initial values of all
+     * process variables below the given prefix, see
+     * DevicePVManager::publishInitialValues(). The waiting threads are only
+     * released once every process variable is below one of the published
+     * prefixes, so sub managers publishing their part alone do not give the
+     * signal.
+     */
+    void setInitialValuesPublished(const ChimeraTK::RegisterPath& prefix);
+
+    /**
+     * Wait until the initial values of all process variables have been
+     * published (see setInitialValuesPublished()), at most for the given
+     * time (steady_clock::duration::max() waits without limit). Returns
+     * whether the initial values have been published.
+     */
+    bool waitForInitialValues(std::chrono::steady_clock::duration timeout);
+
    private:
+    /**
+     * Find the process variable with the given name, normalising the name
+     * only if needed. The caller must hold _processVariablesMutex.
+     */
+    ProcessVariableMap::const_iterator findProcessVariable(std::string_view processVariableName) const;
+
     /**
      * Map storing the process variables.
      */
     ProcessVariableMap _processVariables;
+
+    /**
+     * Index of _processVariables by the normalised name as string. The
+     * comparator is transparent, so names can be looked up as std::string_view
+     * without constructing a ChimeraTK::RegisterPath. Protected by
+     * _processVariablesMutex like the map itself.
+     */
+    std::map<std::string, ProcessVariableMap::const_iterator, std::less<>> _processVariablesByName;
+
+    /**
+     * Mutex protecting the map, so process variables can be created
+     * concurrently (e.g. by ApplicationBase::initialiseModules()).
+     */
+    mutable std::mutex _processVariablesMutex;
+
+    /**
+     * Executor for synchronisation functions, see getSynchronisationExecutor().
+     */
+    SynchronisationExecutor _synchronisationExecutor;
+
+    /**
+     * Publish counters of all process variables, see getPublishCounterTable().
+     */
+    PublishCounterTable _publishCounterTable;
+
+    /**
+     * Readiness signal for the initial values, see setInitialValuesPublished().
+     */
+    std::mutex _initialValuesMutex;
+    std::condition_variable _initialValuesCondition;
+    bool _initialValuesPublished{false};
+
+    /**
+     * Prefixes published so far, each followed by a slash (except for the
+     * root "/").
+     */
+    std::vector<std::string> _initialValuesPublishedPrefixes;
   };
 
   /**
@@ -210,16 +362,40 @@ namespace ChimeraTK {
       createBidirectionalProcessArray(ChimeraTK::RegisterPath const& processVariableName,
           const std::vector<T>& initialValue, const std::string& unit, const std::string& description,
           std::size_t numberOfBuffers) {
-    if(_processVariables.find(processVariableName) != _processVariables.end()) {
+    StartupPhase phase("PVManager::createProcessArray");
+    // The process variables are created outside the lock, so several threads can create variables in parallel.
+    typename std::pair<typename ProcessArray<T>::SharedPtr, typename ProcessArray<T>::SharedPtr> processVariables =
+        createBidirectionalSynchronizedProcessArray<T>(
+            initialValue, processVariableName, unit, description, numberOfBuffers);
+
+    std::lock_guard<std::mutex> lock(_processVariablesMutex);
+    auto inserted = _processVariables.insert(
+        std::make_pair(processVariableName, std::make_pair(processVariables.first, processVariables.second)));
+    if(!inserted.second) {
       throw ChimeraTK::logic_error("Process variable with name " + processVariableName + " already exists.");
     }
+    _processVariablesByName.emplace(std::string(processVariableName), inserted.first);
+    processVariables.second->setPublishCounter(&_publishCounterTable.add(processVariables.first));
 
+    return std::make_pair(processVariables.first, processVariables.second);
+  }
+
+  template<class T>
+  std::pair<typename ProcessArray<T>::SharedPtr, typename ProcessArray<T>::SharedPtr> PVManager::
+      createSharedSlotBidirectionalProcessArray(ChimeraTK::RegisterPath const& processVariableName,
+          const std::vector<T>& initialValue, const std::string& unit, const std::string& description) {
+    StartupPhase phase("PVManager::createProcessArray");
     typename std::pair<typename ProcessArray<T>::SharedPtr, typename ProcessArray<T>::SharedPtr> processVariables =
-        createBidirectionalSynchronizedProcessArray<T>(
-            initialValue, processVariableName, unit, description, numberOfBuffers);
+        createSharedSlotProcessArray<T>(initialValue, processVariableName, unit, description);
 
-    _processVariables.insert(
+    std::lock_guard<std::mutex> lock(_processVariablesMutex);
+    auto inserted = _processVariables.insert(
         std::make_pair(processVariableName, std::make_pair(processVariables.first, processVariables.second)));
+    if(!inserted.second) {
+      throw ChimeraTK::logic_error("Process variable with name " + processVariableName + " already exists.");
+    }
+    _processVariablesByName.emplace(std::string(processVariableName), inserted.first);
+    processVariables.second->setPublishCounter(&_publishCounterTable.add(processVariables.first));
 
     return std::make_pair(processVariables.first, processVariables.second);
   }
@@ -229,15 +405,41 @@ namespace ChimeraTK {
       createProcessArrayDeviceToControlSystem(ChimeraTK::RegisterPath const& processVariableName,
           const std::vector<T>& initialValue, const std::string& unit, const std::string& description,
           std::size_t numberOfBuffers, const AccessModeFlags& flags) {
-    if(_processVariables.find(processVariableName) != _processVariables.end()) {
+    StartupPhase phase("PVManager::createProcessArray");
+    // The process variables are created outside the lock, so several threads can create variables in parallel.
+    typename std::pair<typename ProcessArray<T>::SharedPtr, typename ProcessArray<T>::SharedPtr> processVariables =
+        createSynchronizedProcessArray<T>(initialValue, processVariableName, unit, description, numberOfBuffers, flags);
+
+    std::lock_guard<std::mutex> lock(_processVariablesMutex);
+    auto inserted = _processVariables.insert(
+        std::make_pair(processVariableName, std::make_pair(processVariables.second, processVariables.first)));
+    if(!inserted.second) {
       throw ChimeraTK::logic_error("Process variable with name " + processVariableName + " already exists.");
     }
+    _processVariablesByName.emplace(std::string(processVariableName), inserted.first);
+    processVariables.first->setPublishCounter(&_publishCounterTable.add(processVariables.second));
 
+    return std::make_pair(processVariables.second, processVariables.first);
+  }
+
+  template<class T>
+  std::pair<typename ProcessArray<T>::SharedPtr, typename ProcessArray<T>::SharedPtr> PVManager::
+      createMultiProducerProcessArrayDeviceToControlSystem(ChimeraTK::RegisterPath const& processVariableName,
+          const std::vector<T>& initialValue, const std::string& unit, const std::string& description,
+          MultiProducerOrdering ordering, std::size_t numberOfBuffers, const AccessModeFlags& flags) {
+    StartupPhase phase("PVManager::createProcessArray");
     typename std::pair<typename ProcessArray<T>::SharedPtr, typename ProcessArray<T>::SharedPtr> processVariables =
-        createSynchronizedProcessArray<T>(initialValue, processVariableName, unit, description, numberOfBuffers, flags);
+        createMultiProducerProcessArray<T>(
+            initialValue, processVariableName, unit, description, ordering, numberOfBuffers, flags);
 
-    _processVariables.insert(
+    std::lock_guard<std::mutex> lock(_processVariablesMutex);
+    auto inserted = _processVariables.insert(
         std::make_pair(processVariableName, std::make_pair(processVariables.second, processVariables.first)));
+    if(!inserted.second) {
+      throw ChimeraTK::logic_error("Process variable with name " + processVariableName + " already exists.");
+    }
+    _processVariablesByName.emplace(std::string(processVariableName), inserted.first);
+    processVariables.first->setPublishCounter(&_publishCounterTable.add(processVariables.second));
 
     return std::make_pair(processVariables.second, processVariables.first);
   }
@@ -247,15 +449,19 @@ namespace ChimeraTK {
       createProcessArrayControlSystemToDevice(ChimeraTK::RegisterPath const& processVariableName,
           const std::vector<T>& initialValue, const std::string& unit, const std::string& description,
           std::size_t numberOfBuffers, const AccessModeFlags& flags) {
-    if(_processVariables.find(processVariableName) != _processVariables.end()) {
-      throw ChimeraTK::logic_error("Process variable with name " + processVariableName + " already exists.");
-    }
-
+    StartupPhase phase("PVManager::createProcessArray");
+    // The process variables are created outside the lock, so several threads can create variables in parallel.
     typename std::pair<typename ProcessArray<T>::SharedPtr, typename ProcessArray<T>::SharedPtr> processVariables =
         createSynchronizedProcessArray<T>(initialValue, processVariableName, unit, description, numberOfBuffers, flags);
 
-    _processVariables.insert(
+    std::lock_guard<std::mutex> lock(_processVariablesMutex);
+    auto inserted = _processVariables.insert(
         std::make_pair(processVariableName, std::make_pair(processVariables.first, processVariables.second)));
+    if(!inserted.second) {
+      throw ChimeraTK::logic_error("Process variable with name " + processVariableName + " already exists.");
+    }
+    _processVariablesByName.emplace(std::string(processVariableName), inserted.first);
+    processVariables.second->setPublishCounter(&_publishCounterTable.add(processVariables.first));
 
     return std::make_pair(processVariables.first, processVariables.second);
   }
@@ -263,22 +469,32 @@ namespace ChimeraTK {
   template<class T>
   std::pair<typename ProcessArray<T>::SharedPtr, typename ProcessArray<T>::SharedPtr> PVManager::getProcessArray(
       ChimeraTK::RegisterPath const& processVariableName) const {
+    return getProcessArray<T>(std::string_view(static_cast<std::string>(processVariableName)));
+  }
+
+  template<class T>
+  std::pair<typename ProcessArray<T>::SharedPtr, typename ProcessArray<T>::SharedPtr> PVManager::getProcessArray(
+      std::string_view processVariableName) const {
     ProcessVariableSharedPtrPair processVariable = getProcessVariable(processVariableName);
     typename ProcessArray<T>::SharedPtr csPV =
         boost::dynamic_pointer_cast<ProcessArray<T>, ProcessVariable>(processVariable.first);
     typename ProcessArray<T>::SharedPtr devPV =
         boost::dynamic_pointer_cast<ProcessArray<T>, ProcessVariable>(processVariable.second);
     if(!csPV || !devPV) {
-      throw ChimeraTK::logic_error("PVManager::getProcessArray() called for variable '" + processVariableName +
-          "' with type " + typeid(T).name() + " which is not the original type " +
+      throw ChimeraTK::logic_error("PVManager::getProcessArray() called for variable '" +
+          std::string(processVariableName) + "' with type " + typeid(T).name() + " which is not the original type " +
           processVariable.first->getValueType().name() + " of this process variable.");
     }
     return std::make_pair(csPV, devPV);
   }
 
   inline bool PVManager::hasProcessVariable(ChimeraTK::RegisterPath const& processVariableName) const {
-    auto i = _processVariables.find(processVariableName);
-    return (i != _processVariables.end());
+    return hasProcessVariable(std::string_view(static_cast<std::string>(processVariableName)));
+  }
+
+  inline bool PVManager::hasProcessVariable(std::string_view processVariableName) const {
+    std::lock_guard<std::mutex> lock(_processVariablesMutex);
+    return findProcessVariable(processVariableName) != _processVariables.end();
   }
 
 } // namespace ChimeraTK
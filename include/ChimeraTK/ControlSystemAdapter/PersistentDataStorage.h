@@ -2,12 +2,21 @@
 #define CHIMERA_TK_CONTROL_SYSTEM_ADAPTER_PERSISTENT_DATA_STORAGE_H
 
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <iostream>
 #include <map>
+#include <memory>
 #include <string>
 #include <typeinfo>
 #include <vector>
 
+#include "AsyncFileWriter.h"
+#include "TimerWheel.h"
+#include "TransferTracer.h"
+
 #include <boost/fusion/include/for_each.hpp>
 #include <boost/thread.hpp>
 
@@ -23,6 +32,35 @@ namespace ChimeraTK {
 
   class ControlSystemPVManager;
 
+  /**
+   * Policy deciding when a change of a variable causes the persistency file to be written. The file always contains
+   * all variables, so a write caused by one variable also stores the latest values of all others (except those with
+   * the shutdownOnly policy).
+   */
+  struct PersistencePolicy {
+    enum class Mode {
+      periodic,    ///< write the file at most once per period, one period after the variable has changed
+      onChange,    ///< write the file the given delay after the variable has changed (rate limit, see onChange())
+      shutdownOnly ///< store the value only when the PersistentDataStorage is destroyed
+    };
+
+    Mode mode{Mode::periodic};
+
+    /** Interval for periodic (zero: use the write interval of the PersistentDataStorage), delay for onChange. Ignored
+     *  for shutdownOnly. */
+    std::chrono::milliseconds interval{0};
+
+    static PersistencePolicy periodic(std::chrono::milliseconds period = {}) { return {Mode::periodic, period}; }
+    /** Write the file the given delay after the first change of the variable. Further changes until then are stored
+     *  by the same write and do not restart the delay, so this is a rate limit rather than a debounce: the delay is
+     *  also the minimum interval between writes caused by this variable, and a continuously changing variable is
+     *  stored once per delay. A delay of zero writes the file as soon as possible (within the timer resolution). */
+    static PersistencePolicy onChange(std::chrono::milliseconds delay = {}) { return {Mode::onChange, delay}; }
+    static PersistencePolicy shutdownOnly() { return {Mode::shutdownOnly, {}}; }
+  };
+
+  /*********************************************************************************************************************/
+
   /**
    *  Persistent data storage for process variables.
    *
@@ -35,10 +73,13 @@ namespace ChimeraTK {
    * from the file. This will be seen as a value received by the application just
    * like any other update.
    *
+   *  When the file is written in between is decided per variable by its PersistencePolicy, see
+   * setPersistencePolicy(). By default, the file is written fileWriteInterval seconds after a variable has changed.
+   * The writer thread sleeps until the next write is due, so it does not wake up at all while nothing changes.
+   *
    *  @todo TODO list:
    *    * thread safety (only an issue when having multiple
    * ControlSystemPVManagers)
-   *    * automatic periodic commits
    *    * manual commits triggered by the application (with support for other
    * implementations, e.g. if the persistency is already provided by the control
    * system middleware)
@@ -56,6 +97,12 @@ namespace ChimeraTK {
     /** Destructor: Store variables to the file. */
     ~PersistentDataStorage();
 
+    /** Stop the thread writing the file in between. A write in progress is aborted, leaving the previous file in
+     *  place, so this only takes as long as serialising one variable. The file is still written by the destructor.
+     *  Called by the destructor, and by ControlSystemPVManager::shutdown() so the final write is not delayed by a
+     *  periodic one. */
+    void stopWriterThread();
+
     /** Register a variable to be stored to and retrieved from the data storage.
      * The returned value is the ID which must be passed to the other functions.
      * The last argument "fromFile" should be false when the function is called
@@ -73,16 +120,32 @@ namespace ChimeraTK {
     template<typename DataType>
     void updateValue(int id, std::vector<DataType> const& value);
 
+    /** Set a prefix which is removed from the names of variables registered by the
+     * application before they are stored. This is used when the application is
+     * hosted by a MultiApplicationHost, so the file contains the same names as if
+     * the application was running standalone. Must be called before any variable
+     * is registered by the application. */
+    void setVariableNamePrefix(const ChimeraTK::RegisterPath& prefix) { _variableNamePrefix = std::string(prefix); }
+
+    /** Set the persistence policy of the variable with the given name. Can be called before or after the variable is
+     *  registered. */
+    void setPersistencePolicy(const ChimeraTK::RegisterPath& name, PersistencePolicy policy);
+
+    /** Set the persistence policy for all variables without an explicit policy. Only affects variables registered
+     *  afterwards. The default is PersistencePolicy::periodic(). */
+    void setDefaultPersistencePolicy(PersistencePolicy policy);
+
    protected:
-    /** Write out the file containing the persistent data */
-    void writeToFile() noexcept;
+    /** Write out the file containing the persistent data. Variables with the shutdownOnly policy are written with the
+     *  value stored previously unless isShutdown is true. */
+    void writeToFile(bool isShutdown = true) noexcept;
 
     /** Read the file containing the persistent data */
     void readFromFile();
 
-    /** Generate XML tags for the given value */
+    /** Append the XML tags for the given value to the output */
     template<typename DataType>
-    void generateXmlValueTags(xmlpp::Element* parent, size_t id);
+    void generateXmlValueTags(std::string& output, size_t id, bool keepStoredValue);
 
     /** Read value from XML tags */
     template<typename DataType>
@@ -94,6 +157,9 @@ namespace ChimeraTK {
     /** File name to store the data to */
     std::string _filename;
 
+    /** Prefix removed from the variable names, see setVariableNamePrefix(). Empty if not set. */
+    std::string _variableNamePrefix;
+
     /** Vector of variable names. The index is the ID of the variable. */
     std::vector<ChimeraTK::RegisterPath> _variableNames;
 
@@ -119,6 +185,7 @@ namespace ChimeraTK {
        }
        return _latestValue;
      }
+     std::vector<DataType>& getStored() { return _latestValue; }
     };
 
     /** Type definition for the map holding the values for one specific data type.
@@ -130,6 +197,9 @@ namespace ChimeraTK {
      * the type */
     ChimeraTK::TemplateUserTypeMap<DataMap> _dataMap;
 
+    /** Writer for the persistency file, the file is serialised while the previous parts are written */
+    AsyncFileWriter _fileWriter;
+
     /** */
     boost::thread _writerThread;
 
@@ -140,6 +210,81 @@ namespace ChimeraTK {
     // write interval in seconds (does not have to be atomic. Only used in the writer thread and is const.)
     unsigned int const _fileWriteInterval{};
 
+    /** Remove the prefix set with setVariableNamePrefix() from the name */
+    [[nodiscard]] ChimeraTK::RegisterPath removeVariableNamePrefix(const ChimeraTK::RegisterPath& variableName) const;
+
+    /** Apply the persistence policy to a variable registered by the application */
+    void applyPersistencePolicy(size_t id);
+
+    /** Set the policy of a registered variable and start its timers. _scheduleMutex must be held. */
+    void setVariablePolicy(size_t id, PersistencePolicy policy);
+
+    /** Called by updateValue(): mark the variable as changed and schedule the write if needed */
+    void notifyValueUpdated(size_t id);
+
+    /** Period of the given policy as clock duration */
+    [[nodiscard]] std::chrono::steady_clock::duration getPeriod(const PersistencePolicy& policy) const;
+
+    /** Mutex protecting the scheduling state below. _queueReadMutex must not be acquired while holding it. */
+    std::mutex _scheduleMutex;
+
+    /** Policies set with setPersistencePolicy(), by variable name */
+    std::map<std::string, PersistencePolicy> _policiesByName;
+
+    PersistencePolicy _defaultPolicy;
+
+    /** Policy of each variable. The index is the ID of the variable. */
+    std::vector<PersistencePolicy> _variablePolicies;
+
+    /** Flags whether the variable has changed since the file has been written, in chunks of changedFlagsChunkSize
+     *  variables. Only set and cleared while holding _scheduleMutex, but read without it by notifyValueUpdated(), so
+     *  updates of already changed variables do not take the mutex. The chunks are allocated while holding
+     *  _scheduleMutex and are never moved, so the reads without the mutex only need to load the chunk pointer. */
+    static constexpr size_t changedFlagsChunkSize = 256;
+    std::array<std::atomic<std::atomic<bool>*>, 4096> _variableChangedChunks{};
+
+    /** Owner of the chunks in _variableChangedChunks. Only accessed while holding _scheduleMutex. */
+    std::vector<std::unique_ptr<std::atomic<bool>[]>> _variableChangedStorage;
+
+    /** Return the changed flag of the variable with the given ID, or nullptr if it has not been allocated yet. Can be
+     *  called without holding _scheduleMutex. */
+    [[nodiscard]] std::atomic<bool>* getChangedFlag(size_t id) const;
+
+    /** Extend the scheduling state (policy, changed flag and timer generation) up to the given ID. Variables added
+     *  this way get the default policy. _scheduleMutex must be held. */
+    void extendVariableState(size_t id);
+
+    /** Generation of the timers of the variable, incremented when the policy changes. Timers of older generations are
+     *  ignored. The index is the ID of the variable. */
+    std::vector<uint64_t> _variableTimerGeneration;
+
+    struct PersistenceTimer {
+      size_t id;
+      uint64_t generation;
+    };
+
+    /** Timers for the periodic and onChange policies. Timers are only running for changed variables. */
+    detail::TimerWheel<PersistenceTimer> _timerWheel{timerWheelTick};
+
+    /** Wakes up the writer thread when a timer has been scheduled or on shutdown */
+    std::condition_variable _scheduleCondition;
+
+    /** Flag to terminate the writer thread */
+    bool _shutdownRequested{false};
+
+    /** Flag to abort a write by the writer thread in progress, see stopWriterThread() */
+    std::atomic<bool> _abortPeriodicWrite{false};
+
+    /** Schedule the timer of a changed variable according to its policy. _scheduleMutex must be held. */
+    void scheduleWrite(size_t id);
+
+    /** Name ID of the file for the transfer tracer, interned on the first traced flush. Flushes never run
+     *  concurrently, so no synchronisation is needed. */
+    uint32_t _traceNameId{detail::invalidTraceNameId};
+
+    /** Resolution of the timers */
+    static constexpr std::chrono::milliseconds timerWheelTick{100};
+
     /** A functor needed in registerVariable() */
     struct RegisterVariableOldTypeRemover {
       template<typename PAIR>
@@ -165,7 +310,11 @@ namespace ChimeraTK {
   /*********************************************************************************************************************/
 
   template<typename DataType>
-  size_t PersistentDataStorage::registerVariable(ChimeraTK::RegisterPath const& name, size_t nElements, bool fromFile) {
+  size_t PersistentDataStorage::registerVariable(
+      ChimeraTK::RegisterPath const& variableName, size_t nElements, bool fromFile) {
+    // remove the prefix of the hosting application, if any
+    ChimeraTK::RegisterPath name = fromFile ? variableName : removeVariableNamePrefix(variableName);
+
     // check if already existing
     auto position = std::find(_variableNames.begin(), _variableNames.end(), name);
 
@@ -191,6 +340,10 @@ namespace ChimeraTK {
       std::vector<DataType>& value = boost::fusion::at_key<DataType>(_dataMap.table)[id].readLatest();
       value.resize(nElements);
 
+      if(!fromFile) {
+        applyPersistencePolicy(id);
+      }
+
       // return id
       return id;
     }
@@ -213,6 +366,8 @@ namespace ChimeraTK {
       std::vector<DataType>& value = boost::fusion::at_key<DataType>(_dataMap.table)[id].readLatest();
       value.resize(nElements);
 
+      applyPersistencePolicy(id);
+
       // return id
       return id;
     }
@@ -230,6 +385,8 @@ namespace ChimeraTK {
       value.resize(nElements);
     }
 
+    applyPersistencePolicy(id);
+
     return id;
   }
 
@@ -246,6 +403,7 @@ namespace ChimeraTK {
   template<typename DataType>
   void PersistentDataStorage::updateValue(int id, std::vector<DataType> const &value) {
     boost::fusion::at_key<DataType>(_dataMap.table)[id].pushOverwrite(value);
+    notifyValueUpdated(static_cast<size_t>(id));
   }
 
 } // namespace ChimeraTK
@@ -0,0 +1,133 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include <boost/shared_ptr.hpp>
+
+#include <sys/uio.h>
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+namespace ChimeraTK {
+
+  namespace detail {
+
+    /**
+     * Pool of spare buffers of a process array, used to replace the user buffer when it is pinned. Pinned buffers are
+     * returned to the pool when released, so in steady state pinning does not allocate. The pool is shared between the
+     * process array and its pinned buffers, since they may be released from another thread and after the process array
+     * is gone.
+     */
+    template<class T>
+    class PinnedBufferPool {
+     public:
+      /** Take a spare buffer of the given size out of the pool, or allocate a new one if the pool is empty. */
+      std::vector<T> take(size_t size) {
+        {
+          std::lock_guard<std::mutex> lock(_mutex);
+          if(!_spares.empty()) {
+            std::vector<T> spare = std::move(_spares.back());
+            _spares.pop_back();
+            if(spare.size() == size) {
+              return spare;
+            }
+          }
+        }
+        return std::vector<T>(size);
+      }
+
+      /** Return a buffer to the pool. Buffers beyond the maximum pool size are freed. */
+      void put(std::vector<T>&& buffer) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if(_spares.size() < maxSpares) {
+          _spares.push_back(std::move(buffer));
+        }
+      }
+
+      /** Number of buffers currently in the pool */
+      size_t size() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _spares.size();
+      }
+
+      /** Maximum number of buffers kept in the pool */
+      static constexpr size_t maxSpares = 8;
+
+     private:
+      std::mutex _mutex;
+      std::vector<std::vector<T>> _spares;
+    };
+
+  } // namespace detail
+
+  /*********************************************************************************************************************/
+
+  /**
+   * A buffer which has been pinned with ProcessArray::pinBuffer(). It owns the value which was in the user buffer of
+   * the process array at that time, so control system adapters can pass the memory directly to writev() or sendmsg()
+   * instead of copying it into protocol buffers first.
+   *
+   * The buffer is returned to the spare pool of the process array when release() is called or the PinnedBuffer is
+   * destroyed. Alternatively, releaseCallback() turns it into a callback, e.g. for asynchronous send completions. The
+   * pinned buffer may be released from any thread, and it may outlive the process array.
+   *
+   * Only available for trivially copyable user types, since the memory is exported as raw bytes.
+   */
+  template<class T>
+  class PinnedBuffer {
+    static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types can be exported as iovec.");
+
+   public:
+    PinnedBuffer(std::vector<T>&& value, boost::shared_ptr<detail::PinnedBufferPool<T>> pool)
+    : _value(std::move(value)), _pool(std::move(pool)) {}
+
+    PinnedBuffer(PinnedBuffer&& other) noexcept = default;
+    PinnedBuffer& operator=(PinnedBuffer&& other) noexcept {
+      release();
+      _value = std::move(other._value);
+      _pool = std::move(other._pool);
+      return *this;
+    }
+
+    PinnedBuffer(const PinnedBuffer&) = delete;
+    PinnedBuffer& operator=(const PinnedBuffer&) = delete;
+
+    ~PinnedBuffer() { release(); }
+
+    /** Return the memory as iovec, to be passed to writev(), sendmsg() etc. */
+    [[nodiscard]] iovec getIovec() const { return {const_cast<T*>(_value.data()), _value.size() * sizeof(T)}; }
+
+    /** Return a pointer to the first element. */
+    [[nodiscard]] const T* data() const { return _value.data(); }
+
+    /** Return the number of elements. */
+    [[nodiscard]] size_t size() const { return _value.size(); }
+
+    /** Check whether the buffer is still pinned, i.e. has not been released or moved away. */
+    [[nodiscard]] bool isPinned() const { return _pool != nullptr; }
+
+    /** Return the buffer to the process array. The memory must not be accessed afterwards. */
+    void release() {
+      if(_pool) {
+        _pool->put(std::move(_value));
+        _pool.reset();
+      }
+    }
+
+    /** Move the pinned buffer into a callback which releases it when called (or when destroyed). Use getIovec() before
+     *  calling this function. */
+    std::function<void()> releaseCallback() && {
+      auto pinned = std::make_shared<PinnedBuffer>(std::move(*this));
+      return [pinned] { pinned->release(); };
+    }
+
+   private:
+    std::vector<T> _value;
+    boost::shared_ptr<detail::PinnedBufferPool<T>> _pool;
+  };
+
+} // namespace ChimeraTK
@@ -1,18 +1,24 @@
 #ifndef CHIMERA_TK_CONTROL_SYSTEM_ADAPTER_PROCESS_ARRAY_H
 #define CHIMERA_TK_CONTROL_SYSTEM_ADAPTER_PROCESS_ARRAY_H
 
+#include <atomic>
+#include <cstdint>
 #include <limits>
 #include <stdexcept>
 #include <typeinfo>
 #include <utility>
 #include <vector>
 
+#include <boost/make_shared.hpp>
 #include <boost/shared_ptr.hpp>
 
 #include <ChimeraTK/NDRegisterAccessor.h>
 #include <ChimeraTK/VersionNumber.h>
 
+#include "LatestValueView.h"
 #include "PersistentDataStorage.h"
+#include "PinnedBuffer.h"
+#include "TransferTracer.h"
 
 namespace ChimeraTK {
 
@@ -99,11 +105,90 @@ namespace ChimeraTK {
       // You can't replace anything here. Just do nothing.
     }
 
+    /**
+     * Pin the current content of the user buffer, typically right after a
+     * read, so it can be exported without copying (see PinnedBuffer). The user
+     * buffer is replaced with a spare buffer of the same size, whose content is
+     * undefined until the next read. Once the pinned buffer is released, it is
+     * used as spare buffer for the next call, so in steady state no memory is
+     * allocated.
+     *
+     * Only available for trivially copyable user types.
+     */
+    PinnedBuffer<T> pinBuffer();
+
+    /**
+     * Set the counter of the PublishCounterTable which is incremented each time this process array sends a value.
+     * Called by the PVManager for the device side of each process variable.
+     */
+    virtual void setPublishCounter(std::atomic<uint64_t>* counter) { _publishCounter = counter; }
+
+    /**
+     * Return a view of the latest value of this process array, which can be read by any number of threads
+     * concurrently without locking (see LatestValueView). The view is initialised with the current content of the
+     * user buffer and updated by each read which receives new data.
+     *
+     * Must be called from the thread reading this process array. Throws a ChimeraTK::logic_error if the process array
+     * is not readable.
+     */
+    LatestValueView<T> getLatestValueView();
+
    protected:
     /**
      * Type this instance is representing.
      */
     InstanceType _instanceType;
+
+    /**
+     * Return the ID of the name of this process variable for the transfer tracing. The name is interned on first use,
+     * so this should only be called when tracing is enabled.
+     */
+    uint32_t traceNameId() {
+      if(_traceNameId == detail::invalidTraceNameId) {
+        _traceNameId = detail::internTraceName(this->getName());
+      }
+      return _traceNameId;
+    }
+
+    /**
+     * Increment the publish counter, if any. Each counter has a single writer, so no read-modify-write is needed.
+     */
+    void incrementPublishCounter() {
+      if(_publishCounter) {
+        _publishCounter->store(_publishCounter->load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+      }
+    }
+
+    /**
+     * Counter in the PublishCounterTable of the PV manager, only set for the device side.
+     */
+    std::atomic<uint64_t>* _publishCounter{nullptr};
+
+    /**
+     * Publish the content of the user buffer to the latest value view, if any. Called by the implementations when a
+     * read has received new data.
+     */
+    void publishLatestValue() {
+      if(_latestValueSlot) {
+        _latestValueSlot->publish(this->buffer_2D[0], TransferElement::_versionNumber, TransferElement::_dataValidity);
+      }
+    }
+
+    /**
+     * Storage behind the latest value views, created on first use.
+     */
+    boost::shared_ptr<detail::LatestValueSlot<T>> _latestValueSlot;
+
+   private:
+    /**
+     * Cached name ID for the transfer tracing.
+     */
+    uint32_t _traceNameId{detail::invalidTraceNameId};
+
+    /**
+     * Spare buffers for pinBuffer(), created on first use.
+     */
+    boost::shared_ptr<detail::PinnedBufferPool<T>> _pinnedBufferPool;
   };
 
   /********************************************************************************************************************/
@@ -122,6 +207,34 @@ namespace ChimeraTK {
   template<class T>
   ProcessArray<T>::~ProcessArray() = default;
 
+  /********************************************************************************************************************/
+
+  template<class T>
+  PinnedBuffer<T> ProcessArray<T>::pinBuffer() {
+    if(!_pinnedBufferPool) {
+      _pinnedBufferPool = boost::make_shared<detail::PinnedBufferPool<T>>();
+    }
+    auto& userBuffer = ChimeraTK::NDRegisterAccessor<T>::buffer_2D[0];
+    std::vector<T> spare = _pinnedBufferPool->take(userBuffer.size());
+    spare.swap(userBuffer);
+    return PinnedBuffer<T>(std::move(spare), _pinnedBufferPool);
+  }
+
+  /********************************************************************************************************************/
+
+  template<class T>
+  LatestValueView<T> ProcessArray<T>::getLatestValueView() {
+    if(!isReadable()) {
+      throw ChimeraTK::logic_error(
+          "ProcessArray::getLatestValueView(): Process variable '" + this->getName() + "' is not readable.");
+    }
+    if(!_latestValueSlot) {
+      _latestValueSlot = boost::make_shared<detail::LatestValueSlot<T>>(
+          this->buffer_2D[0], TransferElement::_versionNumber, TransferElement::_dataValidity);
+    }
+    return LatestValueView<T>(_latestValueSlot);
+  }
+
 } // namespace ChimeraTK
 
 #endif // CHIMERA_TK_CONTROL_SYSTEM_ADAPTER_PROCESS_ARRAY_H
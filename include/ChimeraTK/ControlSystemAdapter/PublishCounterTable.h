@@ -0,0 +1,133 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include "ProcessVariable.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace ChimeraTK {
+
+  class ControlSystemPVManager;
+
+  /**
+   * Contiguous table of publish counters, one per process variable of a PV manager. Each time the device side sends a
+   * value to the control system, it increments the counter of the process variable. Control system adapters can find
+   * the changed process variables with a PublishCounterScanner, which only compares the table against a copy instead
+   * of touching each process array.
+   *
+   * The counters are stored in chunks of chunkSize counters, so the table can grow while being scanned without moving
+   * existing counters. Process variables are added by the PVManager when they are created, the index of a process
+   * variable never changes. Process variables which are never written by the device side (control system to device)
+   * also get a counter, which stays zero.
+   *
+   * Each counter has a single writer (the device side of its process variable; multi-producer arrays increment it
+   * under their producer lock), so it is incremented with relaxed load and store instead of a read-modify-write.
+   */
+  class PublishCounterTable {
+   public:
+    using Counter = std::atomic<uint64_t>;
+
+    static_assert(sizeof(Counter) == sizeof(uint64_t) && Counter::is_always_lock_free,
+        "The scanner relies on the counters having the layout of plain 64 bit integers.");
+
+    /** Number of counters per chunk */
+    static constexpr size_t chunkSize = 4096;
+
+    /** Maximum number of chunks, which limits the number of process variables per PV manager */
+    static constexpr size_t maxChunks = 1024;
+
+    /** Chunk of counters, aligned to the cache line size */
+    struct alignas(64) Chunk {
+      std::array<Counter, chunkSize> counters{};
+    };
+
+    PublishCounterTable() = default;
+    PublishCounterTable(const PublishCounterTable&) = delete;
+    PublishCounterTable& operator=(const PublishCounterTable&) = delete;
+
+    /** Add a counter for the given process variable of the control system side and return it. The counter is only
+     *  visible to scanners when add() returns. Throws a ChimeraTK::logic_error if the table is full. */
+    Counter& add(const ProcessVariable::SharedPtr& controlSystemProcessVariable);
+
+    /** Number of counters in the table */
+    [[nodiscard]] size_t size() const { return _size.load(std::memory_order_acquire); }
+
+    /** Return the chunk with the given index. Only valid for chunks containing counters below size(). */
+    [[nodiscard]] const Chunk& getChunk(size_t chunkIndex) const {
+      return *_chunks[chunkIndex].load(std::memory_order_acquire);
+    }
+
+    /** Return the counter with the given index, which must be below size(). */
+    [[nodiscard]] const Counter& getCounter(size_t index) const {
+      return getChunk(index / chunkSize).counters[index % chunkSize];
+    }
+
+    /** Return the control system side of the process variable with the given index. */
+    [[nodiscard]] ProcessVariable::SharedPtr getProcessVariable(size_t index) const;
+
+   private:
+    /** Mutex for adding counters */
+    mutable std::mutex _mutex;
+
+    /** Pointers to the chunks. Chunks are allocated on demand and never freed while the table exists. */
+    std::array<std::atomic<Chunk*>, maxChunks> _chunks{};
+
+    /** Owners of the chunks */
+    std::vector<std::unique_ptr<Chunk>> _chunkStorage;
+
+    /** Control system side of the process variables, same index as the counters */
+    std::vector<ProcessVariable::SharedPtr> _processVariables;
+
+    std::atomic<size_t> _size{0};
+  };
+
+  /*********************************************************************************************************************/
+
+  /**
+   * Finds the process variables whose publish counter has changed since the last scan, by comparing the
+   * PublishCounterTable of a PV manager against a copy of the counters. Where SSE2 is available, the comparison is
+   * done on 16 byte vectors, so a table of 100k process variables without changes is scanned in a few microseconds.
+   *
+   * A changed counter only means that the process variable has received at least one value since the last scan. The
+   * value itself still has to be read through the process variable, which is not done by the scanner.
+   *
+   * The first scan reports all process variables which have been written since they were created. A scanner must only
+   * be used by one thread.
+   */
+  class PublishCounterScanner {
+   public:
+    explicit PublishCounterScanner(boost::shared_ptr<ControlSystemPVManager> pvManager);
+
+    /** Find the process variables which have changed since the last scan. Their indices in the PublishCounterTable
+     *  are appended to changedIndices in ascending order. */
+    void scan(std::vector<size_t>& changedIndices);
+
+    /** Like scan(), but returns the changed indices. */
+    [[nodiscard]] std::vector<size_t> scan();
+
+    /** Return the control system side of the process variable with the given index. */
+    [[nodiscard]] ProcessVariable::SharedPtr getProcessVariable(size_t index) const {
+      return _table.getProcessVariable(index);
+    }
+
+   private:
+    /** Compare the counters of one chunk against the copy and update the copy. */
+    void scanChunk(const PublishCounterTable::Chunk& chunk, uint64_t* lastSeen, size_t nCounters, size_t firstIndex,
+        std::vector<size_t>& changedIndices);
+
+    /** Keep the PV manager alive, it owns the table */
+    boost::shared_ptr<ControlSystemPVManager> _pvManager;
+
+    const PublishCounterTable& _table;
+
+    /** Counter values seen by the last scan, one array of chunkSize values per chunk */
+    std::vector<std::unique_ptr<uint64_t[]>> _lastSeen;
+  };
+
+} // namespace ChimeraTK
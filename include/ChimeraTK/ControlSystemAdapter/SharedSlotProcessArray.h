@@ -0,0 +1,309 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include "PersistentDataStorage.h"
+#include "ProcessArray.h"
+#include "UnidirectionalProcessArray.h"
+
+#include <boost/shared_ptr.hpp>
+
+#include <array>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <vector>
+
+namespace ChimeraTK {
+
+  namespace detail {
+
+    /**
+     * The single value slot shared by both sides of a SharedSlotProcessArray. The value is protected by a spin lock,
+     * the notifications tell the respective side that the other side has written.
+     */
+    template<class T>
+    struct SharedSlot {
+      explicit SharedSlot(const std::vector<T>& initialValue)
+      : value(initialValue), notifications{{cppext::future_queue<void>(1), cppext::future_queue<void>(1)}} {}
+
+      SpinLock lock;
+
+      /** Newest value written by either side, protected by the lock */
+      std::vector<T> value;
+
+      /** Version number of the value, protected by the lock */
+      VersionNumber versionNumber{nullptr};
+
+      /** Validity of the value, protected by the lock */
+      DataValidity dataValidity{DataValidity::ok};
+
+      /** Side which has written the value, protected by the lock */
+      size_t writer{std::numeric_limits<size_t>::max()};
+
+      /** Notification queue per side, pushed by the respective other side on each write */
+      std::array<cppext::future_queue<void>, 2> notifications;
+    };
+
+  } // namespace detail
+
+  /*********************************************************************************************************************/
+
+  /**
+   * Alternative implementation of a bidirectional process array, which is built on a single shared value slot instead
+   * of two UnidirectionalProcessArray instances with their queues.
+   *
+   * Both sides write into the same slot with last-version-wins semantics: a write with a version number older than the
+   * value in the slot does not change the slot, and the other side rejects it when reading (calling the value reject
+   * callback like BidirectionalProcessArray does). Reading swaps the value out of the slot, so it does not copy. A
+   * write copies the value once into the slot, writeDestructively() swaps it instead.
+   *
+   * Since there is only one slot, values which are written before the other side has read the previous one are merged
+   * and only the newest one is received. This is reported as lost data by write(). The slot is intended for small
+   * setpoints, where it needs a fraction of the memory of a BidirectionalProcessArray. For larger arrays or if
+   * intermediate values must not be lost, use BidirectionalProcessArray.
+   *
+   * This class is not thread-safe and should only be used from a single thread.
+   */
+  template<class T>
+  class SharedSlotProcessArray : public ProcessArray<T> {
+   public:
+    using SharedPtr = boost::shared_ptr<SharedSlotProcessArray>;
+
+    /**
+     * Create one side of the process array. Use createSharedSlotProcessArray() instead of calling this constructor
+     * directly.
+     */
+    SharedSlotProcessArray(boost::shared_ptr<detail::SharedSlot<T>> slot, size_t side,
+        const ChimeraTK::RegisterPath& name, const std::string& unit, const std::string& description,
+        bool allowPersistentDataStorage, const AccessModeFlags& flags);
+
+    void doReadTransferSynchronously() override;
+
+    void doPostRead(ChimeraTK::TransferType type, bool hasNewData) override;
+
+    bool doWriteTransfer(ChimeraTK::VersionNumber versionNumber) override;
+
+    bool doWriteTransferDestructively(ChimeraTK::VersionNumber versionNumber) override;
+
+    void setPersistentDataStorage(boost::shared_ptr<PersistentDataStorage> storage) override;
+
+    void interrupt() override { TransferElement::interrupt_impl(_slot->notifications[_side]); }
+
+    [[nodiscard]] size_t getUniqueId() const override { return reinterpret_cast<size_t>(_slot.get()); }
+
+    /**
+     * Set a callback function which is called whenever a value is rejected because it is old. See
+     * BidirectionalProcessArray::setValueRejectCallback().
+     */
+    void setValueRejectCallback(std::function<void()> callback) { _valueRejectCallback = std::move(callback); }
+
+   private:
+    /** Common implementation of the write transfers */
+    bool writeInternal(VersionNumber versionNumber, bool shouldCopy);
+
+    /** The slot shared with the other side */
+    boost::shared_ptr<detail::SharedSlot<T>> _slot;
+
+    /** Index of this side (0 or 1) */
+    size_t _side;
+
+    /** Flag whether this side may be associated with a persistent data storage, see BidirectionalProcessArray */
+    bool _allowPersistentDataStorage;
+
+    /** Persistent data storage which needs to be informed when a value is sent or received */
+    boost::shared_ptr<PersistentDataStorage> _persistentDataStorage;
+
+    /** Variable ID for the persistent data storage */
+    size_t _persistentDataStorageID{0};
+
+    /** Callback to be called when values get rejected */
+    std::function<void()> _valueRejectCallback;
+  };
+
+  /*********************************************************************************************************************/
+
+  /**
+   * Creates a bidirectional process array based on a single shared slot, see SharedSlotProcessArray. Of the two
+   * returned process arrays, only the first one can take an optional persistent data storage.
+   */
+  template<class T>
+  std::pair<typename ProcessArray<T>::SharedPtr, typename ProcessArray<T>::SharedPtr> createSharedSlotProcessArray(
+      const std::vector<T>& initialValue, const ChimeraTK::RegisterPath& name = "", const std::string& unit = "",
+      const std::string& description = "", const AccessModeFlags& flags = {AccessMode::wait_for_new_data});
+
+  /*********************************************************************************************************************/
+  /*** Implementations of member functions below this line *************************************************************/
+  /*********************************************************************************************************************/
+
+  template<class T>
+  SharedSlotProcessArray<T>::SharedSlotProcessArray(boost::shared_ptr<detail::SharedSlot<T>> slot, size_t side,
+      const ChimeraTK::RegisterPath& name, const std::string& unit, const std::string& description,
+      bool allowPersistentDataStorage, const AccessModeFlags& flags)
+  : ProcessArray<T>(ProcessArray<T>::SENDER_RECEIVER, name, unit, description, flags), _slot(std::move(slot)),
+    _side(side), _allowPersistentDataStorage(allowPersistentDataStorage) {
+    if(not flags.has(AccessMode::wait_for_new_data)) {
+      throw ChimeraTK::logic_error("Cannot create Bidirectional Process Arrays without wait_for_new_data");
+    }
+    assert(_side < 2);
+
+    TransferElement::_readQueue = _slot->notifications[_side].template then<void>(
+        [this] {
+          bool isNewValue;
+          {
+            std::lock_guard<detail::SpinLock> lock(_slot->lock);
+            isNewValue = _slot->writer != _side && _slot->versionNumber > TransferElement::getVersionNumber();
+          }
+          if(!isNewValue) {
+            if(detail::isTransferTracingEnabled()) {
+              detail::recordTraceInstant("reject", this->traceNameId());
+            }
+            if(_valueRejectCallback) {
+              _valueRejectCallback();
+            }
+            throw detail::DiscardValueException();
+          }
+        },
+        std::launch::deferred);
+
+    ChimeraTK::NDRegisterAccessor<T>::buffer_2D.resize(1);
+    ChimeraTK::NDRegisterAccessor<T>::buffer_2D[0] = _slot->value;
+  }
+
+  /*********************************************************************************************************************/
+
+  template<class T>
+  void SharedSlotProcessArray<T>::doReadTransferSynchronously() {
+    throw ChimeraTK::logic_error("SharedSlotProcessArray::doReadTransferSynchronously must not be called.");
+  }
+
+  /*********************************************************************************************************************/
+
+  template<class T>
+  void SharedSlotProcessArray<T>::doPostRead(ChimeraTK::TransferType, bool hasNewData) {
+    if(!hasNewData) {
+      return;
+    }
+    {
+      std::lock_guard<detail::SpinLock> lock(_slot->lock);
+      // Only the other side can have replaced the value since the check in the continuation, and it can only have
+      // made it newer. After the swap, the slot holds our old buffer, which is never read since its version number is
+      // not newer than ours.
+      assert(_slot->writer != _side);
+      assert(_slot->value.size() == this->accessChannel(0).size());
+      this->accessChannel(0).swap(_slot->value);
+      TransferElement::_versionNumber = _slot->versionNumber;
+      TransferElement::_dataValidity = _slot->dataValidity;
+    }
+    this->publishLatestValue();
+    if(detail::isAdapterStatisticsEnabled()) {
+      detail::adapterStatisticsCounters.reads.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // A value received from the other side is treated like a value sent by this side.
+    if(_persistentDataStorage) {
+      _persistentDataStorage->updateValue(_persistentDataStorageID, this->accessChannel(0));
+    }
+  }
+
+  /*********************************************************************************************************************/
+
+  template<class T>
+  bool SharedSlotProcessArray<T>::doWriteTransfer(ChimeraTK::VersionNumber versionNumber) {
+    return writeInternal(versionNumber, true);
+  }
+
+  /*********************************************************************************************************************/
+
+  template<class T>
+  bool SharedSlotProcessArray<T>::doWriteTransferDestructively(ChimeraTK::VersionNumber versionNumber) {
+    return writeInternal(versionNumber, false);
+  }
+
+  /*********************************************************************************************************************/
+
+  template<class T>
+  bool SharedSlotProcessArray<T>::writeInternal(VersionNumber versionNumber, bool shouldCopy) {
+    if(ChimeraTK::NDRegisterAccessor<T>::buffer_2D[0].size() != _slot->value.size()) {
+      throw ChimeraTK::logic_error("Cannot run write operation because the size of the vector belonging "
+                                   "to the current buffer has been modified. Variable name: " +
+          this->getName());
+    }
+
+    // The persistent data storage must be updated before a destructive write takes the value away.
+    if(_persistentDataStorage) {
+      _persistentDataStorage->updateValue(_persistentDataStorageID, this->accessChannel(0));
+    }
+
+    {
+      std::lock_guard<detail::SpinLock> lock(_slot->lock);
+      // If the other side has already written a newer value, our value is not stored. The other side is still notified
+      // and rejects the value, like a BidirectionalProcessArray would.
+      if(!(versionNumber < _slot->versionNumber)) {
+        if(shouldCopy) {
+          _slot->value = this->accessChannel(0);
+        }
+        else {
+          _slot->value.swap(this->accessChannel(0));
+        }
+        _slot->versionNumber = versionNumber;
+        _slot->dataValidity = TransferElement::dataValidity();
+        _slot->writer = _side;
+      }
+    }
+
+    bool dataNotLost = _slot->notifications[1 - _side].push_overwrite();
+    this->incrementPublishCounter();
+
+    if(detail::isAdapterStatisticsEnabled()) {
+      auto& counters = detail::adapterStatisticsCounters;
+      counters.writes.fetch_add(1, std::memory_order_relaxed);
+      if(!dataNotLost) {
+        counters.dataLost.fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+
+    return !dataNotLost;
+  }
+
+  /*********************************************************************************************************************/
+
+  template<class T>
+  void SharedSlotProcessArray<T>::setPersistentDataStorage(boost::shared_ptr<PersistentDataStorage> storage) {
+    if(!_allowPersistentDataStorage) {
+      throw ChimeraTK::logic_error("This device side of a process array must not be associated with a "
+                                   "persistent data storage.");
+    }
+    bool sendInitialValue = !_persistentDataStorage;
+    _persistentDataStorage = storage;
+    {
+      StartupPhase phase("PersistentDataStorage::registerVariable");
+      _persistentDataStorageID = _persistentDataStorage->registerVariable<T>(
+          ChimeraTK::TransferElement::getName(), ChimeraTK::NDRegisterAccessor<T>::getNumberOfSamples());
+    }
+    if(sendInitialValue) {
+      StartupPhase phase("setPersistentDataStorage initial value write");
+      if(_persistentDataStorage->retrieveValue<T>(_persistentDataStorageID).size() ==
+          ChimeraTK::NDRegisterAccessor<T>::buffer_2D[0].size()) {
+        ChimeraTK::NDRegisterAccessor<T>::buffer_2D[0] =
+            _persistentDataStorage->retrieveValue<T>(_persistentDataStorageID);
+      }
+      doWriteTransfer(VersionNumberBatch::next());
+    }
+  }
+
+  /*********************************************************************************************************************/
+  /*** Implementations of non-member functions below this line *********************************************************/
+  /*********************************************************************************************************************/
+
+  template<class T>
+  std::pair<typename ProcessArray<T>::SharedPtr, typename ProcessArray<T>::SharedPtr> createSharedSlotProcessArray(
+      const std::vector<T>& initialValue, const ChimeraTK::RegisterPath& name, const std::string& unit,
+      const std::string& description, const AccessModeFlags& flags) {
+    auto slot = boost::make_shared<detail::SharedSlot<T>>(initialValue);
+    auto pv1 = boost::make_shared<SharedSlotProcessArray<T>>(slot, 0, name, unit, description, true, flags);
+    auto pv2 = boost::make_shared<SharedSlotProcessArray<T>>(slot, 1, name, unit, description, false, flags);
+    return {pv1, pv2};
+  }
+
+} // namespace ChimeraTK
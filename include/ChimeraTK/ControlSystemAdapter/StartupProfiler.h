@@ -0,0 +1,78 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace ChimeraTK {
+
+  namespace detail {
+
+    /** Global flag if the startup profiling is enabled. Checked with a relaxed load when entering a phase. */
+    extern std::atomic<bool> startupProfilingEnabled; // std::atomic<bool> defaults to false
+
+  } // namespace detail
+
+  /** Globally enable or disable the startup profiling. When enabled, the time spent in the instrumented startup phases
+   *  is accumulated per phase (see StartupPhase). Should be enabled before the application is created. */
+  void setEnableStartupProfiling(bool enable);
+
+  /**
+   * RAII helper recording the wall-clock and CPU time spent in a startup phase. The time between construction and
+   * destruction is added to the phase with the given name, and the count of the phase is incremented. Does nothing
+   * if the startup profiling is disabled when the object is constructed.
+   *
+   * The library itself instruments the application creation by the ApplicationFactory, the process variable
+   * creation, PersistentDataStorage::readFromFile(), the control system side mapping, the registration with the
+   * persistent data storage and the initial value writes. The application's initialise() is profiled if the control
+   * system adapter calls it through ApplicationBase::initialiseProfiled(), as MultiApplicationHost does.
+   *
+   * Phases may be nested, the times of each phase include the times of all phases nested inside. The CPU time is the
+   * CPU time of the calling thread.
+   */
+  class StartupPhase {
+   public:
+    /** The name must be a string literal (or otherwise have static storage duration). */
+    explicit StartupPhase(const char* name);
+    ~StartupPhase();
+
+    StartupPhase(const StartupPhase&) = delete;
+    StartupPhase& operator=(const StartupPhase&) = delete;
+
+   private:
+    const char* _name;
+    int64_t _wallStart{0};
+    int64_t _cpuStart{0};
+  };
+
+  /** Accumulated times of a single startup phase */
+  struct StartupPhaseStatistics {
+    std::string name;
+
+    /** Number of times the phase has been entered */
+    size_t count{0};
+
+    /** Total wall-clock time in seconds */
+    double wallTime{0.};
+
+    /** Total CPU time of the executing thread in seconds */
+    double cpuTime{0.};
+  };
+
+  /** Return the accumulated statistics of all phases, in the order the phases have been entered first. */
+  std::vector<StartupPhaseStatistics> getStartupProfile();
+
+  /** Print a summary table of the startup profile to the given stream. */
+  void printStartupProfile(std::ostream& stream = std::cout);
+
+  /** Write the startup profile as CSV (columns: phase, count, wall time, CPU time) to the given stream. */
+  void writeStartupProfileCsv(std::ostream& stream);
+
+  /** Discard all recorded startup phases. */
+  void clearStartupProfile();
+
+} // namespace ChimeraTK
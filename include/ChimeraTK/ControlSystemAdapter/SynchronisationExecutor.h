@@ -0,0 +1,93 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include <ChimeraTK/RegisterPath.h>
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+namespace ChimeraTK {
+
+  /**
+   * Executes synchronisation functions (see executeSyncronisationFunction() in the requirements document) while
+   * holding the locks of the process variable groups they declare, instead of one lock for all process variables.
+   *
+   * A group corresponds to a "Location" in DOOCS: the business logic can rely on a consistent state of all process
+   * variables of the groups it has locked. Functions locking disjoint groups run concurrently. Functions which only
+   * read the process variables can lock the groups with AccessMode::readOnly, so they run concurrently with other
+   * read-only functions on the same groups.
+   *
+   * Groups are identified by name and created on first use. Process variables can be assigned to groups with
+   * addToGroup(), so control system adapters can lock the groups of the process variable they are accessing with
+   * lockProcessVariables().
+   *
+   * Groups are always locked in the order of their names, so functions declaring overlapping sets of groups cannot
+   * deadlock. Locks are not recursive: a thread holding a lock must not lock any of its groups again.
+   *
+   * The executor of a PV manager is obtained through DevicePVManager::getSynchronisationExecutor() or
+   * ControlSystemPVManager::getSynchronisationExecutor().
+   */
+  class SynchronisationExecutor {
+   public:
+    enum class AccessMode {
+      readWrite, ///< exclusive access to the process variables of the groups
+      readOnly   ///< shared access with other read-only functions
+    };
+
+    /** Locks on a set of groups. The locks are released when the GroupLock is destroyed or unlock() is called. */
+    class GroupLock {
+     public:
+      GroupLock(GroupLock&& other) noexcept;
+      GroupLock& operator=(GroupLock&& other) noexcept;
+      GroupLock(const GroupLock&) = delete;
+      GroupLock& operator=(const GroupLock&) = delete;
+      ~GroupLock() { unlock(); }
+
+      /** Release the locks, in reverse order. */
+      void unlock();
+
+     private:
+      friend class SynchronisationExecutor;
+      GroupLock(std::vector<std::shared_mutex*> mutexes, AccessMode mode) : _mutexes(std::move(mutexes)), _mode(mode) {}
+
+      std::vector<std::shared_mutex*> _mutexes;
+      AccessMode _mode;
+    };
+
+    /** Assign the process variable to the given group. A process variable can be part of several groups. */
+    void addToGroup(const ChimeraTK::RegisterPath& group, const ChimeraTK::RegisterPath& processVariableName);
+
+    /** Return the groups the process variable has been assigned to. */
+    [[nodiscard]] std::vector<ChimeraTK::RegisterPath> getGroups(
+        const ChimeraTK::RegisterPath& processVariableName) const;
+
+    /** Lock the given groups. Blocks until all locks are acquired. */
+    [[nodiscard]] GroupLock lock(
+        const std::vector<ChimeraTK::RegisterPath>& groups, AccessMode mode = AccessMode::readWrite);
+
+    /** Lock all groups of the given process variables. Throws a ChimeraTK::logic_error if a process variable has not
+     *  been assigned to any group. */
+    [[nodiscard]] GroupLock lockProcessVariables(
+        const std::vector<ChimeraTK::RegisterPath>& processVariableNames, AccessMode mode = AccessMode::readWrite);
+
+    /** Execute the synchronisation function while holding the locks of the given groups. */
+    void execute(const std::vector<ChimeraTK::RegisterPath>& groups, const std::function<void()>& function,
+        AccessMode mode = AccessMode::readWrite);
+
+   private:
+    /** Mutex protecting the maps. The group mutexes are never removed, so pointers to them stay valid. */
+    mutable std::shared_mutex _mapMutex;
+
+    /** Mutex of each group. The map is sorted by name, which defines the locking order. */
+    std::map<std::string, std::unique_ptr<std::shared_mutex>> _groupMutexes;
+
+    /** Groups of each process variable */
+    std::map<std::string, std::vector<ChimeraTK::RegisterPath>> _processVariableGroups;
+  };
+
+} // namespace ChimeraTK
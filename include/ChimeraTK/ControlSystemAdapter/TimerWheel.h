@@ -0,0 +1,131 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace ChimeraTK::detail {
+
+  /**
+   * Hashed timer wheel. Timers are sorted into slots by their deadline rounded up to the tick duration, so scheduling
+   * is O(1) and advancing only visits the slots of the elapsed ticks. Deadlines further away than one revolution of
+   * the wheel are supported, they stay in their slot until the right revolution is reached.
+   *
+   * Timers cannot be cancelled. The owner has to ignore expired timers which are no longer relevant.
+   *
+   * The class is not thread safe.
+   */
+  template<typename Payload>
+  class TimerWheel {
+   public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit TimerWheel(Clock::duration tickDuration, size_t nSlots = 512, Clock::time_point start = Clock::now())
+    : _slots(nSlots), _tickDuration(tickDuration), _start(start) {}
+
+    /** Schedule a timer. Deadlines in the past expire with the next tick. */
+    void schedule(Clock::time_point deadline, Payload payload) {
+      auto tick = tickOf(deadline, true);
+      if(tick < _currentTick) {
+        tick = _currentTick;
+      }
+      _slots[tick % _slots.size()].push_back({tick, std::move(payload)});
+      ++_size;
+    }
+
+    /** Expire all timers with a deadline up to now. The callable is called with the payload of each expired timer,
+     *  after all slots have been visited, so it may schedule new timers. */
+    template<typename Callable>
+    void advance(Clock::time_point now, Callable&& onExpiry) {
+      auto targetTick = tickOf(now, false);
+      if(now < _start || targetTick < _currentTick) {
+        return;
+      }
+      // each slot needs to be visited at most once, even if more than one revolution has elapsed
+      auto nTicks = std::min<uint64_t>(targetTick - _currentTick + 1, _slots.size());
+      for(uint64_t i = 0; i < nTicks; ++i) {
+        auto& slot = _slots[(_currentTick + i) % _slots.size()];
+        for(size_t k = 0; k < slot.size();) {
+          if(slot[k].tick <= targetTick) {
+            _expired.push_back(std::move(slot[k].payload));
+            slot[k] = std::move(slot.back());
+            slot.pop_back();
+          }
+          else {
+            ++k;
+          }
+        }
+      }
+      _currentTick = targetTick + 1;
+      _size -= _expired.size();
+      for(auto& payload : _expired) {
+        onExpiry(payload);
+      }
+      _expired.clear();
+    }
+
+    /** Return the deadline (rounded up to the tick) of the earliest pending timer, or nullopt if there is none. */
+    [[nodiscard]] std::optional<Clock::time_point> nextDeadline() const {
+      if(_size == 0) {
+        return std::nullopt;
+      }
+      // the first slot containing a timer of the current revolution has the earliest timer
+      for(uint64_t tick = _currentTick; tick < _currentTick + _slots.size(); ++tick) {
+        for(const auto& entry : _slots[tick % _slots.size()]) {
+          if(entry.tick == tick) {
+            return _start + tick * _tickDuration;
+          }
+        }
+      }
+      // all timers are further away than one revolution
+      uint64_t earliest = UINT64_MAX;
+      for(const auto& slot : _slots) {
+        for(const auto& entry : slot) {
+          earliest = std::min(earliest, entry.tick);
+        }
+      }
+      return _start + earliest * _tickDuration;
+    }
+
+    /** Number of pending timers */
+    [[nodiscard]] size_t size() const { return _size; }
+
+    [[nodiscard]] Clock::duration getTickDuration() const { return _tickDuration; }
+
+   private:
+    struct Entry {
+      uint64_t tick;
+      Payload payload;
+    };
+
+    /** Convert time point into tick number, rounded up or down */
+    [[nodiscard]] uint64_t tickOf(Clock::time_point time, bool roundUp) const {
+      if(time <= _start) {
+        return 0;
+      }
+      auto ticks = static_cast<uint64_t>((time - _start) / _tickDuration);
+      if(roundUp && _start + ticks * _tickDuration < time) {
+        ++ticks;
+      }
+      return ticks;
+    }
+
+    std::vector<std::vector<Entry>> _slots;
+    Clock::duration _tickDuration;
+    Clock::time_point _start;
+
+    /** All ticks before this one have been processed */
+    uint64_t _currentTick{0};
+
+    size_t _size{0};
+
+    /** Buffer for expired payloads, kept to avoid allocations */
+    std::vector<Payload> _expired;
+  };
+
+} // namespace ChimeraTK::detail
@@ -0,0 +1,71 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <ostream>
+#include <string>
+
+namespace ChimeraTK {
+
+  namespace detail {
+
+    /** Global flag if transfer tracing is enabled. Checked with a relaxed load at each tracepoint. */
+    extern std::atomic<bool> transferTracingEnabled; // std::atomic<bool> defaults to false
+
+    /** Name ID returned for names which have not been interned yet. */
+    constexpr uint32_t invalidTraceNameId = std::numeric_limits<uint32_t>::max();
+
+    /** Check whether transfer tracing is currently enabled. */
+    inline bool isTransferTracingEnabled() {
+      return transferTracingEnabled.load(std::memory_order_relaxed);
+    }
+
+    /** Return the current time in nanoseconds as used for the trace events. */
+    int64_t traceClock();
+
+    /** Obtain the ID for the given name. Names are stored once in a global table, so the trace events only need to
+     *  carry the ID. This locks a mutex, so callers should cache the ID. */
+    uint32_t internTraceName(const std::string& name);
+
+    /** Record a complete event ("X" event in the Chrome trace format) which started at the given time and ends now.
+     *  The category and argName must be string literals (or otherwise have static storage duration). Pass nullptr as
+     *  argName if the event has no argument. */
+    void recordTraceComplete(
+        const char* category, uint32_t nameId, int64_t startTime, const char* argName = nullptr, int64_t arg = 0);
+
+    /** Record an instant event ("i" event in the Chrome trace format). Same rules as for recordTraceComplete(). */
+    void recordTraceInstant(const char* category, uint32_t nameId, const char* argName = nullptr, int64_t arg = 0);
+
+  } // namespace detail
+
+  /** Globally enable or disable the transfer tracing. When enabled, the sender write(), the receiver read(), the
+   *  persistence flushes and rejected values of bidirectional process arrays are recorded in per-thread ring buffers.
+   *  Recording is lock-free, each thread only ever writes to its own buffer. */
+  void setEnableTransferTracing(bool enable);
+
+  /** Write all recorded trace events to the given stream in the Chrome trace-event JSON format. The output can be
+   *  loaded into chrome://tracing or https://ui.perfetto.dev. Threads may keep recording events while the dump is
+   *  written, the oldest events of their buffers are then omitted if they are overwritten during the dump. */
+  void writeTransferTrace(std::ostream& stream);
+
+  /** Write all recorded trace events to the given file, see writeTransferTrace(). */
+  void writeTransferTraceToFile(const std::string& fileName);
+
+  /** Set a file name to which the recorded trace events are written when the process exits. Pass an empty string to
+   *  disable writing at exit again. The file is only written at exit if all threads which have recorded events have
+   *  terminated by then, otherwise dumpTransferTrace() must be called before. */
+  void setTransferTraceFileAtExit(const std::string& fileName);
+
+  /** Write the recorded trace events now to the file set with setTransferTraceFileAtExit(), instead of at exit.
+   *  Control system adapters should call this during their shutdown, before the threads of the application are torn
+   *  down. Returns whether the file has been written, which is false if no file name is set or the trace has already
+   *  been written. */
+  bool dumpTransferTrace();
+
+  /** Discard all recorded trace events. */
+  void clearTransferTrace();
+
+} // namespace ChimeraTK
@@ -12,8 +12,11 @@
 
 #include <ChimeraTK/VersionNumber.h>
 
+#include "AdapterStatistics.h"
 #include "PersistentDataStorage.h"
 #include "ProcessArray.h"
+#include "StartupProfiler.h"
+#include "VersionNumberBatch.h"
 
 namespace ChimeraTK {
 
@@ -22,6 +25,72 @@ namespace ChimeraTK {
     /** Global flag if thread safety check shall performed on each read/write. */
     extern std::atomic<bool> processArrayEnableThreadSafetyCheck; // std::atomic<bool> defaults to false
 
+    /** Minimum buffer size in bytes for which huge pages are requested, 0 if disabled. */
+    extern std::atomic<size_t> processArrayHugePageThreshold;
+
+    /** Request transparent huge pages for the part of the given memory range which consists of complete 2 MiB huge
+     *  pages. Does nothing if the range is smaller than the threshold set with setProcessArrayHugePageThreshold() or
+     *  contains no complete huge page. Returns whether the huge page advice has been accepted by the kernel. */
+    bool adviseLargeBuffer(void* data, size_t sizeInBytes);
+
+    /** Convenience overload of adviseLargeBuffer() for the buffers of the process arrays. */
+    template<typename T>
+    bool adviseLargeBuffer(std::vector<T>& buffer) {
+      if(processArrayHugePageThreshold.load(std::memory_order_relaxed) == 0) {
+        return false;
+      }
+      return adviseLargeBuffer(static_cast<void*>(buffer.data()), buffer.size() * sizeof(T));
+    }
+
+  } // namespace detail
+
+  /**
+   * Semantics of a multi-producer process array, see createMultiProducerProcessArray().
+   */
+  enum class MultiProducerOrdering {
+    /** All writes are delivered in the order in which the producers enter the queue. */
+    lastWriterWins,
+
+    /** Writes with a version number older than the last delivered one are discarded. */
+    orderedByVersion
+  };
+
+  namespace detail {
+
+    /**
+     * Minimal spin lock for very short critical sections which never block. Satisfies the Lockable requirements, so
+     * it can be used with std::lock_guard.
+     */
+    class SpinLock {
+     public:
+      void lock() {
+        while(_flag.test_and_set(std::memory_order_acquire)) {
+          std::this_thread::yield();
+        }
+      }
+
+      void unlock() { _flag.clear(std::memory_order_release); }
+
+     private:
+      std::atomic_flag _flag = ATOMIC_FLAG_INIT;
+    };
+
+    /**
+     * State shared by all producers of a multi-producer process array. The queue of a process array is a
+     * single-producer queue, so the producers serialise their push through a spin lock. The critical section only
+     * swaps a buffer into the queue and never blocks, so a spin lock is cheaper than a mutex here.
+     */
+    struct MultiProducerState {
+      explicit MultiProducerState(MultiProducerOrdering ordering_) : ordering(ordering_) {}
+
+      SpinLock lock;
+
+      const MultiProducerOrdering ordering;
+
+      /** Version number of the last value pushed into the queue, protected by the spin lock */
+      VersionNumber lastVersion{nullptr};
+    };
+
   } // namespace detail
 
   /** Globally enable or disable the thread safety check on each read/write. This
@@ -30,6 +99,12 @@ namespace ChimeraTK {
    * This will only have an effect if debug compiler flags are enabled. */
   void setEnableProcessArrayThreadSafetyCheck(bool enable);
 
+  /** Request transparent huge pages for all buffers of process arrays created afterwards which are at least the given
+   * number of bytes large, e.g. camera images or long DAQ traces. This reduces TLB misses. Only the complete 2 MiB
+   * huge pages inside a buffer are advised. A threshold of 0 (the default) disables the feature. The threshold should
+   * be at least twice the huge page size, smaller buffers may not contain any complete huge page. */
+  void setProcessArrayHugePageThreshold(size_t thresholdInBytes);
+
   /**
    * Implementation of the process array that transports data in a single
    * direction. This implementation is used for both sides (sender and
@@ -124,6 +199,13 @@ namespace ChimeraTK {
 
     void interrupt() override { TransferElement::interrupt_impl(_sharedState.queue); }
 
+    /**
+     * Create an additional sender for the same receiver. Each thread writing to a multi-producer process array needs
+     * its own sender. Throws a ChimeraTK::logic_error if this process array has not been created with
+     * createMultiProducerProcessArray().
+     */
+    typename ProcessArray<T>::SharedPtr createAdditionalSender();
+
    private:
     /**
      *  Type for the individual buffers. Each buffer stores a vector, the version
@@ -173,6 +255,7 @@ namespace ChimeraTK {
         for(size_t i = 0; i < numberOfBuffers + 1; ++i) {
           Buffer b0(bufferLength);
           Buffer b1(bufferLength);
+          detail::adviseLargeBuffer(b1.value);
           queue.push(std::move(b0));
           queue.pop(b1); // here the buffer b1 gets swapped into the queue
         }
@@ -182,12 +265,17 @@ namespace ChimeraTK {
       // supports sharing and we have nothing else in our shared state, we do not
       // need to store our share state as a pointer but we can "copy" it and the
       // copies will stay linked.
-      SharedState(const SharedState& other) : queue(other.queue) {}
+      SharedState(const SharedState& other) : queue(other.queue), multiProducerState(other.multiProducerState) {}
 
       /**
        * Queue of buffers transporting the actual values
        */
       cppext::future_queue<Buffer, cppext::SWAP_DATA> queue;
+
+      /**
+       * State shared by all senders, only set for multi-producer process arrays
+       */
+      boost::shared_ptr<detail::MultiProducerState> multiProducerState;
     };
     SharedState _sharedState;
 
@@ -221,6 +309,12 @@ namespace ChimeraTK {
      */
     size_t _persistentDataStorageID{0};
 
+    /**
+     * Start time of the current read operation for the transfer tracing. Zero if tracing was disabled when the read
+     * operation started.
+     */
+    int64_t _traceReadStart{0};
+
     /**
      * Internal implementation of the various {@code send} methods. All these
      * methods basically do the same and only differ in whether the data in the
@@ -267,6 +361,12 @@ namespace ChimeraTK {
             const std::string& unit, const std::string& description, std::size_t numberOfBuffers,
             const AccessModeFlags& flags);
 
+    template<typename U>
+    friend std::pair<typename ProcessArray<U>::SharedPtr, typename ProcessArray<U>::SharedPtr>
+        createMultiProducerProcessArray(const std::vector<U>& initialValue, const ChimeraTK::RegisterPath& name,
+            const std::string& unit, const std::string& description, MultiProducerOrdering ordering,
+            std::size_t numberOfBuffers, const AccessModeFlags& flags);
+
     template<typename U>
     friend class BidirectionalProcessArray;
   };
@@ -347,6 +447,29 @@ namespace ChimeraTK {
       const std::string& description = "", std::size_t numberOfBuffers = 3,
       const AccessModeFlags& flags = {AccessMode::wait_for_new_data});
 
+  /**
+   * Creates a synchronized process array which can be written by several
+   * threads at the same time. Like for createSynchronizedProcessArray(), the
+   * pair's first is a sender and the second is the receiver. Each additional
+   * writing thread obtains its own sender through
+   * UnidirectionalProcessArray::createAdditionalSender(), so no extra
+   * aggregation thread is needed.
+   *
+   * With MultiProducerOrdering::lastWriterWins, all values are delivered in the
+   * order the producers have written them. With
+   * MultiProducerOrdering::orderedByVersion, a write is discarded if a value
+   * with a newer version number has already been written by another producer,
+   * so the receiver sees monotonic version numbers. A discarded write returns
+   * true like a write which has lost data, but it does not update the
+   * persistent data storage and is counted separately from the queue overflows
+   * in the adapter statistics (discardCount).
+   */
+  template<class T>
+  std::pair<typename ProcessArray<T>::SharedPtr, typename ProcessArray<T>::SharedPtr> createMultiProducerProcessArray(
+      const std::vector<T>& initialValue, const ChimeraTK::RegisterPath& name = "", const std::string& unit = "",
+      const std::string& description = "", MultiProducerOrdering ordering = MultiProducerOrdering::lastWriterWins,
+      std::size_t numberOfBuffers = 3, const AccessModeFlags& flags = {AccessMode::wait_for_new_data});
+
   /********************************************************************************************************************/
   /*** Implementations of member functions below this line ************************************************************/
   /********************************************************************************************************************/
@@ -364,6 +487,9 @@ namespace ChimeraTK {
     ChimeraTK::NDRegisterAccessor<T>::buffer_2D[0] = initialValue;
     // Workaround
     _intermedateBuffer.resize( ChimeraTK::NDRegisterAccessor<T>::buffer_2D[0].size() );
+    detail::adviseLargeBuffer(_localBuffer.value);
+    detail::adviseLargeBuffer(ChimeraTK::NDRegisterAccessor<T>::buffer_2D[0]);
+    detail::adviseLargeBuffer(_intermedateBuffer);
     // It would be better to do the validation before initializing, but this
     // would mean that we would have to initialize twice.
     if(!this->isReadable()) {
@@ -408,6 +534,9 @@ namespace ChimeraTK {
     ChimeraTK::NDRegisterAccessor<T>::buffer_2D[0] = receiver->buffer_2D[0];
     // Workaround
     _intermedateBuffer.resize( ChimeraTK::NDRegisterAccessor<T>::buffer_2D[0].size() );
+    detail::adviseLargeBuffer(_localBuffer.value);
+    detail::adviseLargeBuffer(ChimeraTK::NDRegisterAccessor<T>::buffer_2D[0]);
+    detail::adviseLargeBuffer(_intermedateBuffer);
   }
 
   /********************************************************************************************************************/
@@ -417,6 +546,7 @@ namespace ChimeraTK {
     if(!this->isReadable()) {
       throw ChimeraTK::logic_error("Receive operation is only allowed for a receiver process variable.");
     }
+    _traceReadStart = detail::isTransferTracingEnabled() ? detail::traceClock() : 0;
   }
 
   /********************************************************************************************************************/
@@ -489,6 +619,14 @@ namespace ChimeraTK {
       }
       TransferElement::_versionNumber = _localBuffer.versionNumber;
       TransferElement::_dataValidity = _localBuffer.dataValidity;
+      this->publishLatestValue();
+      if(detail::isAdapterStatisticsEnabled()) {
+        detail::adapterStatisticsCounters.reads.fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+    if(_traceReadStart != 0) {
+      detail::recordTraceComplete("read", this->traceNameId(), _traceReadStart, "hasNewData", hasNewData);
+      _traceReadStart = 0;
     }
   }
 
@@ -518,15 +656,19 @@ namespace ChimeraTK {
       sendInitialValue = true;
     }
     _persistentDataStorage = storage;
-    _persistentDataStorageID = _persistentDataStorage->registerVariable<T>(
-        ChimeraTK::TransferElement::getName(), ChimeraTK::NDRegisterAccessor<T>::getNumberOfSamples());
+    {
+      StartupPhase phase("PersistentDataStorage::registerVariable");
+      _persistentDataStorageID = _persistentDataStorage->registerVariable<T>(
+          ChimeraTK::TransferElement::getName(), ChimeraTK::NDRegisterAccessor<T>::getNumberOfSamples());
+    }
     if(sendInitialValue) {
+      StartupPhase phase("setPersistentDataStorage initial value write");
       if(_persistentDataStorage->retrieveValue<T>(_persistentDataStorageID).size() ==
           ChimeraTK::NDRegisterAccessor<T>::buffer_2D[0].size()) {
         ChimeraTK::NDRegisterAccessor<T>::buffer_2D[0] =
             _persistentDataStorage->retrieveValue<T>(_persistentDataStorageID);
       }
-      this->write();
+      this->write(VersionNumberBatch::next());
     }
   }
 
@@ -539,12 +681,7 @@ namespace ChimeraTK {
 
     assert(this->isWriteable());
 
-    // First update the persistent data storage, if any was associated. This
-    // cannot be done after sending, since the value might no longer be available
-    // within this instance.
-    if(_persistentDataStorage) {
-      _persistentDataStorage->updateValue(_persistentDataStorageID, _intermedateBuffer);
-    }
+    int64_t traceStart = detail::isTransferTracingEnabled() ? detail::traceClock() : 0;
 
     // Set time stamp and version number
     _localBuffer.versionNumber = newVersionNumber;
@@ -559,8 +696,52 @@ namespace ChimeraTK {
       _localBuffer.value.swap(_intermedateBuffer);
     }
 
-    // send the data to the queue
-    bool dataNotLost = _sharedState.queue.push_overwrite(std::move(_localBuffer));
+    // Update the persistent data storage, if any was associated, and send the data to the queue. The storage must be
+    // updated before sending, since the value is no longer available within this instance afterwards.
+    bool dataNotLost = true;
+    bool discarded = false;
+    if(_sharedState.multiProducerState) {
+      auto& producers = *_sharedState.multiProducerState;
+      std::lock_guard<detail::SpinLock> lock(producers.lock);
+      if(producers.ordering == MultiProducerOrdering::orderedByVersion && newVersionNumber < producers.lastVersion) {
+        // another producer has already sent a newer value, which must not be replaced in the storage either
+        discarded = true;
+      }
+      else {
+        producers.lastVersion = newVersionNumber;
+        // under the producer lock, so the storage receives the values in the order they are sent
+        if(_persistentDataStorage) {
+          _persistentDataStorage->updateValue(_persistentDataStorageID, _localBuffer.value);
+        }
+        dataNotLost = _sharedState.queue.push_overwrite(std::move(_localBuffer));
+        // all senders share the counter, the producer lock makes them a single writer
+        this->incrementPublishCounter();
+      }
+    }
+    else {
+      if(_persistentDataStorage) {
+        _persistentDataStorage->updateValue(_persistentDataStorageID, _localBuffer.value);
+      }
+      dataNotLost = _sharedState.queue.push_overwrite(std::move(_localBuffer));
+      this->incrementPublishCounter();
+    }
+
+    if(traceStart != 0) {
+      detail::recordTraceComplete(
+          "write", this->traceNameId(), traceStart, discarded ? "discarded" : "dataLost", discarded || !dataNotLost);
+    }
+
+    if(detail::isAdapterStatisticsEnabled()) {
+      auto& counters = detail::adapterStatisticsCounters;
+      counters.writes.fetch_add(1, std::memory_order_relaxed);
+      if(discarded) {
+        counters.discarded.fetch_add(1, std::memory_order_relaxed);
+      }
+      else if(!dataNotLost && _receiver->getAccessModeFlags().has(AccessMode::wait_for_new_data)) {
+        counters.dataLost.fetch_add(1, std::memory_order_relaxed);
+      }
+      detail::updateMaxQueueOccupancy(_sharedState.queue.read_available());
+    }
 
     // if receiver does not have wait_for_new_data, do not return whether data has been lost (because conceptionally it
     // hasn't)
@@ -568,7 +749,22 @@ namespace ChimeraTK {
       return false;
     }
 
-    return !dataNotLost;
+    // a discarded value has never reached the receiver, so it is reported as lost as well
+    return discarded || !dataNotLost;
+  }
+
+  /********************************************************************************************************************/
+
+  template<class T>
+  typename ProcessArray<T>::SharedPtr UnidirectionalProcessArray<T>::createAdditionalSender() {
+    if(!_sharedState.multiProducerState || !_receiver) {
+      throw ChimeraTK::logic_error("Process variable " + this->getName() + " is not the sender of a multi-producer "
+                                   "process array.");
+    }
+    auto sender =
+        boost::make_shared<UnidirectionalProcessArray<T>>(ProcessArray<T>::SENDER, _receiver, this->getAccessModeFlags());
+    sender->setPublishCounter(this->_publishCounter);
+    return sender;
   }
 
   /********************************************************************************************************************/
@@ -608,6 +804,24 @@ namespace ChimeraTK {
     return {sender, receiver};
   }
 
+  /********************************************************************************************************************/
+
+  template<class T>
+  typename std::pair<typename ProcessArray<T>::SharedPtr, typename ProcessArray<T>::SharedPtr>
+      createMultiProducerProcessArray(const std::vector<T>& initialValue, const ChimeraTK::RegisterPath& name,
+          const std::string& unit, const std::string& description, MultiProducerOrdering ordering,
+          std::size_t numberOfBuffers, const AccessModeFlags& flags) {
+    auto receiver = boost::make_shared<UnidirectionalProcessArray<T>>(
+        ProcessArray<T>::RECEIVER, name, unit, description, initialValue, numberOfBuffers, flags);
+    // must be set before the sender copies the shared state
+    receiver->_sharedState.multiProducerState = boost::make_shared<detail::MultiProducerState>(ordering);
+    auto sender = boost::make_shared<UnidirectionalProcessArray<T>>(ProcessArray<T>::SENDER, receiver, flags);
+
+    receiver->_dataValidity = DataValidity::faulty;
+
+    return {sender, receiver};
+  }
+
 } // namespace ChimeraTK
 
 #endif // CHIMERA_TK_CONTROL_SYSTEM_ADAPTER_UNIDIRECTIONAL_PROCESS_ARRAY_H
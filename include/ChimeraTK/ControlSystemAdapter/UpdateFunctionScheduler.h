@@ -0,0 +1,149 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include "SynchronisationExecutor.h"
+#include "TimerWheel.h"
+
+#include <ChimeraTK/RegisterPath.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ChimeraTK {
+
+  /**
+   * Scheduler for the periodicUpdateFunction() and triggeredUpdateFunction() callbacks described in the requirements
+   * document. Instead of one sleeping thread per cyclic task, one timer thread releases all registered functions
+   * through a timer wheel and a small pool of worker threads executes them.
+   *
+   * Periodic functions are released at fixed points in time (start time plus multiples of the period), so they do not
+   * drift. If a function is still queued or running when its next release is due, the release is skipped and counted
+   * as deadline miss. Triggered functions are queued by trigger(). Triggers arriving while the function is queued are
+   * merged, triggers arriving while it is running cause one more execution afterwards.
+   *
+   * For each function, statistics are collected: the jitter (delay between the release and the start of the
+   * execution, which includes the rounding to the timer resolution), the execution time (including the time waiting
+   * for the locks of the synchronisation groups) and the number of deadline misses. The deadline of a periodic function
+   * is its next release, triggered functions can be given a deadline relative to the trigger.
+   *
+   * If a SynchronisationExecutor is passed to the constructor, functions can declare the synchronisation groups they
+   * access. The groups are locked while the function is executed.
+   *
+   * A function is never executed concurrently with itself, but different functions run concurrently on the worker
+   * threads. Exceptions thrown by functions are printed and otherwise ignored.
+   */
+  class UpdateFunctionScheduler {
+   public:
+    using Clock = std::chrono::steady_clock;
+    using FunctionId = size_t;
+
+    /** Statistics of one function */
+    struct Statistics {
+      /** Number of completed executions */
+      uint64_t nExecutions{0};
+
+      /** Number of executions which have not completed before their deadline, plus skipped periodic releases */
+      uint64_t nDeadlineMisses{0};
+
+      /** Maximum and sum of the delay between release and start of the executions */
+      std::chrono::nanoseconds maxJitter{0};
+      std::chrono::nanoseconds totalJitter{0};
+
+      /** Maximum execution time */
+      std::chrono::nanoseconds maxDuration{0};
+
+      [[nodiscard]] std::chrono::nanoseconds meanJitter() const {
+        return nExecutions > 0 ? totalJitter / static_cast<int64_t>(nExecutions) : std::chrono::nanoseconds(0);
+      }
+    };
+
+    /**
+     * Start the timer thread and the given number of worker threads. The timer resolution is the tick duration of
+     * the timer wheel. Groups passed to addPeriodicFunction() and addTriggeredFunction() are locked with the given
+     * executor, which must outlive the scheduler.
+     */
+    explicit UpdateFunctionScheduler(size_t nWorkers = 2,
+        std::chrono::microseconds resolution = std::chrono::microseconds(1000),
+        SynchronisationExecutor* executor = nullptr);
+
+    /** Stop all threads. Running functions are completed, queued ones are discarded. */
+    ~UpdateFunctionScheduler();
+
+    UpdateFunctionScheduler(const UpdateFunctionScheduler&) = delete;
+    UpdateFunctionScheduler& operator=(const UpdateFunctionScheduler&) = delete;
+
+    /** Register a function which is executed with the given period, first one period from now. */
+    FunctionId addPeriodicFunction(Clock::duration period, std::function<void()> function,
+        std::vector<ChimeraTK::RegisterPath> groups = {});
+
+    /** Register a function which is executed after each trigger(). If the deadline is not zero, executions completing
+     *  later than the deadline after the trigger are counted as deadline misses. */
+    FunctionId addTriggeredFunction(std::function<void()> function, Clock::duration deadline = Clock::duration::zero(),
+        std::vector<ChimeraTK::RegisterPath> groups = {});
+
+    /** Queue the execution of a triggered function. Throws a ChimeraTK::logic_error for unknown or periodic
+     *  functions. */
+    void trigger(FunctionId id);
+
+    /** Remove the function. Waits until a running execution is completed, so it must not be called from within the
+     *  function itself. Throws a ChimeraTK::logic_error for unknown functions. */
+    void removeFunction(FunctionId id);
+
+    /** Return the statistics of the function. Throws a ChimeraTK::logic_error for unknown functions. */
+    [[nodiscard]] Statistics getStatistics(FunctionId id) const;
+
+   private:
+    struct Function {
+      std::function<void()> function;
+      std::vector<ChimeraTK::RegisterPath> groups;
+      Clock::duration period{};   // zero for triggered functions
+      Clock::duration deadline{}; // relative to the release, zero for none
+      Clock::time_point nextRelease;
+      bool queued{false};
+      bool running{false};
+      bool retrigger{false};
+      bool removed{false};
+      Clock::time_point retriggerTime;
+      Statistics statistics;
+    };
+
+    struct Job {
+      std::shared_ptr<Function> function;
+      Clock::time_point release;
+    };
+
+    void timerThreadFunction();
+    void workerThreadFunction();
+
+    /** Queue the function for execution. _mutex must be held. */
+    void enqueue(const std::shared_ptr<Function>& function, Clock::time_point release);
+
+    /** Return the function with the given id or throw. _mutex must be held. */
+    [[nodiscard]] const std::shared_ptr<Function>& getFunction(FunctionId id) const;
+
+    SynchronisationExecutor* _executor;
+
+    mutable std::mutex _mutex;
+    std::condition_variable _timerCondition;
+    std::condition_variable _workerCondition;
+    std::condition_variable _idleCondition;
+    bool _shutdown{false};
+
+    std::map<FunctionId, std::shared_ptr<Function>> _functions;
+    FunctionId _nextId{0};
+    detail::TimerWheel<FunctionId> _timerWheel;
+    std::deque<Job> _queue;
+
+    std::thread _timerThread;
+    std::vector<std::thread> _workerThreads;
+  };
+
+} // namespace ChimeraTK
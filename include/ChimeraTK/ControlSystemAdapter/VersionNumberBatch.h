@@ -0,0 +1,61 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include <ChimeraTK/VersionNumber.h>
+
+namespace ChimeraTK {
+
+  /**
+   * Scope in which all bulk writes of the calling thread share one version number.
+   *
+   * Creating a ChimeraTK::VersionNumber increments a global atomic counter and reads the clock. When many threads write
+   * many process variables, this becomes a contended hot spot. Inside a VersionNumberBatch, the version number is
+   * allocated once when the outermost batch of the thread is created, and all writes which obtain their version number
+   * through VersionNumberBatch::next() use it. Version numbers stay globally ordered, since each batch still allocates
+   * a regular version number.
+   *
+   * The adapter opens a batch for its internal bulk writes (DevicePVManager::publishDirty(),
+   * DeviceSynchronizationUtility::sendAll(), DevicePVManager::publishInitialValues(), the initial values sent when
+   * attaching the persistent data storage and the adapter statistics). A write() without a version number does not
+   * take part in the batch, since its default VersionNumber is created by DeviceAccess. Callers must pass
+   * getVersionNumber() or VersionNumberBatch::next() explicitly:
+   *
+   * \code
+   * {
+   *   VersionNumberBatch batch;
+   *   for(auto& pv : outputs) pv->write(batch.getVersionNumber());
+   * }
+   * \endcode
+   *
+   * Batches can be nested, inner batches share the version number of the outermost batch. Since all writes inside a
+   * batch have the same version number, a batch must not span logically distinct updates, e.g. a loop writing the same
+   * process variable in each iteration.
+   */
+  class VersionNumberBatch {
+   public:
+    VersionNumberBatch();
+    ~VersionNumberBatch();
+
+    VersionNumberBatch(const VersionNumberBatch&) = delete;
+    VersionNumberBatch& operator=(const VersionNumberBatch&) = delete;
+
+    /** Return the version number shared by this batch. */
+    [[nodiscard]] const VersionNumber& getVersionNumber() const { return _outermost->_versionNumber; }
+
+    /** Return the version number of the current batch of the calling thread, or a new version number if there is no
+     *  batch in the calling thread. */
+    [[nodiscard]] static VersionNumber next();
+
+    /** Check whether there is a batch in the calling thread. */
+    [[nodiscard]] static bool isActive();
+
+   private:
+    /** Version number of this batch, only used if this is the outermost batch */
+    VersionNumber _versionNumber{nullptr};
+
+    /** The outermost batch of the thread, which may be this */
+    VersionNumberBatch* _outermost;
+  };
+
+} // namespace ChimeraTK
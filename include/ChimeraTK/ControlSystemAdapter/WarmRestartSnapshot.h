@@ -0,0 +1,58 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace ChimeraTK {
+
+  class ControlSystemPVManager;
+  class DevicePVManager;
+
+  /**
+   * Snapshot of the values of all device to control system process variables, used for warm restarts. The
+   * PersistentDataStorage only covers control system to device variables, so after a restart the device to control
+   * system variables would stay at their initial values until the application has written them again.
+   *
+   * The control system adapter calls save() at shutdown (and optionally periodically) with the values it has received,
+   * including version time stamps and data validity. After the next start, restore() republishes these values through
+   * the device side, which must be done after ApplicationBase::initialise() and before ApplicationBase::run(). Clients
+   * then see the last known state right away, the application overwrites it as soon as it writes the variables.
+   *
+   * The file is written through a memory mapping into a temporary file, which then replaces the previous snapshot, so
+   * an interrupted save never leaves a corrupt snapshot behind. The format is binary and only meant to be read on the
+   * same machine.
+   */
+  class WarmRestartSnapshot {
+   public:
+    /** Use the given snapshot file. Nothing is read or written by the constructor. */
+    explicit WarmRestartSnapshot(std::string fileName);
+
+    /** Return the default file name for the given application, "<applicationName>.snapshot" */
+    static std::string getDefaultFileName(const std::string& applicationName) { return applicationName + ".snapshot"; }
+
+    /**
+     * Save the current values of all device to control system process variables of the given PV manager. Variables
+     * which have not received a value yet are not saved. Must be called from the thread reading the process variables.
+     * Throws std::system_error if the file cannot be written.
+     */
+    void save(const ControlSystemPVManager& pvManager);
+
+    /**
+     * Write the values stored in the snapshot file to the device side of the process variables, with the data
+     * validity and the time stamp of the saved version. The data validity set on the device side by the application is
+     * kept for its own writes. Variables which no longer exist or have changed their type or size are skipped. Returns
+     * the number of restored variables, which is zero if there is no snapshot file.
+     *
+     * Throws std::system_error if the file cannot be read and ChimeraTK::runtime_error if it is corrupt.
+     */
+    size_t restore(DevicePVManager& pvManager);
+
+    [[nodiscard]] const std::string& getFileName() const { return _fileName; }
+
+   private:
+    std::string _fileName;
+  };
+
+} // namespace ChimeraTK
@@ -0,0 +1,307 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+/*
+ * Python bindings for the control system and device side of the ControlSystemAdapter. Process arrays return copies of
+ * their user buffer as NumPy arrays. A view without copying is available as explicitly unsafe accessor, since the user
+ * buffer is exchanged with the queue on transfers. Only numeric user types are supported.
+ */
+
+#include <ChimeraTK/ControlSystemAdapter/ControlSystemPVManager.h>
+#include <ChimeraTK/ControlSystemAdapter/DevicePVManager.h>
+#include <ChimeraTK/ControlSystemAdapter/ProcessArray.h>
+
+#include <boost/thread/exceptions.hpp>
+
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+#include <cstring>
+#include <optional>
+#include <variant>
+
+namespace py = pybind11;
+
+PYBIND11_DECLARE_HOLDER_TYPE(T, boost::shared_ptr<T>)
+
+namespace ChimeraTK::Python {
+
+  /*********************************************************************************************************************/
+
+  /** All user types which can be represented as NumPy dtype */
+  template<typename... T>
+  struct TypeList {
+    using Variant = std::variant<typename ProcessArray<T>::SharedPtr...>;
+  };
+  using NumericTypes =
+      TypeList<int8_t, uint8_t, int16_t, uint16_t, int32_t, uint32_t, int64_t, uint64_t, float, double>;
+
+  /** User type of a ProcessArray<T>::SharedPtr */
+  template<typename SharedPtr>
+  struct UserTypeOf;
+
+  template<typename T>
+  struct UserTypeOf<boost::shared_ptr<ProcessArray<T>>> {
+    using type = T;
+  };
+
+  /*********************************************************************************************************************/
+
+  /**
+   * Type-erased process array. The typed accessor is kept in a variant, so the buffer can be exposed with the matching
+   * NumPy dtype.
+   */
+  class PyProcessArray {
+   public:
+    explicit PyProcessArray(NumericTypes::Variant array) : _array(std::move(array)) {}
+
+    /** Wrap the process variable. Throws a ChimeraTK::logic_error if the user type is not numeric. */
+    static PyProcessArray fromProcessVariable(const ProcessVariable::SharedPtr& pv) {
+      auto result = fromProcessVariableImpl(pv);
+      if(!result) {
+        throw ChimeraTK::logic_error("Process variable '" + pv->getName() + "' has a user type which is not supported "
+            "by the Python bindings.");
+      }
+      return *result;
+    }
+
+    [[nodiscard]] ProcessVariable& element() const {
+      return std::visit([](auto& array) -> ProcessVariable& { return *array; }, _array);
+    }
+
+    /** Number of elements of the user buffer */
+    [[nodiscard]] size_t size() const {
+      return std::visit([](auto& array) { return array->accessChannel(0).size(); }, _array);
+    }
+
+    /** Read-only NumPy array with a copy of the user buffer. It is read-only, so an attempt to modify the buffer
+     *  through it fails instead of silently modifying the copy. */
+    [[nodiscard]] py::array copy() const {
+      return std::visit(
+          [](auto& array) -> py::array {
+            using UserType = typename UserTypeOf<std::decay_t<decltype(array)>>::type;
+            auto& buffer = array->accessChannel(0);
+            // without a base object, the data is copied
+            py::array_t<UserType> result(static_cast<py::ssize_t>(buffer.size()), buffer.data());
+            result.attr("setflags")(py::arg("write") = false);
+            return result;
+          },
+          _array);
+    }
+
+    /** NumPy array viewing the user buffer. The view keeps the owner alive through its base object, but not the
+     *  buffer: read() exchanges the buffer with one of the queue, which is filled by the sender in another thread. */
+    [[nodiscard]] py::array unsafeView(const py::object& owner) const {
+      return std::visit(
+          [&](auto& array) -> py::array {
+            using UserType = typename UserTypeOf<std::decay_t<decltype(array)>>::type;
+            auto& buffer = array->accessChannel(0);
+            py::array_t<UserType> result(static_cast<py::ssize_t>(buffer.size()), buffer.data(), owner);
+            if(!array->isWriteable()) {
+              result.attr("setflags")(py::arg("write") = false);
+            }
+            return result;
+          },
+          _array);
+    }
+
+    /** Copy the given values into the user buffer. Values are converted to the user type like numpy.asarray() does. */
+    void assign(const py::object& values) const {
+      std::visit(
+          [&](auto& array) {
+            using UserType = typename UserTypeOf<std::decay_t<decltype(array)>>::type;
+            auto converted = py::array_t<UserType, py::array::c_style | py::array::forcecast>::ensure(values);
+            if(!converted) {
+              throw py::type_error("Cannot convert the values to the user type of the process array.");
+            }
+            auto& buffer = array->accessChannel(0);
+            if(static_cast<size_t>(converted.size()) != buffer.size()) {
+              throw py::value_error("Expected " + std::to_string(buffer.size()) + " values but got " +
+                  std::to_string(converted.size()) + ".");
+            }
+            std::memcpy(buffer.data(), converted.data(), buffer.size() * sizeof(UserType));
+          },
+          _array);
+    }
+
+    [[nodiscard]] py::dtype dtype() const {
+      return std::visit(
+          [](auto& array) {
+            using UserType = typename UserTypeOf<std::decay_t<decltype(array)>>::type;
+            return py::dtype::of<UserType>();
+          },
+          _array);
+    }
+
+   private:
+    template<size_t index = 0>
+    static std::optional<PyProcessArray> fromProcessVariableImpl(const ProcessVariable::SharedPtr& pv) {
+      if constexpr(index < std::variant_size_v<NumericTypes::Variant>) {
+        using SharedPtr = std::variant_alternative_t<index, NumericTypes::Variant>;
+        using UserType = typename UserTypeOf<SharedPtr>::type;
+        if(auto array = boost::dynamic_pointer_cast<ProcessArray<UserType>>(pv)) {
+          return PyProcessArray(array);
+        }
+        return fromProcessVariableImpl<index + 1>(pv);
+      }
+      else {
+        return std::nullopt;
+      }
+    }
+
+    NumericTypes::Variant _array;
+  };
+
+  /*********************************************************************************************************************/
+
+  /** Create a process array with the user type given by the NumPy dtype (or anything numpy.dtype() accepts) */
+  template<size_t index = 0>
+  PyProcessArray createProcessArray(DevicePVManager& manager, SynchronizationDirection direction,
+      const std::string& name, size_t size, const py::object& type, const std::string& unit,
+      const std::string& description, size_t numberOfBuffers) {
+    auto dtype = py::dtype::from_args(type);
+    if constexpr(index < std::variant_size_v<NumericTypes::Variant>) {
+      using SharedPtr = std::variant_alternative_t<index, NumericTypes::Variant>;
+      using UserType = typename UserTypeOf<SharedPtr>::type;
+      if(dtype.equal(py::dtype::of<UserType>())) {
+        return PyProcessArray(manager.createProcessArray<UserType>(
+            direction, name, size, unit, description, UserType(), numberOfBuffers));
+      }
+      return createProcessArray<index + 1>(manager, direction, name, size, type, unit, description, numberOfBuffers);
+    }
+    else {
+      throw py::type_error("Unsupported dtype " + py::str(dtype).cast<std::string>() + " for process array '" + name +
+          "'.");
+    }
+  }
+
+  /*********************************************************************************************************************/
+
+  template<typename Manager>
+  py::list getAllProcessArrays(const Manager& manager) {
+    py::list result;
+    for(auto& pv : manager.getAllProcessVariables()) {
+      try {
+        result.append(PyProcessArray::fromProcessVariable(pv));
+      }
+      catch(ChimeraTK::logic_error&) {
+        // non-numeric user types are skipped
+      }
+    }
+    return result;
+  }
+
+  /*********************************************************************************************************************/
+
+} // namespace ChimeraTK::Python
+
+/*********************************************************************************************************************/
+
+PYBIND11_MODULE(controlsystemadapter, m) {
+  using namespace ChimeraTK;
+  using namespace ChimeraTK::Python;
+
+  m.doc() = "Python bindings for the ChimeraTK ControlSystemAdapter. pv.value and numpy.asarray(pv) return copies of "
+            "the user buffer, pv.unsafeView() a view without copying.";
+
+  // read() throws boost::thread_interrupted after interrupt() has been called
+  py::register_exception_translator([](std::exception_ptr p) {
+    try {
+      if(p) {
+        std::rethrow_exception(p);
+      }
+    }
+    catch(boost::thread_interrupted&) {
+      PyErr_SetString(PyExc_InterruptedError, "Transfer has been interrupted.");
+    }
+  });
+
+  py::enum_<SynchronizationDirection>(m, "SynchronizationDirection")
+      .value("controlSystemToDevice", SynchronizationDirection::controlSystemToDevice)
+      .value("deviceToControlSystem", SynchronizationDirection::deviceToControlSystem)
+      .value("bidirectional", SynchronizationDirection::bidirectional);
+
+  py::class_<PyProcessArray>(m, "ProcessArray",
+      "Numeric process array. The values are accessed as copies through value, or without copying through "
+      "unsafeView().")
+      .def_property(
+          "value", &PyProcessArray::copy, [](PyProcessArray& self, const py::object& values) { self.assign(values); },
+          "Read-only NumPy array with a copy of the user buffer. Assigning copies the values into the buffer.")
+      .def(
+          "__array__",
+          [](PyProcessArray& self, const py::object& dtype, const py::object&) -> py::object {
+            auto result = self.copy();
+            return dtype.is_none() ? py::object(result) : result.attr("astype")(dtype);
+          },
+          py::arg("dtype") = py::none(), py::arg("copy") = py::none(),
+          "Copy of the user buffer, used by numpy.asarray(). A copy is always returned.")
+      .def(
+          "unsafeView", [](py::object self) { return self.cast<PyProcessArray&>().unsafeView(self); },
+          "NumPy view of the user buffer without copying. The user buffer is exchanged with the queue on each read(), "
+          "so the view must not be used after the next read() (or readNonBlocking() etc.): it then aliases a buffer "
+          "which the sender fills concurrently. Writing into the view before write() is safe.")
+      .def_property_readonly("dtype", &PyProcessArray::dtype)
+      .def_property_readonly("name", [](PyProcessArray& self) { return std::string(self.element().getName()); })
+      .def_property_readonly("unit", [](PyProcessArray& self) { return self.element().getUnit(); })
+      .def_property_readonly("description", [](PyProcessArray& self) { return self.element().getDescription(); })
+      .def("__len__", &PyProcessArray::size)
+      .def("isReadable", [](PyProcessArray& self) { return self.element().isReadable(); })
+      .def("isWriteable", [](PyProcessArray& self) { return self.element().isWriteable(); })
+      .def("isValid", [](PyProcessArray& self) { return self.element().dataValidity() == DataValidity::ok; })
+      .def(
+          "read", [](PyProcessArray& self) { self.element().read(); }, py::call_guard<py::gil_scoped_release>(),
+          "Block until a new value has been received. The GIL is released while waiting, interrupt() unblocks the "
+          "read with an InterruptedError.")
+      .def(
+          "readNonBlocking", [](PyProcessArray& self) { return self.element().readNonBlocking(); },
+          py::call_guard<py::gil_scoped_release>())
+      .def(
+          "readLatest", [](PyProcessArray& self) { return self.element().readLatest(); },
+          py::call_guard<py::gil_scoped_release>())
+      .def(
+          "write",
+          [](PyProcessArray& self, const py::object& values) {
+            if(!values.is_none()) {
+              self.assign(values);
+            }
+            py::gil_scoped_release release;
+            return self.element().write();
+          },
+          py::arg("values") = py::none(),
+          "Send the user buffer, optionally after copying the given values into it. Returns whether data has been "
+          "lost.")
+      .def(
+          "interrupt", [](PyProcessArray& self) { self.element().interrupt(); },
+          "Unblock a read() waiting in another thread.");
+
+  py::class_<ControlSystemPVManager, boost::shared_ptr<ControlSystemPVManager>>(m, "ControlSystemPVManager")
+      .def(
+          "getProcessArray",
+          [](ControlSystemPVManager& self, const std::string& name) {
+            return PyProcessArray::fromProcessVariable(self.getProcessVariable(name));
+          },
+          py::arg("name"))
+      .def("hasProcessVariable",
+          [](ControlSystemPVManager& self, const std::string& name) { return self.hasProcessVariable(name); })
+      .def("getAllProcessArrays", &getAllProcessArrays<ControlSystemPVManager>,
+          "All process arrays with numeric user type.");
+
+  py::class_<DevicePVManager, boost::shared_ptr<DevicePVManager>>(m, "DevicePVManager")
+      .def("createProcessArray", &createProcessArray<>, py::arg("direction"), py::arg("name"), py::arg("size"),
+          py::arg("dtype"), py::arg("unit") = std::string(TransferElement::unitNotSet), py::arg("description") = "",
+          py::arg("numberOfBuffers") = 3)
+      .def(
+          "getProcessArray",
+          [](DevicePVManager& self, const std::string& name) {
+            return PyProcessArray::fromProcessVariable(self.getProcessVariable(name));
+          },
+          py::arg("name"))
+      .def("hasProcessVariable",
+          [](DevicePVManager& self, const std::string& name) { return self.hasProcessVariable(name); })
+      .def("getAllProcessArrays", &getAllProcessArrays<DevicePVManager>, "All process arrays with numeric user type.")
+      .def("getSubManager",
+          [](DevicePVManager& self, const std::string& prefix) { return self.getSubManager(prefix); });
+
+  m.def("createPVManager", &createPVManager, "Create a pair of (ControlSystemPVManager, DevicePVManager).");
+}
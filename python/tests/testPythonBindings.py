@@ -0,0 +1,110 @@
+#!/usr/bin/env python3
+# SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+# SPDX-License-Identifier: LGPL-3.0-or-later
+
+import threading
+import unittest
+
+import numpy as np
+
+import controlsystemadapter as csa
+
+
+class TestPythonBindings(unittest.TestCase):
+
+    def setUp(self):
+        self.csManager, self.devManager = csa.createPVManager()
+
+    def testZeroCopyTransfer(self):
+        devArray = self.devManager.createProcessArray(
+            csa.SynchronizationDirection.deviceToControlSystem, "/array", 8, np.int32, "mV", "some array")
+        csArray = self.csManager.getProcessArray("/array")
+        self.assertEqual(csArray.dtype, np.dtype(np.int32))
+        self.assertEqual(csArray.unit, "mV")
+        self.assertEqual(len(csArray), 8)
+        self.assertTrue(csArray.isReadable())
+        self.assertFalse(csArray.isWriteable())
+
+        # writing through the view modifies the user buffer
+        view = devArray.unsafeView()
+        view[:] = np.arange(8)
+        self.assertTrue(np.shares_memory(view, devArray.unsafeView()))
+        devArray.write()
+
+        self.assertTrue(csArray.readNonBlocking())
+        np.testing.assert_array_equal(csArray.value, np.arange(8))
+        self.assertFalse(csArray.unsafeView().flags.writeable)
+
+    def testValueIsCopy(self):
+        devArray = self.devManager.createProcessArray(
+            csa.SynchronizationDirection.deviceToControlSystem, "/array", 4, np.int32)
+        csArray = self.csManager.getProcessArray("/array")
+
+        devArray.write([1, 2, 3, 4])
+        self.assertTrue(csArray.readNonBlocking())
+        value = csArray.value
+        self.assertFalse(np.shares_memory(value, csArray.unsafeView()))
+        # the copy is read-only, so it cannot be mistaken for the user buffer
+        self.assertFalse(devArray.value.flags.writeable)
+        with self.assertRaises(ValueError):
+            devArray.value[0] = 5
+
+        # the copy keeps its content when the buffer is exchanged by the next read
+        devArray.write([5, 6, 7, 8])
+        self.assertTrue(csArray.readNonBlocking())
+        np.testing.assert_array_equal(value, [1, 2, 3, 4])
+        np.testing.assert_array_equal(np.asarray(csArray), [5, 6, 7, 8])
+        self.assertEqual(np.asarray(csArray, dtype=np.float64).dtype, np.dtype(np.float64))
+
+        # values can also be passed to write(), they are converted to the user type
+        devArray.write([1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0])
+        self.assertTrue(csArray.readLatest())
+        np.testing.assert_array_equal(np.asarray(csArray), np.arange(1, 9))
+
+        with self.assertRaises(ValueError):
+            devArray.write([1, 2, 3])
+
+    def testBlockingReadReleasesGil(self):
+        self.assertFalse(self.csManager.hasProcessVariable("/input"))
+        devArray = self.devManager.createProcessArray(
+            csa.SynchronizationDirection.controlSystemToDevice, "/input", 4, "float64")
+        csArray = self.csManager.getProcessArray("/input")
+
+        received = []
+
+        def reader():
+            devArray.read()
+            received.append(devArray.value.copy())
+
+        thread = threading.Thread(target=reader)
+        thread.start()
+        # the main thread keeps running Python code while the reader is blocked
+        csArray.write(np.full(4, 2.5))
+        thread.join(5)
+        self.assertFalse(thread.is_alive())
+        np.testing.assert_array_equal(received[0], np.full(4, 2.5))
+
+        # interrupt() unblocks a read
+        def interruptedReader():
+            with self.assertRaises(InterruptedError):
+                devArray.read()
+
+        thread = threading.Thread(target=interruptedReader)
+        thread.start()
+        devArray.interrupt()
+        thread.join(5)
+        self.assertFalse(thread.is_alive())
+
+    def testGetAllProcessArrays(self):
+        self.devManager.createProcessArray(csa.SynchronizationDirection.deviceToControlSystem, "/a", 1, np.uint8)
+        self.devManager.createProcessArray(csa.SynchronizationDirection.deviceToControlSystem, "/b", 2, np.float32)
+        names = sorted(pv.name for pv in self.csManager.getAllProcessArrays())
+        self.assertEqual(names, ["/a", "/b"])
+
+        with self.assertRaises(TypeError):
+            self.devManager.createProcessArray(
+                csa.SynchronizationDirection.deviceToControlSystem, "/c", 1, np.complex64)
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,143 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "AdapterStatistics.h"
+
+#include "DevicePVManager.h"
+#include "VersionNumberBatch.h"
+
+#include <unistd.h>
+
+#include <fstream>
+#include <mutex>
+
+namespace ChimeraTK {
+
+  namespace detail {
+    std::atomic<bool> adapterStatisticsEnabled;
+    thread_local bool adapterStatisticsSuppressedInThread{false};
+    AdapterStatisticsCounters adapterStatisticsCounters;
+  } // namespace detail
+
+  namespace {
+    /** Number of existing publishers, adapterStatisticsEnabled is set while it is not zero */
+    size_t nStatisticsPublishers{0};
+    std::mutex nStatisticsPublishersMutex;
+  } // namespace
+
+  /*********************************************************************************************************************/
+
+  StatisticsPublisher::StatisticsPublisher(
+      DevicePVManager& pvManager, const RegisterPath& prefix, std::chrono::milliseconds interval)
+  : _interval(interval) {
+    if(interval.count() <= 0) {
+      throw ChimeraTK::logic_error("The update interval of the adapter statistics must be positive.");
+    }
+    auto d2cs = SynchronizationDirection::deviceToControlSystem;
+    _writesPerSecond = pvManager.createProcessArray<double>(
+        d2cs, prefix / "writesPerSecond", 1, "1/s", "Write operations of all process variables per second");
+    _readsPerSecond = pvManager.createProcessArray<double>(
+        d2cs, prefix / "readsPerSecond", 1, "1/s", "Read operations with new data of all process variables per second");
+    _dataLossCount = pvManager.createProcessArray<uint64_t>(
+        d2cs, prefix / "dataLossCount", 1, "", "Total number of values lost due to full queues");
+    _discardCount = pvManager.createProcessArray<uint64_t>(d2cs, prefix / "discardCount", 1, "",
+        "Total number of values discarded because another producer had already sent a newer version");
+    _maxQueueOccupancy = pvManager.createProcessArray<uint32_t>(d2cs, prefix / "maxQueueOccupancy", 1, "",
+        "Maximum number of values queued in any process variable during the last interval");
+    _persistenceFlushDuration = pvManager.createProcessArray<double>(
+        d2cs, prefix / "persistenceFlushDuration", 1, "ms", "Duration of the last persistency file write");
+    _persistenceFileSize = pvManager.createProcessArray<uint64_t>(
+        d2cs, prefix / "persistenceFileSize", 1, "bytes", "Size of the persistency file");
+    _residentMemory = pvManager.createProcessArray<uint64_t>(
+        d2cs, prefix / "residentMemory", 1, "bytes", "Resident set size of the process");
+
+    _lastWrites = detail::adapterStatisticsCounters.writes.load(std::memory_order_relaxed);
+    _lastReads = detail::adapterStatisticsCounters.reads.load(std::memory_order_relaxed);
+
+    _publisherThread = boost::thread([this] { this->publisherThreadFunction(); });
+
+    std::lock_guard<std::mutex> lock(nStatisticsPublishersMutex);
+    if(nStatisticsPublishers++ == 0) {
+      detail::adapterStatisticsEnabled = true;
+    }
+  }
+
+  /*********************************************************************************************************************/
+
+  StatisticsPublisher::~StatisticsPublisher() {
+    {
+      std::lock_guard<std::mutex> lock(nStatisticsPublishersMutex);
+      if(--nStatisticsPublishers == 0) {
+        detail::adapterStatisticsEnabled = false;
+      }
+    }
+    try {
+      _publisherThread.interrupt();
+      _publisherThread.join();
+    }
+    catch(...) {
+      std::cerr << "Cannot join statistics publisher thread!" << std::endl;
+    }
+  }
+
+  /*********************************************************************************************************************/
+
+  void StatisticsPublisher::publisherThreadFunction() {
+    detail::adapterStatisticsSuppressedInThread = true;
+    auto lastUpdate = std::chrono::steady_clock::now();
+    while(true) {
+      boost::this_thread::sleep_for(boost::chrono::milliseconds(_interval.count()));
+      auto now = std::chrono::steady_clock::now();
+      publish(std::chrono::duration<double>(now - lastUpdate).count());
+      lastUpdate = now;
+    }
+  }
+
+  /*********************************************************************************************************************/
+
+  void StatisticsPublisher::publish(double secondsSinceLastUpdate) {
+    auto& counters = detail::adapterStatisticsCounters;
+
+    auto writes = counters.writes.load(std::memory_order_relaxed);
+    auto reads = counters.reads.load(std::memory_order_relaxed);
+    _writesPerSecond->accessData(0) = static_cast<double>(writes - _lastWrites) / secondsSinceLastUpdate;
+    _readsPerSecond->accessData(0) = static_cast<double>(reads - _lastReads) / secondsSinceLastUpdate;
+    _lastWrites = writes;
+    _lastReads = reads;
+
+    _dataLossCount->accessData(0) = counters.dataLost.load(std::memory_order_relaxed);
+    _discardCount->accessData(0) = counters.discarded.load(std::memory_order_relaxed);
+    _maxQueueOccupancy->accessData(0) =
+        static_cast<uint32_t>(counters.maxQueueOccupancy.exchange(0, std::memory_order_relaxed));
+    _persistenceFlushDuration->accessData(0) =
+        static_cast<double>(counters.persistenceFlushDuration.load(std::memory_order_relaxed)) / 1e6;
+    _persistenceFileSize->accessData(0) = counters.persistenceFileSize.load(std::memory_order_relaxed);
+    _residentMemory->accessData(0) = getResidentMemory();
+
+    // all values belong to the same update, so they share the version number
+    VersionNumberBatch batch;
+    _writesPerSecond->write(batch.getVersionNumber());
+    _readsPerSecond->write(batch.getVersionNumber());
+    _dataLossCount->write(batch.getVersionNumber());
+    _discardCount->write(batch.getVersionNumber());
+    _maxQueueOccupancy->write(batch.getVersionNumber());
+    _persistenceFlushDuration->write(batch.getVersionNumber());
+    _persistenceFileSize->write(batch.getVersionNumber());
+    _residentMemory->write(batch.getVersionNumber());
+  }
+
+  /*********************************************************************************************************************/
+
+  uint64_t getResidentMemory() {
+    // second field of statm is the resident set size in pages
+    std::ifstream statm("/proc/self/statm");
+    uint64_t totalPages{0}, residentPages{0};
+    if(!(statm >> totalPages >> residentPages)) {
+      return 0;
+    }
+    return residentPages * static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+  }
+
+  /*********************************************************************************************************************/
+
+} // namespace ChimeraTK
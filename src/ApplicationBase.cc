@@ -4,7 +4,13 @@
 #include "ApplicationBase.h"
 
 #include "ApplicationFactory.h"
+#include "StartupProfiler.h"
 
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <map>
 #include <utility>
 
 namespace ChimeraTK {
@@ -13,11 +19,17 @@ namespace ChimeraTK {
 
   ApplicationBase* ApplicationBase::instance = nullptr;
   std::recursive_mutex ApplicationBase::instanceMutex;
+  bool ApplicationBase::_hostIsCreating{false};
+  thread_local ApplicationBase* ApplicationBase::_hostedInstance{nullptr};
 
   /*********************************************************************************************************************/
 
   ApplicationBase::ApplicationBase(std::string name) : _applicationName(std::move(name)) {
     std::lock_guard<std::recursive_mutex> lock(instanceMutex);
+    // Applications hosted by a MultiApplicationHost do not use the global instance pointer
+    if(_hostIsCreating) {
+      return;
+    }
     // Protection against creating multiple instances manually
     if(instance != nullptr) {
       throw ChimeraTK::logic_error("Multiple instances of ChimeraTK::ApplicationBase cannot be created.");
@@ -74,19 +86,177 @@ namespace ChimeraTK {
     // finally clear the global instance pointer and mark this instance as shut
     // down
     std::lock_guard<std::recursive_mutex> lock(instanceMutex);
-    instance = nullptr;
+    if(instance == this) {
+      instance = nullptr;
+    }
     _hasBeenShutdown = true;
   }
 
   /*********************************************************************************************************************/
 
+  void ApplicationBase::initialiseProfiled() {
+    StartupPhase phase("ApplicationBase::initialise");
+    initialise();
+  }
+
+  /*********************************************************************************************************************/
+
   void ApplicationBase::setPVManager(boost::shared_ptr<ChimeraTK::DevicePVManager> const& processVariableManager) {
     _processVariableManager = processVariableManager;
   }
 
   /*********************************************************************************************************************/
 
+  void ApplicationBase::registerInitialisationModule(const std::string& name,
+      const std::vector<std::string>& dependencies, std::function<void(DevicePVManager&)> initialiseFunction,
+      const ChimeraTK::RegisterPath& pvPrefix) {
+    for(const auto& module : _initialisationModules) {
+      if(module.name == name) {
+        throw ChimeraTK::logic_error("Initialisation module '" + name + "' is already registered.");
+      }
+    }
+    _initialisationModules.push_back({name, dependencies, std::move(initialiseFunction), pvPrefix});
+  }
+
+  /*********************************************************************************************************************/
+
+  void ApplicationBase::initialiseModules(size_t nThreads) {
+    auto modules = std::move(_initialisationModules);
+    _initialisationModules.clear();
+    if(modules.empty()) {
+      return;
+    }
+    if(!_processVariableManager) {
+      throw ChimeraTK::logic_error("ApplicationBase::initialiseModules() called before the PV manager has been set.");
+    }
+
+    // resolve the dependencies into indices
+    std::map<std::string, size_t> moduleIndices;
+    for(size_t i = 0; i < modules.size(); ++i) {
+      moduleIndices[modules[i].name] = i;
+    }
+    std::vector<size_t> nOpenDependencies(modules.size(), 0);
+    std::vector<std::vector<size_t>> dependents(modules.size());
+    for(size_t i = 0; i < modules.size(); ++i) {
+      for(const auto& dependency : modules[i].dependencies) {
+        auto it = moduleIndices.find(dependency);
+        if(it == moduleIndices.end()) {
+          throw ChimeraTK::logic_error(
+              "Initialisation module '" + modules[i].name + "' depends on unknown module '" + dependency + "'.");
+        }
+        ++nOpenDependencies[i];
+        dependents[it->second].push_back(i);
+      }
+    }
+
+    // detect dependency cycles before starting anything (Kahn's algorithm)
+    {
+      auto open = nOpenDependencies;
+      std::vector<size_t> ready;
+      for(size_t i = 0; i < modules.size(); ++i) {
+        if(open[i] == 0) {
+          ready.push_back(i);
+        }
+      }
+      size_t nSorted = 0;
+      while(!ready.empty()) {
+        auto i = ready.back();
+        ready.pop_back();
+        ++nSorted;
+        for(auto dependent : dependents[i]) {
+          if(--open[dependent] == 0) {
+            ready.push_back(dependent);
+          }
+        }
+      }
+      if(nSorted != modules.size()) {
+        std::string cycle;
+        for(size_t i = 0; i < modules.size(); ++i) {
+          if(open[i] != 0) {
+            cycle += (cycle.empty() ? "'" : ", '") + modules[i].name + "'";
+          }
+        }
+        throw ChimeraTK::logic_error("Dependency cycle between the initialisation modules " + cycle + ".");
+      }
+    }
+
+    // execute the modules on the thread pool
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<size_t> readyModules;
+    size_t nRunning = 0;
+    size_t nCompleted = 0;
+    std::exception_ptr firstException;
+    for(size_t i = 0; i < modules.size(); ++i) {
+      if(nOpenDependencies[i] == 0) {
+        readyModules.push_back(i);
+      }
+    }
+
+    auto* hostedInstance = _hostedInstance;
+    auto worker = [&] {
+      // the modules may use getInstance() just like the initialise() function they are called from
+      _hostedInstance = hostedInstance;
+      std::unique_lock<std::mutex> lock(mutex);
+      while(true) {
+        cv.wait(lock, [&] {
+          return !readyModules.empty() || nCompleted == modules.size() || (firstException && nRunning == 0);
+        });
+        if(readyModules.empty() || firstException) {
+          return;
+        }
+        auto i = readyModules.front();
+        readyModules.pop_front();
+        ++nRunning;
+        lock.unlock();
+
+        std::exception_ptr exception;
+        try {
+          StartupPhase phase("ApplicationBase::initialiseModules");
+          auto pvManager = _processVariableManager->getSubManager(modules[i].pvPrefix);
+          modules[i].initialiseFunction(*pvManager);
+        }
+        catch(...) {
+          exception = std::current_exception();
+        }
+
+        lock.lock();
+        --nRunning;
+        ++nCompleted;
+        if(exception && !firstException) {
+          firstException = exception;
+        }
+        for(auto dependent : dependents[i]) {
+          if(--nOpenDependencies[dependent] == 0) {
+            readyModules.push_back(dependent);
+          }
+        }
+        cv.notify_all();
+      }
+    };
+
+    nThreads = std::max(size_t(1), std::min(nThreads, modules.size()));
+    std::vector<std::thread> threads;
+    threads.reserve(nThreads);
+    for(size_t i = 0; i < nThreads; ++i) {
+      threads.emplace_back(worker);
+    }
+    // barrier: all modules are done (or aborted) when all workers have terminated
+    for(auto& thread : threads) {
+      thread.join();
+    }
+
+    if(firstException) {
+      std::rethrow_exception(firstException);
+    }
+  }
+
+  /*********************************************************************************************************************/
+
   ApplicationBase& ApplicationBase::getInstance() {
+    if(_hostedInstance != nullptr) {
+      return *_hostedInstance;
+    }
     if(instance == nullptr) {
       return ApplicationFactoryBase::getApplicationInstance();
     }
@@ -4,6 +4,7 @@
 #include "ApplicationFactory.h"
 
 #include "ApplicationBase.h"
+#include "StartupProfiler.h"
 
 namespace ChimeraTK {
 
@@ -33,7 +34,10 @@ namespace ChimeraTK {
                                    "ApplicationFactoryBase::getApplicationInstance() called.");
     }
     _factoryIsCreating = true;
-    _factoryFunction();
+    {
+      StartupPhase phase("ApplicationFactory::createApplication");
+      _factoryFunction();
+    }
     _factoryIsCreating = false;
 
     return *_applicationInstance;
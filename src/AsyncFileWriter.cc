@@ -0,0 +1,439 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "AsyncFileWriter.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <list>
+#include <mutex>
+#include <system_error>
+#include <thread>
+
+#ifdef CHIMERATK_CONTROL_SYSTEM_ADAPTER_HAVE_IO_URING
+#  include <liburing.h>
+#endif
+
+namespace ChimeraTK {
+
+  /*********************************************************************************************************************/
+
+  /**
+   * Common part of the backends: file handling and error bookkeeping. The backends implement how the operations are
+   * executed.
+   */
+  class AsyncFileWriter::Backend {
+   public:
+    virtual ~Backend() = default;
+
+    void open(const std::string& fileName) {
+      if(_fd >= 0) {
+        throw std::logic_error("AsyncFileWriter::open(): previous file " + _targetName + " is still open.");
+      }
+      _targetName = fileName;
+      _tempName = fileName + ".new";
+      _fd = ::open(_tempName.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+      if(_fd < 0) {
+        throw std::system_error(errno, std::generic_category(), "Cannot create " + _tempName);
+      }
+      _offset = 0;
+      _errorCode = 0;
+      _errorOperation.clear();
+    }
+
+    void append(std::string&& chunk) {
+      if(chunk.empty()) {
+        return;
+      }
+      auto offset = _offset;
+      _offset += static_cast<off_t>(chunk.size());
+      submitWrite(std::move(chunk), offset);
+    }
+
+    void commit() {
+      syncAndRename();
+      ::close(_fd);
+      _fd = -1;
+      if(_errorCode != 0) {
+        ::unlink(_tempName.c_str());
+        throw std::system_error(_errorCode, std::generic_category(), _errorOperation + " " + _tempName);
+      }
+    }
+
+    void abort() noexcept {
+      if(_fd < 0) {
+        return;
+      }
+      drain();
+      ::close(_fd);
+      _fd = -1;
+      ::unlink(_tempName.c_str());
+    }
+
+    [[nodiscard]] virtual bool isUsingIoUring() const = 0;
+
+   protected:
+    /** Start writing the chunk at the given offset of the temporary file. */
+    virtual void submitWrite(std::string&& chunk, off_t offset) = 0;
+
+    /** Wait for all writes, then fdatasync and rename the temporary file. Errors must be recorded with setError(). */
+    virtual void syncAndRename() = 0;
+
+    /** Wait until all submitted operations have completed. */
+    virtual void drain() noexcept = 0;
+
+    /** Record an error. Only the first error is kept. May be called from any thread. */
+    void setError(int errorCode, const char* operation) {
+      std::lock_guard<std::mutex> lock(_errorMutex);
+      if(_errorCode == 0) {
+        _errorCode = errorCode;
+        _errorOperation = operation;
+      }
+    }
+
+    [[nodiscard]] bool hasError() {
+      std::lock_guard<std::mutex> lock(_errorMutex);
+      return _errorCode != 0;
+    }
+
+    int _fd{-1};
+    std::string _targetName;
+    std::string _tempName;
+    off_t _offset{0};
+
+   private:
+    std::mutex _errorMutex;
+    int _errorCode{0};
+    std::string _errorOperation;
+  };
+
+  /*********************************************************************************************************************/
+
+  namespace {
+
+    /** Write the complete buffer, retrying on short writes and interruptions. Returns 0 or the errno value. */
+    int writeFully(int fd, const std::string& data, off_t offset) {
+      size_t written = 0;
+      while(written < data.size()) {
+        auto n = ::pwrite(fd, data.data() + written, data.size() - written, offset + static_cast<off_t>(written));
+        if(n < 0) {
+          if(errno == EINTR) {
+            continue;
+          }
+          return errno;
+        }
+        written += static_cast<size_t>(n);
+      }
+      return 0;
+    }
+
+    /*******************************************************************************************************************/
+
+    /** Backend executing the operations in a helper thread with the normal system calls. */
+    class ThreadBackend : public AsyncFileWriter::Backend {
+     public:
+      ThreadBackend() : _thread([this] { run(); }) {}
+
+      ~ThreadBackend() override {
+        abort();
+        {
+          std::lock_guard<std::mutex> lock(_mutex);
+          _shutdown = true;
+        }
+        _condition.notify_all();
+        _thread.join();
+      }
+
+      [[nodiscard]] bool isUsingIoUring() const override { return false; }
+
+     protected:
+      void submitWrite(std::string&& chunk, off_t offset) override {
+        {
+          std::lock_guard<std::mutex> lock(_mutex);
+          _queue.push_back({std::move(chunk), offset});
+        }
+        _condition.notify_all();
+      }
+
+      void syncAndRename() override {
+        drain();
+        if(hasError()) {
+          return;
+        }
+        if(::fdatasync(_fd) != 0) {
+          setError(errno, "fdatasync");
+          return;
+        }
+        if(std::rename(_tempName.c_str(), _targetName.c_str()) != 0) {
+          setError(errno, "rename");
+        }
+      }
+
+      void drain() noexcept override {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _condition.wait(lock, [this] { return _queue.empty() && !_busy; });
+      }
+
+     private:
+      void run() {
+        std::unique_lock<std::mutex> lock(_mutex);
+        while(true) {
+          _condition.wait(lock, [this] { return _shutdown || !_queue.empty(); });
+          if(_queue.empty()) {
+            return; // shutdown requested and nothing left to do
+          }
+          auto job = std::move(_queue.front());
+          _queue.pop_front();
+          _busy = true;
+          lock.unlock();
+          // after an error, the remaining chunks are skipped, the file is discarded anyway
+          if(!hasError()) {
+            int result = writeFully(_fd, job.data, job.offset);
+            if(result != 0) {
+              setError(result, "write");
+            }
+          }
+          lock.lock();
+          _busy = false;
+          _condition.notify_all();
+        }
+      }
+
+      struct Job {
+        std::string data;
+        off_t offset;
+      };
+
+      std::mutex _mutex;
+      std::condition_variable _condition;
+      std::deque<Job> _queue;
+      bool _busy{false};
+      bool _shutdown{false};
+      std::thread _thread;
+    };
+
+    /*******************************************************************************************************************/
+
+#ifdef CHIMERATK_CONTROL_SYSTEM_ADAPTER_HAVE_IO_URING
+
+    /** Backend submitting the operations to an io_uring. All completions are reaped by the calling thread. */
+    class IoUringBackend : public AsyncFileWriter::Backend {
+     public:
+      /** Try to set up the ring. Returns nullptr if io_uring is not available. */
+      static std::unique_ptr<IoUringBackend> create() {
+        std::unique_ptr<IoUringBackend> backend(new IoUringBackend());
+        if(io_uring_queue_init(queueDepth, &backend->_ring, 0) != 0) {
+          return nullptr;
+        }
+        backend->_ringInitialised = true;
+        return backend;
+      }
+
+      ~IoUringBackend() override {
+        abort();
+        if(_ringInitialised) {
+          io_uring_queue_exit(&_ring);
+        }
+      }
+
+      [[nodiscard]] bool isUsingIoUring() const override { return true; }
+
+     protected:
+      void submitWrite(std::string&& chunk, off_t offset) override {
+        _inFlight.push_back({std::move(chunk), offset, 0});
+        auto& write = _inFlight.back();
+        auto* sqe = getSqe();
+        io_uring_prep_write(sqe, _fd, write.data.data(), static_cast<unsigned>(write.data.size()),
+            static_cast<uint64_t>(offset));
+        io_uring_sqe_set_data(sqe, &write);
+        io_uring_submit(&_ring);
+        // reap whatever has completed meanwhile, so the chunks are freed early
+        reap(false);
+      }
+
+      void syncAndRename() override {
+        // Wait for the writes first, so an incomplete file never replaces the target. The rename is linked to the
+        // fdatasync, so it is only executed if the data has reached the disk.
+        while(!_inFlight.empty()) {
+          if(!reap(true)) {
+            return;
+          }
+        }
+        if(hasError()) {
+          return;
+        }
+        auto* sqe = getSqe();
+        io_uring_prep_fsync(sqe, _fd, IORING_FSYNC_DATASYNC);
+        io_uring_sqe_set_data(sqe, &_fsyncTag);
+        sqe->flags |= IOSQE_IO_LINK;
+        sqe = getSqe();
+        io_uring_prep_renameat(sqe, AT_FDCWD, _tempName.c_str(), AT_FDCWD, _targetName.c_str(), 0);
+        io_uring_sqe_set_data(sqe, &_renameTag);
+        _fsyncResult = 1;
+        _renameResult = 1;
+        io_uring_submit(&_ring);
+        drain();
+
+        if(_fsyncResult < 0) {
+          setError(-_fsyncResult, "fdatasync");
+        }
+        else if(_renameResult == -EINVAL || _renameResult == -EOPNOTSUPP) {
+          // renameat is not supported by the io_uring of this kernel
+          if(std::rename(_tempName.c_str(), _targetName.c_str()) != 0) {
+            setError(errno, "rename");
+          }
+        }
+        else if(_renameResult < 0) {
+          setError(-_renameResult, "rename");
+        }
+      }
+
+      void drain() noexcept override {
+        while(!_inFlight.empty() || _fsyncResult == 1 || _renameResult == 1) {
+          if(!reap(true)) {
+            break;
+          }
+        }
+      }
+
+     private:
+      IoUringBackend() = default;
+
+      /** Get a submission queue entry, waiting for completions if the ring is full. */
+      io_uring_sqe* getSqe() {
+        auto* sqe = io_uring_get_sqe(&_ring);
+        while(!sqe) {
+          io_uring_submit(&_ring);
+          reap(true);
+          sqe = io_uring_get_sqe(&_ring);
+        }
+        return sqe;
+      }
+
+      /** Process completions. If wait is true, block for at least one. Returns false if waiting has failed. */
+      bool reap(bool wait) {
+        io_uring_cqe* cqe = nullptr;
+        if(wait) {
+          int result = io_uring_wait_cqe(&_ring, &cqe);
+          if(result == -EINTR) {
+            return true;
+          }
+          if(result < 0) {
+            setError(-result, "io_uring_wait_cqe");
+            return false;
+          }
+        }
+        while(cqe || io_uring_peek_cqe(&_ring, &cqe) == 0) {
+          complete(io_uring_cqe_get_data(cqe), cqe->res);
+          io_uring_cqe_seen(&_ring, cqe);
+          cqe = nullptr;
+        }
+        return true;
+      }
+
+      void complete(void* tag, int result) {
+        if(tag == &_fsyncTag) {
+          _fsyncResult = result;
+          return;
+        }
+        if(tag == &_renameTag) {
+          _renameResult = result;
+          return;
+        }
+        auto* write = static_cast<Write*>(tag);
+        if(result < 0) {
+          setError(-result, "write");
+        }
+        else if(static_cast<size_t>(result) < write->data.size() - write->written) {
+          // short write: write the rest synchronously, this is rare for regular files
+          write->written += static_cast<size_t>(result);
+          int error = writeFully(_fd, write->data.substr(write->written), write->offset + static_cast<off_t>(write->written));
+          if(error != 0) {
+            setError(error, "write");
+          }
+        }
+        for(auto it = _inFlight.begin(); it != _inFlight.end(); ++it) {
+          if(&*it == write) {
+            _inFlight.erase(it);
+            break;
+          }
+        }
+      }
+
+      struct Write {
+        std::string data;
+        off_t offset;
+        size_t written;
+      };
+
+      static constexpr unsigned queueDepth = 32;
+
+      io_uring _ring{};
+      bool _ringInitialised{false};
+      std::list<Write> _inFlight;
+      char _fsyncTag{};
+      char _renameTag{};
+      int _fsyncResult{0};
+      int _renameResult{0};
+    };
+
+#endif
+
+  } // namespace
+
+  /*********************************************************************************************************************/
+
+  AsyncFileWriter::AsyncFileWriter(bool allowIoUring) {
+#ifdef CHIMERATK_CONTROL_SYSTEM_ADAPTER_HAVE_IO_URING
+    if(allowIoUring) {
+      _backend = IoUringBackend::create();
+    }
+#else
+    (void)allowIoUring;
+#endif
+    if(!_backend) {
+      _backend = std::make_unique<ThreadBackend>();
+    }
+  }
+
+  /*********************************************************************************************************************/
+
+  AsyncFileWriter::~AsyncFileWriter() = default;
+
+  /*********************************************************************************************************************/
+
+  void AsyncFileWriter::open(const std::string& fileName) {
+    _backend->open(fileName);
+  }
+
+  /*********************************************************************************************************************/
+
+  void AsyncFileWriter::append(std::string&& chunk) {
+    _backend->append(std::move(chunk));
+  }
+
+  /*********************************************************************************************************************/
+
+  void AsyncFileWriter::commit() {
+    _backend->commit();
+  }
+
+  /*********************************************************************************************************************/
+
+  void AsyncFileWriter::abort() noexcept {
+    _backend->abort();
+  }
+
+  /*********************************************************************************************************************/
+
+  bool AsyncFileWriter::isUsingIoUring() const {
+    return _backend->isUsingIoUring();
+  }
+
+  /*********************************************************************************************************************/
+
+} // namespace ChimeraTK
@@ -0,0 +1,222 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "ControlSystemCallbackDispatcher.h"
+
+#include <ChimeraTK/Exception.h>
+
+#include <boost/thread/exceptions.hpp>
+
+#include <algorithm>
+#include <iostream>
+
+namespace ChimeraTK {
+
+  /*********************************************************************************************************************/
+
+  ControlSystemCallbackDispatcher::ControlSystemCallbackDispatcher(
+      const boost::shared_ptr<ControlSystemPVManager>& pvManager, size_t nWorkers, size_t maxBatchSize)
+  : _pvManager(pvManager), _nWorkers(nWorkers), _maxBatchSize(std::max<size_t>(maxBatchSize, 1)) {
+    if(_nWorkers == 0) {
+      _nWorkers = std::max(std::thread::hardware_concurrency(), 1U);
+    }
+  }
+
+  /*********************************************************************************************************************/
+
+  ControlSystemCallbackDispatcher::~ControlSystemCallbackDispatcher() {
+    stop();
+  }
+
+  /*********************************************************************************************************************/
+
+  void ControlSystemCallbackDispatcher::addCallback(
+      const ChimeraTK::RegisterPath& processVariableName, Callback callback) {
+    if(_started) {
+      throw ChimeraTK::logic_error("ControlSystemCallbackDispatcher: Callbacks cannot be added after start().");
+    }
+    std::string name = processVariableName;
+    auto it = _entryIndices.find(name);
+    if(it != _entryIndices.end()) {
+      _entries[it->second]->callback = std::move(callback);
+      return;
+    }
+
+    ProcessVariable::SharedPtr pv;
+    if(_pvManager->hasProcessVariable(processVariableName)) {
+      pv = _pvManager->getProcessVariable(processVariableName);
+    }
+    if(!pv || !pv->isReadable() || !pv->getAccessModeFlags().has(AccessMode::wait_for_new_data)) {
+      throw ChimeraTK::logic_error(
+          "ControlSystemCallbackDispatcher: No readable process variable with wait_for_new_data with the name " + name);
+    }
+    auto entry = std::make_unique<Entry>();
+    entry->processVariable = pv;
+    entry->callback = std::move(callback);
+    _entryIndices[name] = _entries.size();
+    _entries.push_back(std::move(entry));
+  }
+
+  /*********************************************************************************************************************/
+
+  void ControlSystemCallbackDispatcher::start() {
+    if(_started) {
+      throw ChimeraTK::logic_error("ControlSystemCallbackDispatcher: start() has already been called.");
+    }
+    _started = true;
+
+    std::vector<cppext::future_queue<void>> queues;
+    queues.reserve(_entries.size() + 1);
+    for(auto& entry : _entries) {
+      queues.push_back(entry->processVariable->getReadQueue());
+    }
+    queues.push_back(_stopQueue);
+    _notifications = cppext::when_any(queues.begin(), queues.end());
+
+    for(size_t i = 0; i < _nWorkers; ++i) {
+      _workerQueues.push_back(std::make_unique<WorkerQueue>());
+    }
+    for(size_t i = 0; i < _nWorkers; ++i) {
+      _workerThreads.emplace_back([this, i] { workerThreadFunction(i); });
+    }
+    _dispatcherThread = std::thread([this] { dispatcherThreadFunction(); });
+  }
+
+  /*********************************************************************************************************************/
+
+  void ControlSystemCallbackDispatcher::stop() {
+    if(!_dispatcherThread.joinable()) {
+      return;
+    }
+    _stopQueue.push();
+    _dispatcherThread.join();
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _shutdown = true;
+    }
+    _workerCondition.notify_all();
+    for(auto& worker : _workerThreads) {
+      worker.join();
+    }
+  }
+
+  /*********************************************************************************************************************/
+
+  void ControlSystemCallbackDispatcher::dispatcherThreadFunction() {
+    while(true) {
+      size_t index;
+      _notifications.pop_wait(index);
+
+      // Collect the process variables of all pending notifications into tasks. Process variables which are already
+      // part of a task only get their pending counter incremented, the worker of that task reads the value.
+      Task task;
+      do {
+        if(index == _entries.size()) {
+          return; // stop() has been called
+        }
+        if(_entries[index]->nPending++ == 0) {
+          task.push_back(index);
+          if(task.size() == _maxBatchSize) {
+            enqueue(std::move(task));
+            task = {};
+          }
+        }
+      } while(_notifications.pop(index));
+
+      if(!task.empty()) {
+        enqueue(std::move(task));
+      }
+    }
+  }
+
+  /*********************************************************************************************************************/
+
+  void ControlSystemCallbackDispatcher::enqueue(Task task) {
+    auto& queue = *_workerQueues[_nextWorkerQueue];
+    _nextWorkerQueue = (_nextWorkerQueue + 1) % _workerQueues.size();
+    {
+      std::lock_guard<std::mutex> lock(queue.mutex);
+      queue.tasks.push_back(std::move(task));
+    }
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      ++_nUnclaimedTasks;
+    }
+    _workerCondition.notify_one();
+  }
+
+  /*********************************************************************************************************************/
+
+  bool ControlSystemCallbackDispatcher::takeTask(size_t workerIndex, Task& task) {
+    for(size_t i = 0; i < _workerQueues.size(); ++i) {
+      auto& queue = *_workerQueues[(workerIndex + i) % _workerQueues.size()];
+      std::lock_guard<std::mutex> lock(queue.mutex);
+      if(queue.tasks.empty()) {
+        continue;
+      }
+      if(i == 0) {
+        task = std::move(queue.tasks.front());
+        queue.tasks.pop_front();
+      }
+      else {
+        task = std::move(queue.tasks.back());
+        queue.tasks.pop_back();
+      }
+      return true;
+    }
+    return false;
+  }
+
+  /*********************************************************************************************************************/
+
+  void ControlSystemCallbackDispatcher::workerThreadFunction(size_t workerIndex) {
+    Task task;
+    while(true) {
+      {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _workerCondition.wait(lock, [&] { return _shutdown || _nUnclaimedTasks > 0; });
+        if(_shutdown) {
+          return;
+        }
+        --_nUnclaimedTasks;
+      }
+
+      // Tasks are queued before they are counted, so a task is available for each claim. It may just have been
+      // taken from the queue scanned first by a worker whose claim belongs to another queue, hence the retry.
+      while(!takeTask(workerIndex, task)) {
+        std::this_thread::yield();
+      }
+      for(auto index : task) {
+        process(*_entries[index]);
+      }
+    }
+  }
+
+  /*********************************************************************************************************************/
+
+  void ControlSystemCallbackDispatcher::process(Entry& entry) {
+    // Each notification corresponds to one value in the queue of the process variable. Values arriving while the
+    // callback runs increment the counter again, so they are processed here as well, in order.
+    do {
+      try {
+        if(entry.processVariable->readNonBlocking() && entry.callback) {
+          entry.callback(entry.processVariable);
+        }
+      }
+      catch(boost::thread_interrupted&) {
+        // the process variable has been interrupted, there is no value to process
+      }
+      catch(std::exception& e) {
+        std::cerr << "ControlSystemCallbackDispatcher: exception in callback for " << entry.processVariable->getName()
+                  << ": " << e.what() << std::endl;
+      }
+      catch(...) {
+        std::cerr << "ControlSystemCallbackDispatcher: unknown exception in callback for "
+                  << entry.processVariable->getName() << std::endl;
+      }
+    } while(--entry.nPending > 0);
+  }
+
+  /*********************************************************************************************************************/
+
+} // namespace ChimeraTK
@@ -1,5 +1,9 @@
 #include "ControlSystemPVManager.h"
 
+#include "StartupProfiler.h"
+#include "TransferTracer.h"
+#include "VersionNumberBatch.h"
+
 #include <utility>
 
 namespace ChimeraTK {
@@ -9,27 +13,63 @@ namespace ChimeraTK {
 
   ProcessVariable::SharedPtr ControlSystemPVManager::getProcessVariable(
       const ChimeraTK::RegisterPath& processVariableName) const {
-    auto pv = _pvManager->getProcessVariable(processVariableName).first;
-    if(_persistentDataStorage && pv->isWriteable()) {
-      pv->setPersistentDataStorage(_persistentDataStorage);
-    }
-    return pv;
+    return withPersistentDataStorage(_pvManager->getProcessVariable(processVariableName).first);
   }
 
   std::vector<ProcessVariable::SharedPtr> ControlSystemPVManager::getAllProcessVariables() const {
+    StartupPhase phase("ControlSystemPVManager::getAllProcessVariables");
     std::vector<ProcessVariable::SharedPtr> csProcessVariables;
     PVManager::ProcessVariableMap const& processVariables = _pvManager->getAllProcessVariables();
     // We reserve the capacity that we need in order to avoid unnecessary copy
     // operations.
     csProcessVariables.reserve(processVariables.size());
+    // the initial values sent when attaching the persistent data storage all get the same version number
+    VersionNumberBatch batch;
     for(const auto& processVariable : processVariables) {
       auto pv = processVariable.second.first;
-      if(_persistentDataStorage && pv->isWriteable()) {
-        pv->setPersistentDataStorage(_persistentDataStorage);
+      if(pv->isWriteable()) {
+        auto storage = getPersistentDataStorage(processVariable.first);
+        if(storage) {
+          pv->setPersistentDataStorage(storage);
+        }
       }
       csProcessVariables.push_back(pv);
     }
     return csProcessVariables;
   }
 
+  void ControlSystemPVManager::shutdown() {
+    if(_persistentDataStorage) {
+      _persistentDataStorage->stopWriterThread();
+    }
+    for(const auto& prefixedStorage : _prefixedPersistentDataStorages) {
+      prefixedStorage.second->stopWriterThread();
+    }
+    _pvManager->interruptAll(true, true);
+    // the application threads may still be running when static objects are destroyed
+    dumpTransferTrace();
+  }
+
+  void ControlSystemPVManager::setPersistencePolicy(
+      const ChimeraTK::RegisterPath& processVariableName, PersistencePolicy policy) {
+    auto storage = getPersistentDataStorage(processVariableName);
+    if(!storage) {
+      throw ChimeraTK::logic_error(
+          "No persistent data storage enabled for process variable '" + std::string(processVariableName) + "'.");
+    }
+    storage->setPersistencePolicy(processVariableName, policy);
+  }
+
+  boost::shared_ptr<PersistentDataStorage> ControlSystemPVManager::getPersistentDataStorage(
+      const std::string& name) const {
+    // If prefixes are nested, the longer prefix comes later in the map and hence wins.
+    boost::shared_ptr<PersistentDataStorage> storage = _persistentDataStorage;
+    for(const auto& [prefix, prefixedStorage] : _prefixedPersistentDataStorages) {
+      if(name.compare(0, prefix.size(), prefix) == 0) {
+        storage = prefixedStorage;
+      }
+    }
+    return storage;
+  }
+
 } // namespace ChimeraTK
@@ -1,28 +1,106 @@
 #include "DevicePVManager.h"
 
+#include "AdapterStatistics.h"
+#include "StartupProfiler.h"
+#include "VersionNumberBatch.h"
+
 #include <exception>
 #include <utility>
 
 namespace ChimeraTK {
 
-  DevicePVManager::DevicePVManager(boost::shared_ptr<PVManager> pvManager)
-  : _pvManager(std::move(std::move(pvManager))) {}
+  DevicePVManager::DevicePVManager(boost::shared_ptr<PVManager> pvManager, ChimeraTK::RegisterPath prefix)
+  : _pvManager(std::move(std::move(pvManager))), _prefix(std::move(prefix)),
+    _dirtySet(boost::make_shared<detail::DirtySet>()) {}
 
   ProcessVariable::SharedPtr DevicePVManager::getProcessVariable(
       const ChimeraTK::RegisterPath& processVariableName) const {
-    return _pvManager->getProcessVariable(processVariableName).second;
+    return _pvManager->getProcessVariable(_prefix / processVariableName).second;
   }
 
   std::vector<ProcessVariable::SharedPtr> DevicePVManager::getAllProcessVariables() const {
     std::vector<ProcessVariable::SharedPtr> devProcessVariables;
     PVManager::ProcessVariableMap const& processVariables = _pvManager->getAllProcessVariables();
-    // We reserve the capacity that we need in order to avoid unnecessary copy
-    // operations.
-    devProcessVariables.reserve(processVariables.size());
+    if(_prefix == "/") {
+      // We reserve the capacity that we need in order to avoid unnecessary copy
+      // operations.
+      devProcessVariables.reserve(processVariables.size());
+      for(const auto& processVariable : processVariables) {
+        devProcessVariables.push_back(processVariable.second.second);
+      }
+      return devProcessVariables;
+    }
+    std::string prefix = std::string(_prefix) + "/";
     for(const auto& processVariable : processVariables) {
-      devProcessVariables.push_back(processVariable.second.second);
+      if(std::string(processVariable.first).compare(0, prefix.size(), prefix) == 0) {
+        devProcessVariables.push_back(processVariable.second.second);
+      }
     }
     return devProcessVariables;
   }
 
+  boost::shared_ptr<DevicePVManager> DevicePVManager::getSubManager(const ChimeraTK::RegisterPath& prefix) const {
+    return boost::shared_ptr<DevicePVManager>(new DevicePVManager(_pvManager, _prefix / prefix));
+  }
+
+  void DevicePVManager::markDirty(const ChimeraTK::RegisterPath& processVariableName) {
+    auto processVariable = getProcessVariable(processVariableName);
+    _dirtySet->mark(_dirtySet->add(processVariable));
+  }
+
+  size_t DevicePVManager::publishDirty() { return _dirtySet->publish(); }
+
+  size_t DevicePVManager::publishInitialValues() {
+    StartupPhase phase("DevicePVManager::publishInitialValues");
+    size_t nWritten = 0;
+    {
+      VersionNumberBatch batch;
+      for(const auto& processVariable : getAllProcessVariables()) {
+        if(processVariable->isWriteable()) {
+          processVariable->write(batch.getVersionNumber());
+          ++nWritten;
+        }
+      }
+    }
+    _pvManager->setInitialValuesPublished(_prefix);
+    return nWritten;
+  }
+
+  size_t DevicePVManager::interruptAll() {
+    if(_prefix == "/") {
+      return _pvManager->interruptAll(false, true);
+    }
+    size_t nInterrupted = 0;
+    for(const auto& processVariable : getAllProcessVariables()) {
+      if(processVariable->isReadable() && processVariable->getAccessModeFlags().has(AccessMode::wait_for_new_data)) {
+        processVariable->interrupt();
+        ++nInterrupted;
+      }
+    }
+    return nInterrupted;
+  }
+
+  void DevicePVManager::addToSynchronisationGroup(
+      const ChimeraTK::RegisterPath& group, const ChimeraTK::RegisterPath& processVariableName) {
+    getSynchronisationExecutor().addToGroup(_prefix / group, _prefix / processVariableName);
+  }
+
+  void DevicePVManager::executeSynchronisationFunction(const std::vector<ChimeraTK::RegisterPath>& groups,
+      const std::function<void()>& function, SynchronisationExecutor::AccessMode mode) {
+    std::vector<ChimeraTK::RegisterPath> absoluteGroups;
+    absoluteGroups.reserve(groups.size());
+    for(const auto& group : groups) {
+      absoluteGroups.push_back(_prefix / group);
+    }
+    getSynchronisationExecutor().execute(absoluteGroups, function, mode);
+  }
+
+  void DevicePVManager::enableStatistics(
+      const ChimeraTK::RegisterPath& prefix, std::chrono::milliseconds updateInterval) {
+    if(_statisticsPublisher) {
+      throw ChimeraTK::logic_error("The adapter statistics have already been enabled.");
+    }
+    _statisticsPublisher = boost::make_shared<StatisticsPublisher>(*this, prefix, updateInterval);
+  }
+
 } // namespace ChimeraTK
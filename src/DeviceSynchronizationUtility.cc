@@ -0,0 +1,143 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "DeviceSynchronizationUtility.h"
+
+namespace ChimeraTK {
+
+  /*********************************************************************************************************************/
+
+  DeviceSynchronizationUtility::DeviceSynchronizationUtility(const DevicePVManager::SharedPtr& pvManager)
+  : _prefix(pvManager->getPrefix()) {
+    for(auto& pv : pvManager->getAllProcessVariables()) {
+      if(pv->isReadable()) {
+        auto index = _receivers.size();
+        _receivers.push_back(pv);
+        if(pv->getAccessModeFlags().has(AccessMode::wait_for_new_data)) {
+          _readAnyGroup.add(pv);
+          _receiverIndices[pv->getId()] = index;
+          _hasPushReceivers = true;
+        }
+        else {
+          _pollReceivers.push_back(index);
+        }
+      }
+      if(pv->isWriteable()) {
+        _senderIndices[pv->getName()] = _senders.add(pv);
+      }
+    }
+    _callbacks.resize(_receivers.size());
+    if(_hasPushReceivers) {
+      _readAnyGroup.finalise();
+    }
+  }
+
+  /*********************************************************************************************************************/
+
+  void DeviceSynchronizationUtility::addReceiveNotificationListener(
+      const ChimeraTK::RegisterPath& processVariableName, ReceiveCallback callback) {
+    std::string name = _prefix / processVariableName;
+    for(size_t i = 0; i < _receivers.size(); ++i) {
+      if(_receivers[i]->getName() == name) {
+        _callbacks[i] = std::move(callback);
+        return;
+      }
+    }
+    throw ChimeraTK::logic_error("DeviceSynchronizationUtility: No readable process variable with the name " + name);
+  }
+
+  /*********************************************************************************************************************/
+
+  void DeviceSynchronizationUtility::removeReceiveNotificationListener(
+      const ChimeraTK::RegisterPath& processVariableName) {
+    std::string name = _prefix / processVariableName;
+    for(size_t i = 0; i < _receivers.size(); ++i) {
+      if(_receivers[i]->getName() == name) {
+        _callbacks[i] = nullptr;
+      }
+    }
+  }
+
+  /*********************************************************************************************************************/
+
+  std::vector<ProcessVariable::SharedPtr> DeviceSynchronizationUtility::receiveAll() {
+    if(!_hasPushReceivers) {
+      throw ChimeraTK::logic_error("DeviceSynchronizationUtility::receiveAll() cannot block without a readable process "
+                                   "variable with AccessMode::wait_for_new_data.");
+    }
+    return receivePending(_readAnyGroup.readAny());
+  }
+
+  /*********************************************************************************************************************/
+
+  std::vector<ProcessVariable::SharedPtr> DeviceSynchronizationUtility::receiveAllNonBlocking() {
+    if(!_hasPushReceivers) {
+      return receivePending({});
+    }
+    return receivePending(_readAnyGroup.readAnyNonBlocking());
+  }
+
+  /*********************************************************************************************************************/
+
+  std::vector<ProcessVariable::SharedPtr> DeviceSynchronizationUtility::receivePending(TransferElementID id) {
+    std::vector<ProcessVariable::SharedPtr> received;
+    std::vector<bool> isReceived(_receivers.size(), false);
+    auto notify = [&](size_t index) {
+      if(!isReceived[index]) {
+        isReceived[index] = true;
+        received.push_back(_receivers[index]);
+      }
+      if(_callbacks[index]) {
+        _callbacks[index](_receivers[index]);
+      }
+    };
+
+    // The first value has already been read. Drain everything else which is pending, so the values of all variables
+    // are consistent as far as possible when returning.
+    while(id.isValid()) {
+      notify(_receiverIndices.at(id));
+      id = _readAnyGroup.readAnyNonBlocking();
+    }
+
+    for(auto index : _pollReceivers) {
+      if(_receivers[index]->readLatest()) {
+        notify(index);
+      }
+    }
+    return received;
+  }
+
+  /*********************************************************************************************************************/
+
+  void DeviceSynchronizationUtility::markModified(const ChimeraTK::RegisterPath& processVariableName) {
+    std::string name = _prefix / processVariableName;
+    auto it = _senderIndices.find(name);
+    if(it == _senderIndices.end()) {
+      throw ChimeraTK::logic_error("DeviceSynchronizationUtility: No writeable process variable with the name " + name);
+    }
+    _senders.mark(it->second);
+  }
+
+  /*********************************************************************************************************************/
+
+  void DeviceSynchronizationUtility::markModified(const ProcessVariable::SharedPtr& processVariable) {
+    _senders.mark(processVariable);
+  }
+
+  /*********************************************************************************************************************/
+
+  size_t DeviceSynchronizationUtility::sendAll() {
+    return _senders.publish();
+  }
+
+  /*********************************************************************************************************************/
+
+  void DeviceSynchronizationUtility::interrupt() {
+    if(_hasPushReceivers) {
+      _readAnyGroup.interrupt();
+    }
+  }
+
+  /*********************************************************************************************************************/
+
+} // namespace ChimeraTK
@@ -0,0 +1,57 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "DirtyTrackingAccessor.h"
+
+#include "VersionNumberBatch.h"
+
+namespace ChimeraTK::detail {
+
+  /*********************************************************************************************************************/
+
+  size_t DirtySet::add(const ProcessVariable::SharedPtr& processVariable) {
+    if(!processVariable->isWriteable()) {
+      throw ChimeraTK::logic_error(
+          "Process variable " + processVariable->getName() + " is not writeable and cannot be tracked as dirty.");
+    }
+    auto inserted = _indices.emplace(processVariable.get(), _members.size());
+    if(inserted.second) {
+      _members.push_back(processVariable);
+      if(_members.size() > _bits.size() * 64) {
+        _bits.push_back(0);
+      }
+    }
+    return inserted.first->second;
+  }
+
+  /*********************************************************************************************************************/
+
+  void DirtySet::mark(const ProcessVariable::SharedPtr& processVariable) {
+    auto it = _indices.find(processVariable.get());
+    if(it == _indices.end()) {
+      throw ChimeraTK::logic_error("Process variable " + processVariable->getName() + " is not dirty-tracked.");
+    }
+    mark(it->second);
+  }
+
+  /*********************************************************************************************************************/
+
+  size_t DirtySet::publish() {
+    VersionNumberBatch batch;
+    size_t nWritten = 0;
+    for(size_t word = 0; word < _bits.size(); ++word) {
+      auto bits = _bits[word];
+      _bits[word] = 0;
+      while(bits != 0) {
+        auto index = word * 64 + static_cast<size_t>(__builtin_ctzll(bits));
+        bits &= bits - 1;
+        _members[index]->write(batch.getVersionNumber());
+        ++nWritten;
+      }
+    }
+    return nWritten;
+  }
+
+  /*********************************************************************************************************************/
+
+} // namespace ChimeraTK::detail
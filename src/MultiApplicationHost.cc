@@ -0,0 +1,78 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "MultiApplicationHost.h"
+
+namespace ChimeraTK {
+
+  /*********************************************************************************************************************/
+
+  MultiApplicationHost::MultiApplicationHost() {
+    std::tie(_csManager, _devManager) = createPVManager();
+  }
+
+  /*********************************************************************************************************************/
+
+  MultiApplicationHost::~MultiApplicationHost() {
+    while(!_applications.empty()) {
+      _applications.pop_back();
+    }
+  }
+
+  /*********************************************************************************************************************/
+
+  void MultiApplicationHost::checkUnique(const ChimeraTK::RegisterPath& prefix, const std::string& applicationName) const {
+    if(prefix == "/") {
+      throw ChimeraTK::logic_error("MultiApplicationHost: The prefix of an application must not be empty.");
+    }
+    for(const auto& hosted : _applications) {
+      if(hosted.prefix == prefix) {
+        throw ChimeraTK::logic_error("MultiApplicationHost: Prefix " + prefix + " is already used.");
+      }
+      if(!applicationName.empty() && hosted.application->getName() == applicationName) {
+        throw ChimeraTK::logic_error(
+            "MultiApplicationHost: An application with the name '" + applicationName + "' already exists.");
+      }
+    }
+  }
+
+  /*********************************************************************************************************************/
+
+  void MultiApplicationHost::initialise() {
+    forEachApplication([](HostedApplication& hosted) { hosted.application->initialiseProfiled(); });
+  }
+
+  /*********************************************************************************************************************/
+
+  void MultiApplicationHost::enablePersistentDataStorage(unsigned int writeInterval) {
+    forEachApplication([&](HostedApplication& hosted) {
+      auto storage = hosted.application->getPersistentDataStorage(writeInterval);
+      storage->setVariableNamePrefix(hosted.prefix);
+      _csManager->enablePersistentDataStorage(hosted.prefix, storage);
+    });
+  }
+
+  /*********************************************************************************************************************/
+
+  void MultiApplicationHost::optimiseUnmappedVariables(const std::set<std::string>& unmappedVariables) {
+    forEachApplication([&](HostedApplication& hosted) {
+      std::string prefix = std::string(hosted.prefix) + "/";
+      std::set<std::string> applicationVariables;
+      for(const auto& name : unmappedVariables) {
+        if(name.compare(0, prefix.size(), prefix) == 0) {
+          applicationVariables.insert(name.substr(prefix.size() - 1));
+        }
+      }
+      hosted.application->optimiseUnmappedVariables(applicationVariables);
+    });
+  }
+
+  /*********************************************************************************************************************/
+
+  void MultiApplicationHost::run() {
+    forEachApplication([](HostedApplication& hosted) { hosted.application->run(); });
+  }
+
+  /*********************************************************************************************************************/
+
+} // namespace ChimeraTK
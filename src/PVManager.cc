@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <list>
 
 #include "ControlSystemPVManager.h"
@@ -26,17 +27,94 @@ namespace ChimeraTK {
 
   std::pair<ProcessVariable::SharedPtr, ProcessVariable::SharedPtr> PVManager::getProcessVariable(
       ChimeraTK::RegisterPath const& processVariableName) const {
-    auto i = _processVariables.find(processVariableName);
+    return getProcessVariable(std::string_view(static_cast<std::string>(processVariableName)));
+  }
+
+  std::pair<ProcessVariable::SharedPtr, ProcessVariable::SharedPtr> PVManager::getProcessVariable(
+      std::string_view processVariableName) const {
+    std::lock_guard<std::mutex> lock(_processVariablesMutex);
+    auto i = findProcessVariable(processVariableName);
     if(i != _processVariables.end()) {
       return i->second;
     }
     throw ChimeraTK::logic_error("ChimeraTK::ControlSystemAdapter: Error in "
                                  "PVManager. Unknown process variable '" +
-        (processVariableName) + "'");
+        std::string(processVariableName) + "'");
+  }
+
+  bool PVManager::isNormalisedName(std::string_view name) {
+    if(name.empty() || name.front() != '/') {
+      return false;
+    }
+    if(name.size() > 1 && name.back() == '/') {
+      return false;
+    }
+    return name.find("//") == std::string_view::npos;
+  }
+
+  PVManager::ProcessVariableMap::const_iterator PVManager::findProcessVariable(
+      std::string_view processVariableName) const {
+    if(isNormalisedName(processVariableName)) {
+      auto i = _processVariablesByName.find(processVariableName);
+      return i != _processVariablesByName.end() ? i->second : _processVariables.end();
+    }
+    return _processVariables.find(ChimeraTK::RegisterPath(std::string(processVariableName)));
   }
 
   const PVManager::ProcessVariableMap& PVManager::getAllProcessVariables() const { return _processVariables; }
 
+  size_t PVManager::interruptAll(bool controlSystemSide, bool deviceSide) {
+    std::lock_guard<std::mutex> lock(_processVariablesMutex);
+    size_t nInterrupted = 0;
+    auto interrupt = [&](const ProcessVariable::SharedPtr& pv) {
+      if(pv->isReadable() && pv->getAccessModeFlags().has(AccessMode::wait_for_new_data)) {
+        pv->interrupt();
+        ++nInterrupted;
+      }
+    };
+    for(const auto& processVariable : _processVariables) {
+      if(controlSystemSide) {
+        interrupt(processVariable.second.first);
+      }
+      if(deviceSide) {
+        interrupt(processVariable.second.second);
+      }
+    }
+    return nInterrupted;
+  }
+
+  void PVManager::setInitialValuesPublished(const ChimeraTK::RegisterPath& prefix) {
+    {
+      std::lock_guard<std::mutex> lock(_initialValuesMutex);
+      if(_initialValuesPublished) {
+        return;
+      }
+      _initialValuesPublishedPrefixes.push_back(prefix == "/" ? std::string("/") : std::string(prefix) + "/");
+
+      // check whether all process variables are covered by the published prefixes
+      std::lock_guard<std::mutex> pvLock(_processVariablesMutex);
+      for(const auto& processVariable : _processVariablesByName) {
+        const auto& name = processVariable.first;
+        if(std::none_of(_initialValuesPublishedPrefixes.begin(), _initialValuesPublishedPrefixes.end(),
+               [&](const std::string& published) { return name.compare(0, published.size(), published) == 0; })) {
+          return;
+        }
+      }
+      _initialValuesPublished = true;
+    }
+    _initialValuesCondition.notify_all();
+  }
+
+  bool PVManager::waitForInitialValues(std::chrono::steady_clock::duration timeout) {
+    std::unique_lock<std::mutex> lock(_initialValuesMutex);
+    if(timeout == std::chrono::steady_clock::duration::max()) {
+      // wait_for() would overflow when computing the deadline
+      _initialValuesCondition.wait(lock, [&] { return _initialValuesPublished; });
+      return true;
+    }
+    return _initialValuesCondition.wait_for(lock, timeout, [&] { return _initialValuesPublished; });
+  }
+
   std::pair<shared_ptr<ControlSystemPVManager>, shared_ptr<DevicePVManager>> createPVManager() {
     // We cannot use boost::make_shared here, because we are using private
     // constructors.
@@ -7,12 +7,17 @@
 
 #include "PersistentDataStorage.h"
 
+#include "AdapterStatistics.h"
 #include "ApplicationBase.h"
+#include "StartupProfiler.h"
+#include "TransferTracer.h"
 #include <libxml++/libxml++.h>
 #include <sys/stat.h>
 
 #include <boost/lexical_cast.hpp>
 
+#include <chrono>
+
 namespace ChimeraTK {
 
   /*********************************************************************************************************************/
@@ -30,8 +35,7 @@ namespace ChimeraTK {
 
   PersistentDataStorage::~PersistentDataStorage() {
     try {
-      _writerThread.interrupt();
-      _writerThread.join();
+      stopWriterThread();
     }
     catch(...) {
       std::cerr << "Cannot join writer thread!" << std::endl;
@@ -41,55 +45,332 @@ namespace ChimeraTK {
 
   /*********************************************************************************************************************/
 
+  void PersistentDataStorage::stopWriterThread() {
+    {
+      std::lock_guard<std::mutex> lock(_scheduleMutex);
+      _shutdownRequested = true;
+    }
+    // a periodic write in progress is discarded, the file is written again at shutdown anyway
+    _abortPeriodicWrite = true;
+    _scheduleCondition.notify_all();
+    if(_writerThread.joinable()) {
+      _writerThread.join();
+    }
+  }
+
+  /*********************************************************************************************************************/
+
   void PersistentDataStorage::writerThreadFunction() {
-    while(true) {
-      for(unsigned int i = 0; i < _fileWriteInterval; ++i) {
-        sleep(1);
-        boost::this_thread::interruption_point();
+    std::unique_lock<std::mutex> lock(_scheduleMutex);
+    // the file is written by the destructor after the shutdown
+    while(!_shutdownRequested) {
+      // sleep until the next timer is due, or until woken up by a new timer or the shutdown
+      auto deadline = _timerWheel.nextDeadline();
+      if(deadline) {
+        _scheduleCondition.wait_until(lock, *deadline);
+      }
+      else {
+        _scheduleCondition.wait(lock);
+      }
+      if(_shutdownRequested) {
+        return;
+      }
+
+      bool writeRequired = false;
+      _timerWheel.advance(std::chrono::steady_clock::now(), [&](const PersistenceTimer& timer) {
+        if(timer.generation == _variableTimerGeneration[timer.id]) {
+          writeRequired |= getChangedFlag(timer.id)->load(std::memory_order_relaxed);
+        }
+      });
+      if(!writeRequired) {
+        continue; // spurious wake up, or only outdated timers
+      }
+
+      // Reset the flags before writing, so changes during the write will cause the next write. The fence pairs with the
+      // one in notifyValueUpdated(): either the update sees the cleared flag, or this write sees the updated value.
+      // Timers still pending for the cleared variables are invalidated, otherwise they would trigger the next write
+      // before the delay of the next change has passed.
+      for(size_t id = 0; id < _variablePolicies.size(); ++id) {
+        auto* changed = getChangedFlag(id);
+        if(_variablePolicies[id].mode != PersistencePolicy::Mode::shutdownOnly &&
+            changed->load(std::memory_order_relaxed)) {
+          changed->store(false, std::memory_order_relaxed);
+          ++_variableTimerGeneration[id];
+        }
+      }
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      lock.unlock();
+      writeToFile(false);
+      lock.lock();
+    }
+  }
+
+  /*********************************************************************************************************************/
+
+  void PersistentDataStorage::setPersistencePolicy(const ChimeraTK::RegisterPath& name, PersistencePolicy policy) {
+    auto strippedName = removeVariableNamePrefix(name);
+    std::lock_guard<std::mutex> queueLock(_queueReadMutex);
+    std::lock_guard<std::mutex> lock(_scheduleMutex);
+    _policiesByName[std::string(strippedName)] = policy;
+
+    // update the policy of an already registered variable
+    auto position = std::find(_variableNames.begin(), _variableNames.end(), strippedName);
+    if(position == _variableNames.end()) {
+      return;
+    }
+    size_t id = position - _variableNames.begin();
+    if(id < _variablePolicies.size() && _variableRegisteredFromApp[id]) {
+      setVariablePolicy(id, policy);
+    }
+  }
+
+  /*********************************************************************************************************************/
+
+  void PersistentDataStorage::setDefaultPersistencePolicy(PersistencePolicy policy) {
+    std::lock_guard<std::mutex> lock(_scheduleMutex);
+    _defaultPolicy = policy;
+  }
+
+  /*********************************************************************************************************************/
+
+  ChimeraTK::RegisterPath PersistentDataStorage::removeVariableNamePrefix(
+      const ChimeraTK::RegisterPath& variableName) const {
+    if(!_variableNamePrefix.empty() && _variableNamePrefix != "/") {
+      std::string fullName = variableName;
+      if(fullName.compare(0, _variableNamePrefix.size() + 1, _variableNamePrefix + "/") == 0) {
+        return fullName.substr(_variableNamePrefix.size());
       }
-      writeToFile();
     }
+    return variableName;
+  }
+
+  /*********************************************************************************************************************/
+
+  void PersistentDataStorage::applyPersistencePolicy(size_t id) {
+    std::lock_guard<std::mutex> lock(_scheduleMutex);
+    extendVariableState(id);
+
+    auto it = _policiesByName.find(std::string(_variableNames[id]));
+    setVariablePolicy(id, it != _policiesByName.end() ? it->second : _defaultPolicy);
+  }
+
+  /*********************************************************************************************************************/
+
+  void PersistentDataStorage::setVariablePolicy(size_t id, PersistencePolicy policy) {
+    _variablePolicies[id] = policy;
+    // invalidate running timers, they have been scheduled with the previous policy
+    ++_variableTimerGeneration[id];
+    if(getChangedFlag(id)->load(std::memory_order_relaxed)) {
+      scheduleWrite(id);
+    }
+  }
+
+  /*********************************************************************************************************************/
+
+  void PersistentDataStorage::extendVariableState(size_t id) {
+    if(id < _variablePolicies.size()) {
+      return;
+    }
+    if(id / changedFlagsChunkSize >= _variableChangedChunks.size()) {
+      throw ChimeraTK::logic_error("Too many variables in the PersistentDataStorage.");
+    }
+    while(_variableChangedStorage.size() <= id / changedFlagsChunkSize) {
+      auto& chunk = _variableChangedStorage.emplace_back(std::make_unique<std::atomic<bool>[]>(changedFlagsChunkSize));
+      _variableChangedChunks[_variableChangedStorage.size() - 1].store(chunk.get(), std::memory_order_release);
+    }
+    _variablePolicies.resize(id + 1, _defaultPolicy);
+    _variableTimerGeneration.resize(id + 1, 0);
+  }
+
+  /*********************************************************************************************************************/
+
+  std::atomic<bool>* PersistentDataStorage::getChangedFlag(size_t id) const {
+    if(id / changedFlagsChunkSize >= _variableChangedChunks.size()) {
+      return nullptr;
+    }
+    auto* chunk = _variableChangedChunks[id / changedFlagsChunkSize].load(std::memory_order_acquire);
+    return chunk ? chunk + id % changedFlagsChunkSize : nullptr;
+  }
+
+  /*********************************************************************************************************************/
+
+  void PersistentDataStorage::scheduleWrite(size_t id) {
+    const auto& policy = _variablePolicies[id];
+    if(policy.mode == PersistencePolicy::Mode::shutdownOnly) {
+      return;
+    }
+    auto delay = policy.mode == PersistencePolicy::Mode::periodic ? getPeriod(policy) : policy.interval;
+    _timerWheel.schedule(std::chrono::steady_clock::now() + delay, {id, _variableTimerGeneration[id]});
+    _scheduleCondition.notify_one();
+  }
+
+  /*********************************************************************************************************************/
+
+  void PersistentDataStorage::notifyValueUpdated(size_t id) {
+    // Fast path without the mutex: the variable is already scheduled for the next write. The value has been pushed
+    // before, the fence pairs with the one in writerThreadFunction() after clearing the flags.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    auto* changed = getChangedFlag(id);
+    if(changed && changed->load(std::memory_order_relaxed)) {
+      return;
+    }
+    std::lock_guard<std::mutex> lock(_scheduleMutex);
+    // the policy of the variable might not have been applied yet, the change must not be lost in that case
+    extendVariableState(id);
+    changed = getChangedFlag(id);
+    if(changed->load(std::memory_order_relaxed)) {
+      return;
+    }
+    changed->store(true, std::memory_order_relaxed);
+    scheduleWrite(id);
+  }
+
+  /*********************************************************************************************************************/
+
+  std::chrono::steady_clock::duration PersistentDataStorage::getPeriod(const PersistencePolicy& policy) const {
+    if(policy.interval.count() > 0) {
+      return policy.interval;
+    }
+    return std::chrono::seconds(_fileWriteInterval);
   }
 
   /*********************************************************************************************************************/
 
-  void PersistentDataStorage::writeToFile() noexcept {
+  namespace {
+
+    /** Size of the chunks passed to the AsyncFileWriter */
+    constexpr size_t persistencyFileChunkSize = 64 * 1024;
+
+    /** Append the value as XML attribute value, escaped the same way as libxml2 does it. */
+    void appendXmlAttributeValue(std::string& output, const std::string& value) {
+      for(char c : value) {
+        switch(c) {
+          case '&':
+            output += "&amp;";
+            break;
+          case '<':
+            output += "&lt;";
+            break;
+          case '>':
+            output += "&gt;";
+            break;
+          case '"':
+            output += "&quot;";
+            break;
+          case '\n':
+            output += "&#10;";
+            break;
+          case '\r':
+            output += "&#13;";
+            break;
+          case '\t':
+            output += "&#9;";
+            break;
+          default:
+            output += c;
+        }
+      }
+    }
+
+  } // namespace
+
+  /*********************************************************************************************************************/
+
+  void PersistentDataStorage::writeToFile(bool isShutdown) noexcept {
+    int64_t traceStart = detail::isTransferTracingEnabled() ? detail::traceClock() : 0;
+    auto flushStart = std::chrono::steady_clock::now();
     try {
-      // create XML document with root node and a flat list of variables below this root
-      xmlpp::Document doc;
-      xmlpp::Element* rootElement =
-          doc.create_root_node("PersistentData", "https://github.com/ChimeraTK/ControlSystemAdapter");
-      rootElement->set_attribute("application", _applicationName);
+      std::vector<PersistencePolicy> policies;
+      {
+        std::lock_guard<std::mutex> lock(_scheduleMutex);
+        policies = _variablePolicies;
+      }
 
+      // The XML document is generated directly in the format written by libxml++ (root node and a flat list of
+      // variables below this root), so the file can be passed to the writer in chunks while the rest is generated.
+      _fileWriter.open(_filename);
+      std::string chunk;
+      chunk.reserve(persistencyFileChunkSize);
+      chunk += "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+               "<PersistentData xmlns=\"https://github.com/ChimeraTK/ControlSystemAdapter\" application=\"";
+      appendXmlAttributeValue(chunk, _applicationName);
+      chunk += "\"";
+
+      bool hasVariables = false;
       for(size_t i = 0; i < _variableNames.size(); ++i) {
+        if(!isShutdown && _abortPeriodicWrite.load(std::memory_order_relaxed)) {
+          _fileWriter.abort();
+          return;
+        }
         if(!_variableRegisteredFromApp[i]) {
           continue; // exclude variables no longer present in the application
         }
+        if(!hasVariables) {
+          chunk += ">\n";
+          hasVariables = true;
+        }
 
-        // create XML element for the variable and set name attribute
-        xmlpp::Element* variable = rootElement->add_child("variable");
-        variable->set_attribute("name", static_cast<std::string>(_variableNames[i]));
-
-        // generate value XML tags and set type name as a string
+        // create XML element for the variable with name and type attribute
         DataType dataType(*_variableTypes[i]);
+        chunk += "  <variable name=\"";
+        appendXmlAttributeValue(chunk, static_cast<std::string>(_variableNames[i]));
+        chunk += "\" type=\"";
+        appendXmlAttributeValue(chunk, dataType.getAsString());
+        chunk += "\"";
+
+        // generate value XML tags
+        size_t sizeBefore = chunk.size();
+        chunk += ">\n";
+        bool keepStoredValue =
+            !isShutdown && i < policies.size() && policies[i].mode == PersistencePolicy::Mode::shutdownOnly;
         callForType(dataType, [&](auto t) {
           using UserType = decltype(t);
-          generateXmlValueTags<UserType>(variable, i);
+          generateXmlValueTags<UserType>(chunk, i, keepStoredValue);
         });
+        if(chunk.size() == sizeBefore + 2) {
+          chunk.replace(sizeBefore, 2, "/>\n");
+        }
+        else {
+          chunk += "  </variable>\n";
+        }
+
+        // pass full chunks to the writer
+        if(chunk.size() >= persistencyFileChunkSize) {
+          _fileWriter.append(std::move(chunk));
+          chunk = std::string();
+          chunk.reserve(persistencyFileChunkSize);
+        }
+      }
+      chunk += hasVariables ? "</PersistentData>\n" : "/>\n";
+      _fileWriter.append(std::move(chunk));
+
+      // wait until the file is written and replace the old file
+      _fileWriter.commit();
 
-        // set type attribute
-        variable->set_attribute("type", dataType.getAsString());
+      if(traceStart != 0) {
+        if(_traceNameId == detail::invalidTraceNameId) {
+          _traceNameId = detail::internTraceName(_filename);
+        }
+        detail::recordTraceComplete("persist", _traceNameId, traceStart, "nVariables",
+            static_cast<int64_t>(_variableNames.size()));
       }
 
-      // write out to file
-      auto tempfile = _filename + ".new";
-      doc.write_to_file_formatted(tempfile);
-      std::rename(tempfile.c_str(), _filename.c_str());
+      if(detail::adapterStatisticsEnabled) {
+        auto duration =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - flushStart);
+        detail::adapterStatisticsCounters.persistenceFlushDuration = static_cast<uint64_t>(duration.count());
+        struct stat fileStatus {};
+        if(stat(_filename.c_str(), &fileStatus) == 0) {
+          detail::adapterStatisticsCounters.persistenceFileSize = static_cast<uint64_t>(fileStatus.st_size);
+        }
+      }
     }
     catch(const std::exception& e) {
+      _fileWriter.abort();
       std::cerr << "Error writing persistency file: " << e.what() << std::endl;
     }
     catch(...) {
+      _fileWriter.abort();
       std::cerr << "Error writing persistency file (unknown exception)" << std::endl;
     }
   }
@@ -97,25 +378,29 @@ namespace ChimeraTK {
   /*********************************************************************************************************************/
 
   template<typename UserType>
-  void PersistentDataStorage::generateXmlValueTags(xmlpp::Element* parent, size_t id) {
+  void PersistentDataStorage::generateXmlValueTags(std::string& output, size_t id, bool keepStoredValue) {
     std::vector<UserType>* pValue;
     {
       // obtain the data vector from the map
       std::lock_guard<std::mutex> lock(_queueReadMutex);
-      auto& value = boost::fusion::at_key<UserType>(_dataMap.table)[id].readLatest();
-      pValue = &value;
+      auto& queue = boost::fusion::at_key<UserType>(_dataMap.table)[id];
+      pValue = keepStoredValue ? &queue.getStored() : &queue.readLatest();
     }
     // add one child element per element of the value
     for(size_t idx = 0; idx < pValue->size(); ++idx) {
-      xmlpp::Element* valueElement = parent->add_child("val");
-      valueElement->set_attribute("i", userTypeToUserType<std::string>(idx));
-      valueElement->set_attribute("v", userTypeToUserType<std::string>((*pValue)[idx]));
+      output += "    <val i=\"";
+      output += userTypeToUserType<std::string>(idx);
+      output += "\" v=\"";
+      appendXmlAttributeValue(output, userTypeToUserType<std::string>((*pValue)[idx]));
+      output += "\"/>\n";
     }
   }
 
   /*********************************************************************************************************************/
 
   void PersistentDataStorage::readFromFile() {
+    StartupPhase phase("PersistentDataStorage::readFromFile");
+
     // check if file exists
     struct stat buffer {};
     if(stat(_filename.c_str(), &buffer) != 0) {
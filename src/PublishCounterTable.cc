@@ -0,0 +1,112 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "PublishCounterTable.h"
+
+#include "ControlSystemPVManager.h"
+
+#include <ChimeraTK/Exception.h>
+
+#include <algorithm>
+
+#ifdef __SSE2__
+#  include <emmintrin.h>
+#endif
+
+namespace ChimeraTK {
+
+  /*********************************************************************************************************************/
+
+  PublishCounterTable::Counter& PublishCounterTable::add(
+      const ProcessVariable::SharedPtr& controlSystemProcessVariable) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto index = _processVariables.size();
+    auto chunkIndex = index / chunkSize;
+    if(chunkIndex >= maxChunks) {
+      throw ChimeraTK::logic_error("PublishCounterTable: Too many process variables.");
+    }
+    if(index % chunkSize == 0) {
+      _chunkStorage.push_back(std::make_unique<Chunk>());
+      _chunks[chunkIndex].store(_chunkStorage.back().get(), std::memory_order_release);
+    }
+    _processVariables.push_back(controlSystemProcessVariable);
+    _size.store(index + 1, std::memory_order_release);
+    return _chunks[chunkIndex].load(std::memory_order_relaxed)->counters[index % chunkSize];
+  }
+
+  /*********************************************************************************************************************/
+
+  ProcessVariable::SharedPtr PublishCounterTable::getProcessVariable(size_t index) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _processVariables.at(index);
+  }
+
+  /*********************************************************************************************************************/
+  /*********************************************************************************************************************/
+
+  PublishCounterScanner::PublishCounterScanner(boost::shared_ptr<ControlSystemPVManager> pvManager)
+  : _pvManager(std::move(pvManager)), _table(_pvManager->getPublishCounterTable()) {}
+
+  /*********************************************************************************************************************/
+
+  std::vector<size_t> PublishCounterScanner::scan() {
+    std::vector<size_t> changedIndices;
+    scan(changedIndices);
+    return changedIndices;
+  }
+
+  /*********************************************************************************************************************/
+
+  void PublishCounterScanner::scan(std::vector<size_t>& changedIndices) {
+    auto size = _table.size();
+    auto nChunks = (size + PublishCounterTable::chunkSize - 1) / PublishCounterTable::chunkSize;
+    while(_lastSeen.size() < nChunks) {
+      // the counters of process variables added since the last scan start at zero
+      _lastSeen.push_back(std::make_unique<uint64_t[]>(PublishCounterTable::chunkSize));
+    }
+    for(size_t i = 0; i < nChunks; ++i) {
+      auto firstIndex = i * PublishCounterTable::chunkSize;
+      scanChunk(_table.getChunk(i), _lastSeen[i].get(), std::min(size - firstIndex, PublishCounterTable::chunkSize),
+          firstIndex, changedIndices);
+    }
+  }
+
+  /*********************************************************************************************************************/
+
+  void PublishCounterScanner::scanChunk(const PublishCounterTable::Chunk& chunk, uint64_t* lastSeen, size_t nCounters,
+      size_t firstIndex, std::vector<size_t>& changedIndices) {
+    const auto& counters = chunk.counters;
+    auto compare = [&](size_t k) {
+      auto value = counters[k].load(std::memory_order_relaxed);
+      if(value != lastSeen[k]) {
+        lastSeen[k] = value;
+        changedIndices.push_back(firstIndex + k);
+      }
+    };
+
+    size_t k = 0;
+#ifdef __SSE2__
+    // Compare four counters per iteration and only look at the individual counters if any of them differs. The chunk
+    // is 64 byte aligned and aligned 8 byte accesses are atomic on x86, so each counter is read like a relaxed load.
+    const auto* current = reinterpret_cast<const __m128i*>(counters.data());
+    const auto* previous = reinterpret_cast<const __m128i*>(lastSeen);
+    const auto zero = _mm_setzero_si128();
+    for(; k + 4 <= nCounters; k += 4) {
+      auto difference = _mm_or_si128(_mm_xor_si128(_mm_load_si128(current + k / 2), _mm_loadu_si128(previous + k / 2)),
+          _mm_xor_si128(_mm_load_si128(current + k / 2 + 1), _mm_loadu_si128(previous + k / 2 + 1)));
+      if(_mm_movemask_epi8(_mm_cmpeq_epi8(difference, zero)) == 0xFFFF) {
+        continue;
+      }
+      for(size_t j = k; j < k + 4; ++j) {
+        compare(j);
+      }
+    }
+#endif
+    for(; k < nCounters; ++k) {
+      compare(k);
+    }
+  }
+
+  /*********************************************************************************************************************/
+
+} // namespace ChimeraTK
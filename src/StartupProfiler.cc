@@ -0,0 +1,160 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "StartupProfiler.h"
+
+#include <ctime>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <mutex>
+
+namespace ChimeraTK {
+
+  namespace detail {
+    std::atomic<bool> startupProfilingEnabled;
+  } // namespace detail
+
+  namespace {
+
+    /*******************************************************************************************************************/
+
+    /** Accumulated times in nanoseconds */
+    struct PhaseRecord {
+      const char* name;
+      size_t count;
+      int64_t wallTime;
+      int64_t cpuTime;
+    };
+
+    struct ProfileRegistry {
+      std::mutex mutex;
+      std::vector<PhaseRecord> phases; // only a handful of phases, so a linear search is fine
+    };
+
+    ProfileRegistry& registry() {
+      static ProfileRegistry theRegistry;
+      return theRegistry;
+    }
+
+    /*******************************************************************************************************************/
+
+    int64_t wallClock() {
+      return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+          .count();
+    }
+
+    /*******************************************************************************************************************/
+
+    int64_t threadCpuClock() {
+      timespec ts{};
+      clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+      return int64_t(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+    }
+
+    /*******************************************************************************************************************/
+
+  } // namespace
+
+  /*********************************************************************************************************************/
+
+  void setEnableStartupProfiling(bool enable) {
+    detail::startupProfilingEnabled = enable;
+  }
+
+  /*********************************************************************************************************************/
+
+  StartupPhase::StartupPhase(const char* name) : _name(nullptr) {
+    if(!detail::startupProfilingEnabled.load(std::memory_order_relaxed)) {
+      return;
+    }
+    _name = name;
+    _cpuStart = threadCpuClock();
+    _wallStart = wallClock();
+  }
+
+  /*********************************************************************************************************************/
+
+  StartupPhase::~StartupPhase() {
+    if(!_name) {
+      return;
+    }
+    auto wallTime = wallClock() - _wallStart;
+    auto cpuTime = threadCpuClock() - _cpuStart;
+
+    auto& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    for(auto& phase : reg.phases) {
+      if(phase.name == _name || std::strcmp(phase.name, _name) == 0) {
+        ++phase.count;
+        phase.wallTime += wallTime;
+        phase.cpuTime += cpuTime;
+        return;
+      }
+    }
+    reg.phases.push_back({_name, 1, wallTime, cpuTime});
+  }
+
+  /*********************************************************************************************************************/
+
+  std::vector<StartupPhaseStatistics> getStartupProfile() {
+    auto& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    std::vector<StartupPhaseStatistics> profile;
+    profile.reserve(reg.phases.size());
+    for(auto& phase : reg.phases) {
+      profile.push_back({phase.name, phase.count, double(phase.wallTime) / 1e9, double(phase.cpuTime) / 1e9});
+    }
+    return profile;
+  }
+
+  /*********************************************************************************************************************/
+
+  void printStartupProfile(std::ostream& stream) {
+    auto profile = getStartupProfile();
+    size_t nameWidth = 5;
+    for(auto& phase : profile) {
+      nameWidth = std::max(nameWidth, phase.name.size());
+    }
+
+    auto flags = stream.flags();
+    auto precision = stream.precision();
+    stream << "Startup profile:" << std::endl;
+    stream << "  " << std::left << std::setw(int(nameWidth)) << "Phase" << std::right << std::setw(10) << "Count"
+           << std::setw(14) << "Wall [s]" << std::setw(14) << "CPU [s]" << std::endl;
+    for(auto& phase : profile) {
+      stream << "  " << std::left << std::setw(int(nameWidth)) << phase.name << std::right << std::setw(10)
+             << phase.count << std::fixed << std::setprecision(6) << std::setw(14) << phase.wallTime << std::setw(14)
+             << phase.cpuTime << std::endl;
+    }
+    stream.flags(flags);
+    stream.precision(precision);
+  }
+
+  /*********************************************************************************************************************/
+
+  void writeStartupProfileCsv(std::ostream& stream) {
+    auto flags = stream.flags();
+    auto precision = stream.precision();
+    stream << "phase,count,wallTime,cpuTime" << std::endl;
+    for(auto& phase : getStartupProfile()) {
+      stream << phase.name << "," << phase.count << "," << std::fixed << std::setprecision(9) << phase.wallTime << ","
+             << phase.cpuTime << std::endl;
+    }
+    stream.flags(flags);
+    stream.precision(precision);
+  }
+
+  /*********************************************************************************************************************/
+
+  void clearStartupProfile() {
+    auto& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    reg.phases.clear();
+  }
+
+  /*********************************************************************************************************************/
+
+} // namespace ChimeraTK
@@ -0,0 +1,149 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "SynchronisationExecutor.h"
+
+#include <ChimeraTK/Exception.h>
+
+#include <algorithm>
+#include <mutex>
+
+namespace ChimeraTK {
+
+  /*********************************************************************************************************************/
+
+  SynchronisationExecutor::GroupLock::GroupLock(GroupLock&& other) noexcept
+  : _mutexes(std::move(other._mutexes)), _mode(other._mode) {
+    other._mutexes.clear();
+  }
+
+  /*********************************************************************************************************************/
+
+  SynchronisationExecutor::GroupLock& SynchronisationExecutor::GroupLock::operator=(GroupLock&& other) noexcept {
+    if(this != &other) {
+      unlock();
+      _mutexes = std::move(other._mutexes);
+      other._mutexes.clear();
+      _mode = other._mode;
+    }
+    return *this;
+  }
+
+  /*********************************************************************************************************************/
+
+  void SynchronisationExecutor::GroupLock::unlock() {
+    for(auto it = _mutexes.rbegin(); it != _mutexes.rend(); ++it) {
+      if(_mode == AccessMode::readOnly) {
+        (*it)->unlock_shared();
+      }
+      else {
+        (*it)->unlock();
+      }
+    }
+    _mutexes.clear();
+  }
+
+  /*********************************************************************************************************************/
+
+  void SynchronisationExecutor::addToGroup(
+      const ChimeraTK::RegisterPath& group, const ChimeraTK::RegisterPath& processVariableName) {
+    std::unique_lock<std::shared_mutex> lock(_mapMutex);
+    auto& groups = _processVariableGroups[std::string(processVariableName)];
+    if(std::find(groups.begin(), groups.end(), group) == groups.end()) {
+      groups.push_back(group);
+    }
+    auto& groupMutex = _groupMutexes[std::string(group)];
+    if(!groupMutex) {
+      groupMutex = std::make_unique<std::shared_mutex>();
+    }
+  }
+
+  /*********************************************************************************************************************/
+
+  std::vector<ChimeraTK::RegisterPath> SynchronisationExecutor::getGroups(
+      const ChimeraTK::RegisterPath& processVariableName) const {
+    std::shared_lock<std::shared_mutex> lock(_mapMutex);
+    auto it = _processVariableGroups.find(std::string(processVariableName));
+    if(it == _processVariableGroups.end()) {
+      return {};
+    }
+    return it->second;
+  }
+
+  /*********************************************************************************************************************/
+
+  SynchronisationExecutor::GroupLock SynchronisationExecutor::lock(
+      const std::vector<ChimeraTK::RegisterPath>& groups, AccessMode mode) {
+    // Sort the group names, which defines the locking order. Duplicates would deadlock, so they are removed.
+    std::vector<std::string> names;
+    names.reserve(groups.size());
+    for(const auto& group : groups) {
+      names.emplace_back(group);
+    }
+    std::sort(names.begin(), names.end());
+    names.erase(std::unique(names.begin(), names.end()), names.end());
+
+    // look up the mutexes, create missing groups
+    std::vector<std::shared_mutex*> mutexes;
+    mutexes.reserve(names.size());
+    {
+      std::shared_lock<std::shared_mutex> mapLock(_mapMutex);
+      for(const auto& name : names) {
+        auto it = _groupMutexes.find(name);
+        if(it == _groupMutexes.end()) {
+          break;
+        }
+        mutexes.push_back(it->second.get());
+      }
+    }
+    if(mutexes.size() < names.size()) {
+      mutexes.clear();
+      std::unique_lock<std::shared_mutex> mapLock(_mapMutex);
+      for(const auto& name : names) {
+        auto& groupMutex = _groupMutexes[name];
+        if(!groupMutex) {
+          groupMutex = std::make_unique<std::shared_mutex>();
+        }
+        mutexes.push_back(groupMutex.get());
+      }
+    }
+
+    // acquire the locks, the map lock is not held, so blocking here does not affect other groups
+    for(auto* mutex : mutexes) {
+      if(mode == AccessMode::readOnly) {
+        mutex->lock_shared();
+      }
+      else {
+        mutex->lock();
+      }
+    }
+    return {std::move(mutexes), mode};
+  }
+
+  /*********************************************************************************************************************/
+
+  SynchronisationExecutor::GroupLock SynchronisationExecutor::lockProcessVariables(
+      const std::vector<ChimeraTK::RegisterPath>& processVariableNames, AccessMode mode) {
+    std::vector<ChimeraTK::RegisterPath> groups;
+    for(const auto& name : processVariableNames) {
+      auto pvGroups = getGroups(name);
+      if(pvGroups.empty()) {
+        throw ChimeraTK::logic_error(
+            "Process variable '" + std::string(name) + "' has not been assigned to a synchronisation group.");
+      }
+      groups.insert(groups.end(), pvGroups.begin(), pvGroups.end());
+    }
+    return lock(groups, mode);
+  }
+
+  /*********************************************************************************************************************/
+
+  void SynchronisationExecutor::execute(
+      const std::vector<ChimeraTK::RegisterPath>& groups, const std::function<void()>& function, AccessMode mode) {
+    auto groupLock = lock(groups, mode);
+    function();
+  }
+
+  /*********************************************************************************************************************/
+
+} // namespace ChimeraTK
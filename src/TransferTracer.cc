@@ -0,0 +1,384 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "TransferTracer.h"
+
+#include <ChimeraTK/Exception.h>
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace ChimeraTK {
+
+  namespace detail {
+    std::atomic<bool> transferTracingEnabled;
+  } // namespace detail
+
+  namespace {
+
+    /*******************************************************************************************************************/
+
+    /** A single recorded event. Category and argument name point to string literals. */
+    struct TraceEvent {
+      int64_t start{0};
+      int64_t end{0};
+      const char* category{nullptr};
+      const char* argName{nullptr};
+      int64_t arg{0};
+      uint32_t nameId{detail::invalidTraceNameId};
+      char phase{'X'};
+    };
+
+    /*******************************************************************************************************************/
+
+    /** Slot of the ring buffer holding one event. The owning thread writes the slot while the dump may read it, so all
+     *  fields are atomics protected by a sequence number (seqlock). The sequence is the index of the stored event plus
+     *  one once the event is complete, and zero while the slot is being overwritten. */
+    struct TraceSlot {
+      void store(const TraceEvent& event, uint64_t index) {
+        sequence.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        start.store(event.start, std::memory_order_relaxed);
+        end.store(event.end, std::memory_order_relaxed);
+        category.store(event.category, std::memory_order_relaxed);
+        argName.store(event.argName, std::memory_order_relaxed);
+        arg.store(event.arg, std::memory_order_relaxed);
+        nameId.store(event.nameId, std::memory_order_relaxed);
+        phase.store(event.phase, std::memory_order_relaxed);
+        sequence.store(index + 1, std::memory_order_release);
+      }
+
+      /** Copy the event with the given index. Returns false if the slot does not (or no longer) hold this event. */
+      bool load(TraceEvent& event, uint64_t index) const {
+        if(sequence.load(std::memory_order_acquire) != index + 1) {
+          return false;
+        }
+        event.start = start.load(std::memory_order_relaxed);
+        event.end = end.load(std::memory_order_relaxed);
+        event.category = category.load(std::memory_order_relaxed);
+        event.argName = argName.load(std::memory_order_relaxed);
+        event.arg = arg.load(std::memory_order_relaxed);
+        event.nameId = nameId.load(std::memory_order_relaxed);
+        event.phase = phase.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return sequence.load(std::memory_order_relaxed) == index + 1;
+      }
+
+      std::atomic<uint64_t> sequence{0};
+      std::atomic<int64_t> start{0};
+      std::atomic<int64_t> end{0};
+      std::atomic<const char*> category{nullptr};
+      std::atomic<const char*> argName{nullptr};
+      std::atomic<int64_t> arg{0};
+      std::atomic<uint32_t> nameId{detail::invalidTraceNameId};
+      std::atomic<char> phase{'X'};
+    };
+
+    /*******************************************************************************************************************/
+
+    /** Ring buffer of events recorded by a single thread. Only the owning thread writes to it, the dump functions only
+     *  read. When the buffer is full, the oldest events are overwritten. */
+    struct ThreadTraceBuffer {
+      explicit ThreadTraceBuffer(uint32_t id) : threadId(id), events(capacity) {}
+
+      static constexpr uint64_t capacity{16384};
+
+      void record(const TraceEvent& event) {
+        auto h = head.load(std::memory_order_relaxed);
+        events[h % capacity].store(event, h);
+        head.store(h + 1, std::memory_order_release);
+      }
+
+      /** Sequential number of the thread, used as tid in the trace output. */
+      uint32_t threadId;
+
+      std::vector<TraceSlot> events;
+
+      /** Total number of events ever recorded into this buffer. */
+      std::atomic<uint64_t> head{0};
+
+      /** Value of head when clearTransferTrace() was called last. Events before are no longer reported. */
+      std::atomic<uint64_t> clearedUpTo{0};
+    };
+
+    /*******************************************************************************************************************/
+
+    struct TraceRegistry;
+
+    void writeTrace(TraceRegistry& reg, std::ostream& stream);
+
+    /** Global registry of all thread buffers and interned names. It is never destroyed, since threads which are still
+     *  running at exit (e.g. detached threads) may record events until the very end. */
+    struct TraceRegistry {
+      std::mutex mutex;
+      std::vector<std::shared_ptr<ThreadTraceBuffer>> buffers;
+      std::vector<std::string> names;
+      std::unordered_map<std::string, uint32_t> nameIds;
+      std::string fileAtExit;
+
+      /** Number of threads with a buffer which have not terminated yet */
+      size_t nRunningThreads{0};
+
+      int64_t epoch{detail::traceClock()};
+    };
+
+    TraceRegistry& registry() {
+      static auto* theRegistry = new TraceRegistry; // intentionally leaked, see TraceRegistry
+      return *theRegistry;
+    }
+
+    /*******************************************************************************************************************/
+
+    /** Write the trace to the file set with setTransferTraceFileAtExit() and clear the file name, so it is written only
+     *  once. The caller must hold the registry mutex. Returns whether the file has been written. */
+    bool writeTraceFile(TraceRegistry& reg) {
+      auto fileName = std::move(reg.fileAtExit);
+      reg.fileAtExit.clear();
+      std::ofstream file(fileName);
+      if(!file) {
+        std::cerr << "ChimeraTK::TransferTracer: Cannot write trace file '" << fileName << "'." << std::endl;
+        return false;
+      }
+      writeTrace(reg, file);
+      return true;
+    }
+
+    /*******************************************************************************************************************/
+
+    /** Writes the trace file at exit, unless dumpTransferTrace() has written it already. Threads still running at this
+     *  point could record into their buffers while they are dumped, so the file is only written if all threads which
+     *  have recorded events have terminated. */
+    struct TraceFileAtExit {
+      TraceFileAtExit() = default;
+      TraceFileAtExit(const TraceFileAtExit&) = delete;
+      TraceFileAtExit& operator=(const TraceFileAtExit&) = delete;
+
+      ~TraceFileAtExit() {
+        auto& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        if(reg.fileAtExit.empty()) {
+          return;
+        }
+        if(reg.nRunningThreads != 0) {
+          std::cerr << "ChimeraTK::TransferTracer: Not writing trace file '" << reg.fileAtExit << "' at exit, "
+                    << reg.nRunningThreads << " threads are still running. Call dumpTransferTrace() before."
+                    << std::endl;
+          return;
+        }
+        writeTraceFile(reg);
+      }
+    };
+
+    /*******************************************************************************************************************/
+
+    /** Thread-local owner of the buffer of a thread. The registry keeps a reference as well, so the events of
+     *  terminated threads are still available for the dump. */
+    struct ThreadBufferOwner {
+      ThreadBufferOwner() {
+        auto& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        buffer = std::make_shared<ThreadTraceBuffer>(static_cast<uint32_t>(reg.buffers.size()));
+        reg.buffers.push_back(buffer);
+        ++reg.nRunningThreads;
+      }
+
+      ~ThreadBufferOwner() {
+        auto& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        --reg.nRunningThreads;
+      }
+
+      ThreadBufferOwner(const ThreadBufferOwner&) = delete;
+      ThreadBufferOwner& operator=(const ThreadBufferOwner&) = delete;
+
+      std::shared_ptr<ThreadTraceBuffer> buffer;
+    };
+
+    ThreadTraceBuffer& threadBuffer() {
+      thread_local ThreadBufferOwner owner;
+      return *owner.buffer;
+    }
+
+    /*******************************************************************************************************************/
+
+    void writeJsonString(std::ostream& stream, const std::string& text) {
+      stream << '"';
+      for(char c : text) {
+        if(c == '"' || c == '\\') {
+          stream << '\\' << c;
+        }
+        else if(static_cast<unsigned char>(c) < 0x20) {
+          stream << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec;
+        }
+        else {
+          stream << c;
+        }
+      }
+      stream << '"';
+    }
+
+    /*******************************************************************************************************************/
+
+    void writeMicroseconds(std::ostream& stream, int64_t nanoseconds) {
+      // events may have been started shortly before the registry was created
+      nanoseconds = std::max(nanoseconds, int64_t(0));
+      stream << nanoseconds / 1000 << '.' << std::setw(3) << std::setfill('0') << nanoseconds % 1000;
+    }
+
+    /*******************************************************************************************************************/
+
+    /** Write the trace of all buffers. The caller must hold the registry mutex. */
+    void writeTrace(TraceRegistry& reg, std::ostream& stream) {
+      auto pid = getpid();
+
+      stream << "{\"traceEvents\":[";
+      bool first = true;
+      auto separator = [&] {
+        if(!first) {
+          stream << ",\n";
+        }
+        first = false;
+      };
+
+      for(auto& buffer : reg.buffers) {
+        separator();
+        stream << R"({"name":"thread_name","ph":"M","pid":)" << pid << ",\"tid\":" << buffer->threadId
+               << R"(,"args":{"name":"thread )" << buffer->threadId << "\"}}";
+
+        uint64_t head = buffer->head.load(std::memory_order_acquire);
+        uint64_t begin = buffer->clearedUpTo.load(std::memory_order_relaxed);
+        if(head > ThreadTraceBuffer::capacity && begin < head - ThreadTraceBuffer::capacity) {
+          begin = head - ThreadTraceBuffer::capacity;
+        }
+        TraceEvent event;
+        for(uint64_t i = begin; i < head; ++i) {
+          // skip events which the owning thread is overwriting concurrently
+          if(!buffer->events[i % ThreadTraceBuffer::capacity].load(event, i)) {
+            continue;
+          }
+          separator();
+          stream << "{\"name\":";
+          writeJsonString(stream, event.nameId < reg.names.size() ? reg.names[event.nameId] : std::string("unknown"));
+          stream << ",\"cat\":\"" << event.category << "\",\"ph\":\"" << event.phase << "\",\"ts\":";
+          writeMicroseconds(stream, event.start - reg.epoch);
+          if(event.phase == 'X') {
+            stream << ",\"dur\":";
+            writeMicroseconds(stream, event.end - event.start);
+          }
+          else {
+            stream << ",\"s\":\"t\"";
+          }
+          stream << ",\"pid\":" << pid << ",\"tid\":" << buffer->threadId;
+          if(event.argName) {
+            stream << ",\"args\":{\"" << event.argName << "\":" << event.arg << "}";
+          }
+          stream << "}";
+        }
+      }
+      stream << "],\"displayTimeUnit\":\"ns\"}\n";
+    }
+
+  } // namespace
+
+  /*********************************************************************************************************************/
+
+  int64_t detail::traceClock() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+  }
+
+  /*********************************************************************************************************************/
+
+  uint32_t detail::internTraceName(const std::string& name) {
+    auto& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    auto it = reg.nameIds.find(name);
+    if(it != reg.nameIds.end()) {
+      return it->second;
+    }
+    auto id = static_cast<uint32_t>(reg.names.size());
+    reg.names.push_back(name);
+    reg.nameIds[name] = id;
+    return id;
+  }
+
+  /*********************************************************************************************************************/
+
+  void detail::recordTraceComplete(
+      const char* category, uint32_t nameId, int64_t startTime, const char* argName, int64_t arg) {
+    threadBuffer().record({startTime, traceClock(), category, argName, arg, nameId, 'X'});
+  }
+
+  /*********************************************************************************************************************/
+
+  void detail::recordTraceInstant(const char* category, uint32_t nameId, const char* argName, int64_t arg) {
+    auto now = traceClock();
+    threadBuffer().record({now, now, category, argName, arg, nameId, 'i'});
+  }
+
+  /*********************************************************************************************************************/
+
+  void setEnableTransferTracing(bool enable) {
+    detail::transferTracingEnabled = enable;
+  }
+
+  /*********************************************************************************************************************/
+
+  void writeTransferTrace(std::ostream& stream) {
+    auto& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    writeTrace(reg, stream);
+  }
+
+  /*********************************************************************************************************************/
+
+  void writeTransferTraceToFile(const std::string& fileName) {
+    std::ofstream file(fileName);
+    if(!file) {
+      throw ChimeraTK::runtime_error("Cannot open trace file '" + fileName + "' for writing.");
+    }
+    writeTransferTrace(file);
+  }
+
+  /*********************************************************************************************************************/
+
+  void setTransferTraceFileAtExit(const std::string& fileName) {
+    static TraceFileAtExit writeAtExit;
+    auto& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    reg.fileAtExit = fileName;
+  }
+
+  /*********************************************************************************************************************/
+
+  bool dumpTransferTrace() {
+    auto& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    if(reg.fileAtExit.empty()) {
+      return false;
+    }
+    return writeTraceFile(reg);
+  }
+
+  /*********************************************************************************************************************/
+
+  void clearTransferTrace() {
+    auto& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    for(auto& buffer : reg.buffers) {
+      buffer->clearedUpTo = buffer->head.load(std::memory_order_acquire);
+    }
+  }
+
+  /*********************************************************************************************************************/
+
+} // namespace ChimeraTK
@@ -1,8 +1,49 @@
 #include "ProcessArray.h"
+#include "UnidirectionalProcessArray.h"
+
+#include <sys/mman.h>
 
 namespace ChimeraTK {
   namespace detail {
     std::atomic<bool> processArrayEnableThreadSafetyCheck;
+    std::atomic<size_t> processArrayHugePageThreshold{0};
+
+    bool adviseLargeBuffer(void* data, size_t sizeInBytes) {
+      auto threshold = processArrayHugePageThreshold.load(std::memory_order_relaxed);
+      if(threshold == 0 || sizeInBytes < threshold) {
+        return false;
+      }
+
+      // Only complete huge pages can be backed by huge pages, so the range is shrunk to huge page boundaries. 2 MiB is
+      // the transparent huge page size with 4 KiB base pages (x86-64 and most other platforms). Large allocations are
+      // served by mmap inside the allocator, so at most one partial huge page is cut off at each end.
+      constexpr uintptr_t hugePageSize = 2 << 20;
+      auto begin = (reinterpret_cast<uintptr_t>(data) + hugePageSize - 1) & ~(hugePageSize - 1);
+      auto end = (reinterpret_cast<uintptr_t>(data) + sizeInBytes) & ~(hugePageSize - 1);
+      if(end <= begin) {
+        return false;
+      }
+      auto* alignedData = reinterpret_cast<char*>(begin);
+      auto alignedSize = end - begin;
+
+      bool accepted = madvise(alignedData, alignedSize, MADV_HUGEPAGE) == 0;
+
+#ifdef MADV_COLLAPSE
+      // The buffers have already been initialised (and hence faulted in) by the vector before the advice was given, so
+      // ask the kernel to collapse them into huge pages right away instead of waiting for khugepaged. Failures are not
+      // fatal, the memory is still usable.
+      if(accepted) {
+        (void)madvise(alignedData, alignedSize, MADV_COLLAPSE);
+      }
+#endif
+
+      return accepted;
+    }
   } // namespace detail
+
   void setEnableProcessArrayThreadSafetyCheck(bool enable) { detail::processArrayEnableThreadSafetyCheck = enable; }
+
+  void setProcessArrayHugePageThreshold(size_t thresholdInBytes) {
+    detail::processArrayHugePageThreshold = thresholdInBytes;
+  }
 } // namespace ChimeraTK
@@ -0,0 +1,237 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "UpdateFunctionScheduler.h"
+
+#include <ChimeraTK/Exception.h>
+
+#include <iostream>
+
+namespace ChimeraTK {
+
+  /*********************************************************************************************************************/
+
+  UpdateFunctionScheduler::UpdateFunctionScheduler(
+      size_t nWorkers, std::chrono::microseconds resolution, SynchronisationExecutor* executor)
+  : _executor(executor), _timerWheel(resolution) {
+    if(nWorkers == 0) {
+      throw ChimeraTK::logic_error("UpdateFunctionScheduler needs at least one worker thread.");
+    }
+    _timerThread = std::thread([this] { timerThreadFunction(); });
+    for(size_t i = 0; i < nWorkers; ++i) {
+      _workerThreads.emplace_back([this] { workerThreadFunction(); });
+    }
+  }
+
+  /*********************************************************************************************************************/
+
+  UpdateFunctionScheduler::~UpdateFunctionScheduler() {
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _shutdown = true;
+    }
+    _timerCondition.notify_all();
+    _workerCondition.notify_all();
+    _timerThread.join();
+    for(auto& worker : _workerThreads) {
+      worker.join();
+    }
+  }
+
+  /*********************************************************************************************************************/
+
+  UpdateFunctionScheduler::FunctionId UpdateFunctionScheduler::addPeriodicFunction(
+      Clock::duration period, std::function<void()> function, std::vector<ChimeraTK::RegisterPath> groups) {
+    if(period <= Clock::duration::zero()) {
+      throw ChimeraTK::logic_error("UpdateFunctionScheduler: the period must be positive.");
+    }
+    auto entry = std::make_shared<Function>();
+    entry->function = std::move(function);
+    entry->groups = std::move(groups);
+    entry->period = period;
+    entry->deadline = period;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto id = _nextId++;
+    entry->nextRelease = Clock::now() + period;
+    _functions[id] = entry;
+    _timerWheel.schedule(entry->nextRelease, id);
+    _timerCondition.notify_one();
+    return id;
+  }
+
+  /*********************************************************************************************************************/
+
+  UpdateFunctionScheduler::FunctionId UpdateFunctionScheduler::addTriggeredFunction(
+      std::function<void()> function, Clock::duration deadline, std::vector<ChimeraTK::RegisterPath> groups) {
+    auto entry = std::make_shared<Function>();
+    entry->function = std::move(function);
+    entry->groups = std::move(groups);
+    entry->deadline = deadline;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto id = _nextId++;
+    _functions[id] = entry;
+    return id;
+  }
+
+  /*********************************************************************************************************************/
+
+  void UpdateFunctionScheduler::trigger(FunctionId id) {
+    auto now = Clock::now();
+    std::lock_guard<std::mutex> lock(_mutex);
+    const auto& function = getFunction(id);
+    if(function->period != Clock::duration::zero()) {
+      throw ChimeraTK::logic_error("UpdateFunctionScheduler: periodic functions cannot be triggered.");
+    }
+    if(function->queued) {
+      return; // merged with the pending trigger
+    }
+    if(function->running) {
+      if(!function->retrigger) {
+        function->retrigger = true;
+        function->retriggerTime = now;
+      }
+      return;
+    }
+    enqueue(function, now);
+  }
+
+  /*********************************************************************************************************************/
+
+  void UpdateFunctionScheduler::removeFunction(FunctionId id) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    auto function = getFunction(id);
+    _functions.erase(id);
+    // timers of the removed function are ignored, queued jobs are skipped by the workers
+    function->removed = true;
+    function->retrigger = false;
+    _idleCondition.wait(lock, [&] { return !function->running; });
+  }
+
+  /*********************************************************************************************************************/
+
+  UpdateFunctionScheduler::Statistics UpdateFunctionScheduler::getStatistics(FunctionId id) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return getFunction(id)->statistics;
+  }
+
+  /*********************************************************************************************************************/
+
+  const std::shared_ptr<UpdateFunctionScheduler::Function>& UpdateFunctionScheduler::getFunction(FunctionId id) const {
+    auto it = _functions.find(id);
+    if(it == _functions.end()) {
+      throw ChimeraTK::logic_error("UpdateFunctionScheduler: unknown function id " + std::to_string(id));
+    }
+    return it->second;
+  }
+
+  /*********************************************************************************************************************/
+
+  void UpdateFunctionScheduler::enqueue(const std::shared_ptr<Function>& function, Clock::time_point release) {
+    function->queued = true;
+    _queue.push_back({function, release});
+    _workerCondition.notify_one();
+  }
+
+  /*********************************************************************************************************************/
+
+  void UpdateFunctionScheduler::timerThreadFunction() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    while(!_shutdown) {
+      auto deadline = _timerWheel.nextDeadline();
+      if(deadline) {
+        _timerCondition.wait_until(lock, *deadline);
+      }
+      else {
+        _timerCondition.wait(lock);
+      }
+      if(_shutdown) {
+        return;
+      }
+
+      auto now = Clock::now();
+      _timerWheel.advance(now, [&](FunctionId id) {
+        auto it = _functions.find(id);
+        if(it == _functions.end()) {
+          return; // removed
+        }
+        auto& function = it->second;
+        auto release = function->nextRelease;
+
+        // schedule the next release, releases which have already passed are skipped
+        function->nextRelease += function->period;
+        while(function->nextRelease <= now) {
+          function->nextRelease += function->period;
+          ++function->statistics.nDeadlineMisses;
+        }
+        _timerWheel.schedule(function->nextRelease, id);
+
+        if(function->queued || function->running) {
+          ++function->statistics.nDeadlineMisses; // overrun: the previous execution has not completed yet
+          return;
+        }
+        enqueue(function, release);
+      });
+    }
+  }
+
+  /*********************************************************************************************************************/
+
+  void UpdateFunctionScheduler::workerThreadFunction() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    while(true) {
+      _workerCondition.wait(lock, [&] { return _shutdown || !_queue.empty(); });
+      if(_shutdown) {
+        return;
+      }
+      auto job = std::move(_queue.front());
+      _queue.pop_front();
+      auto& function = *job.function;
+      function.queued = false;
+      if(function.removed) {
+        continue;
+      }
+      function.running = true;
+      lock.unlock();
+
+      auto start = Clock::now();
+      try {
+        if(_executor && !function.groups.empty()) {
+          _executor->execute(function.groups, function.function);
+        }
+        else {
+          function.function();
+        }
+      }
+      catch(std::exception& e) {
+        std::cerr << "UpdateFunctionScheduler: exception in update function: " << e.what() << std::endl;
+      }
+      catch(...) {
+        std::cerr << "UpdateFunctionScheduler: unknown exception in update function" << std::endl;
+      }
+      auto end = Clock::now();
+
+      lock.lock();
+      function.running = false;
+      auto& statistics = function.statistics;
+      ++statistics.nExecutions;
+      auto jitter = std::chrono::duration_cast<std::chrono::nanoseconds>(start - job.release);
+      statistics.totalJitter += jitter;
+      statistics.maxJitter = std::max(statistics.maxJitter, jitter);
+      statistics.maxDuration =
+          std::max(statistics.maxDuration, std::chrono::duration_cast<std::chrono::nanoseconds>(end - start));
+      if(function.deadline != Clock::duration::zero() && end > job.release + function.deadline) {
+        ++statistics.nDeadlineMisses;
+      }
+      if(function.retrigger) {
+        function.retrigger = false;
+        enqueue(job.function, function.retriggerTime);
+      }
+      _idleCondition.notify_all();
+    }
+  }
+
+  /*********************************************************************************************************************/
+
+} // namespace ChimeraTK
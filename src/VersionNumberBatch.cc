@@ -0,0 +1,50 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "VersionNumberBatch.h"
+
+namespace ChimeraTK {
+
+  namespace {
+    /** The outermost batch of the calling thread, or nullptr */
+    thread_local VersionNumberBatch* currentBatch = nullptr;
+  } // namespace
+
+  /*********************************************************************************************************************/
+
+  VersionNumberBatch::VersionNumberBatch() {
+    if(currentBatch) {
+      _outermost = currentBatch;
+      return;
+    }
+    _versionNumber = VersionNumber();
+    _outermost = this;
+    currentBatch = this;
+  }
+
+  /*********************************************************************************************************************/
+
+  VersionNumberBatch::~VersionNumberBatch() {
+    if(_outermost == this) {
+      currentBatch = nullptr;
+    }
+  }
+
+  /*********************************************************************************************************************/
+
+  VersionNumber VersionNumberBatch::next() {
+    if(currentBatch) {
+      return currentBatch->_versionNumber;
+    }
+    return {};
+  }
+
+  /*********************************************************************************************************************/
+
+  bool VersionNumberBatch::isActive() {
+    return currentBatch != nullptr;
+  }
+
+  /*********************************************************************************************************************/
+
+} // namespace ChimeraTK
@@ -0,0 +1,305 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "WarmRestartSnapshot.h"
+
+#include "ControlSystemPVManager.h"
+#include "DevicePVManager.h"
+
+#include <ChimeraTK/Exception.h>
+#include <ChimeraTK/SupportedUserTypes.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <system_error>
+#include <type_traits>
+
+namespace ChimeraTK {
+
+  namespace {
+
+    /** Identifies the file format, changed whenever the format changes */
+    constexpr char snapshotMagic[8] = {'C', 'T', 'K', 'S', 'N', 'A', 'P', '1'};
+
+    /** Serialises into a buffer. Without a buffer, only the required size is computed. */
+    class Writer {
+     public:
+      explicit Writer(char* buffer = nullptr) : _buffer(buffer) {}
+
+      void put(const void* data, size_t nBytes) {
+        if(_buffer) {
+          std::memcpy(_buffer + _size, data, nBytes);
+        }
+        _size += nBytes;
+      }
+
+      template<typename T>
+      void put(const T& value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        put(&value, sizeof(T));
+      }
+
+      void put(const std::string& value) {
+        put(static_cast<uint32_t>(value.size()));
+        put(value.data(), value.size());
+      }
+
+      [[nodiscard]] size_t size() const { return _size; }
+
+     private:
+      char* _buffer;
+      size_t _size{0};
+    };
+
+    /** Deserialises from a buffer, throwing if the buffer is too short */
+    class Reader {
+     public:
+      Reader(const char* begin, size_t size, const std::string& fileName)
+      : _position(begin), _end(begin + size), _fileName(fileName) {}
+
+      void get(void* data, size_t nBytes) {
+        if(static_cast<size_t>(_end - _position) < nBytes) {
+          throw ChimeraTK::runtime_error("WarmRestartSnapshot: File '" + _fileName + "' is truncated.");
+        }
+        std::memcpy(data, _position, nBytes);
+        _position += nBytes;
+      }
+
+      template<typename T>
+      void get(T& value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        get(&value, sizeof(T));
+      }
+
+      void get(std::string& value) {
+        uint32_t size;
+        get(size);
+        if(static_cast<size_t>(_end - _position) < size) {
+          throw ChimeraTK::runtime_error("WarmRestartSnapshot: File '" + _fileName + "' is truncated.");
+        }
+        value.assign(_position, size);
+        _position += size;
+      }
+
+      [[nodiscard]] bool atEnd() const { return _position == _end; }
+
+     private:
+      const char* _position;
+      const char* _end;
+      const std::string& _fileName;
+    };
+
+    /** File descriptor closed on destruction */
+    struct FileDescriptor {
+      explicit FileDescriptor(int fd_) : fd(fd_) {}
+      ~FileDescriptor() {
+        if(fd >= 0) {
+          ::close(fd);
+        }
+      }
+      FileDescriptor(const FileDescriptor&) = delete;
+      FileDescriptor& operator=(const FileDescriptor&) = delete;
+      int fd;
+    };
+
+    /** Memory mapping removed on destruction */
+    struct Mapping {
+      Mapping(size_t size_, int protection, int fd, const std::string& fileName) : size(size_) {
+        address = ::mmap(nullptr, size, protection, MAP_SHARED, fd, 0);
+        if(address == MAP_FAILED) {
+          throw std::system_error(errno, std::generic_category(), "Cannot map " + fileName);
+        }
+      }
+      ~Mapping() { ::munmap(address, size); }
+      Mapping(const Mapping&) = delete;
+      Mapping& operator=(const Mapping&) = delete;
+      void* address;
+      size_t size;
+    };
+
+    /** Check whether the process variable is the control system side of a device to control system variable */
+    bool isSavedVariable(const ProcessVariable& pv) {
+      return pv.isReadable() && !pv.isWriteable() && pv.getValueType() != typeid(ChimeraTK::Void);
+    }
+
+  } // namespace
+
+  /*********************************************************************************************************************/
+
+  WarmRestartSnapshot::WarmRestartSnapshot(std::string fileName) : _fileName(std::move(fileName)) {}
+
+  /*********************************************************************************************************************/
+
+  void WarmRestartSnapshot::save(const ControlSystemPVManager& pvManager) {
+    auto processVariables = pvManager.getAllProcessVariables();
+
+    // The same function computes the size and fills the mapped file. The values cannot change in between, since this
+    // is called from the thread reading the process variables.
+    auto serialise = [&](Writer& writer) {
+      uint64_t nEntries = 0;
+      for(const auto& pv : processVariables) {
+        nEntries += isSavedVariable(*pv) && pv->getVersionNumber() != VersionNumber(nullptr);
+      }
+      writer.put(snapshotMagic, sizeof(snapshotMagic));
+      writer.put(nEntries);
+      for(const auto& pv : processVariables) {
+        if(!isSavedVariable(*pv) || pv->getVersionNumber() == VersionNumber(nullptr)) {
+          continue;
+        }
+        writer.put(std::string(pv->getName()));
+        writer.put(DataType(pv->getValueType()).getAsString());
+        writer.put(static_cast<int64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(pv->getVersionNumber().getTime().time_since_epoch())
+                .count()));
+        writer.put(static_cast<uint8_t>(pv->dataValidity() == DataValidity::faulty));
+        callForTypeNoVoid(pv->getValueType(), [&](auto t) {
+          using UserType = decltype(t);
+          const auto& value = boost::dynamic_pointer_cast<ProcessArray<UserType>>(pv)->accessChannel(0);
+          writer.put(static_cast<uint64_t>(value.size()));
+          if constexpr(std::is_same_v<UserType, std::string>) {
+            for(const auto& element : value) {
+              writer.put(element);
+            }
+          }
+          else {
+            writer.put(value.data(), value.size() * sizeof(UserType));
+          }
+        });
+      }
+    };
+
+    Writer sizeCounter;
+    serialise(sizeCounter);
+
+    auto tempName = _fileName + ".new";
+    {
+      FileDescriptor file(::open(tempName.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644));
+      if(file.fd < 0) {
+        throw std::system_error(errno, std::generic_category(), "Cannot create " + tempName);
+      }
+      if(::ftruncate(file.fd, static_cast<off_t>(sizeCounter.size())) != 0) {
+        throw std::system_error(errno, std::generic_category(), "Cannot resize " + tempName);
+      }
+      Mapping mapping(sizeCounter.size(), PROT_READ | PROT_WRITE, file.fd, tempName);
+      Writer writer(static_cast<char*>(mapping.address));
+      serialise(writer);
+      assert(writer.size() == sizeCounter.size());
+      if(::msync(mapping.address, mapping.size, MS_SYNC) != 0) {
+        throw std::system_error(errno, std::generic_category(), "Cannot sync " + tempName);
+      }
+    }
+    if(std::rename(tempName.c_str(), _fileName.c_str()) != 0) {
+      throw std::system_error(errno, std::generic_category(), "Cannot replace " + _fileName);
+    }
+
+    // the rename is only durable once the directory has been synced
+    auto slash = _fileName.rfind('/');
+    std::string directory = slash == std::string::npos ? "." : _fileName.substr(0, std::max<size_t>(slash, 1));
+    FileDescriptor directoryFile(::open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC));
+    if(directoryFile.fd < 0 || ::fsync(directoryFile.fd) != 0) {
+      throw std::system_error(errno, std::generic_category(), "Cannot sync directory " + directory);
+    }
+  }
+
+  /*********************************************************************************************************************/
+
+  size_t WarmRestartSnapshot::restore(DevicePVManager& pvManager) {
+    FileDescriptor file(::open(_fileName.c_str(), O_RDONLY | O_CLOEXEC));
+    if(file.fd < 0) {
+      if(errno == ENOENT) {
+        return 0;
+      }
+      throw std::system_error(errno, std::generic_category(), "Cannot open " + _fileName);
+    }
+    struct stat status {};
+    if(::fstat(file.fd, &status) != 0) {
+      throw std::system_error(errno, std::generic_category(), "Cannot stat " + _fileName);
+    }
+    auto fileSize = static_cast<size_t>(status.st_size);
+    if(fileSize < sizeof(snapshotMagic)) {
+      throw ChimeraTK::runtime_error("WarmRestartSnapshot: File '" + _fileName + "' is truncated.");
+    }
+    Mapping mapping(fileSize, PROT_READ, file.fd, _fileName);
+    Reader reader(static_cast<const char*>(mapping.address), fileSize, _fileName);
+
+    char magic[sizeof(snapshotMagic)];
+    reader.get(magic, sizeof(magic));
+    if(std::memcmp(magic, snapshotMagic, sizeof(magic)) != 0) {
+      throw ChimeraTK::runtime_error("WarmRestartSnapshot: File '" + _fileName + "' is not a snapshot file.");
+    }
+    uint64_t nEntries;
+    reader.get(nEntries);
+
+    size_t nRestored = 0;
+    for(uint64_t i = 0; i < nEntries; ++i) {
+      std::string name, typeName;
+      int64_t timeStamp;
+      uint8_t faulty;
+      uint64_t nElements;
+      reader.get(name);
+      reader.get(typeName);
+      reader.get(timeStamp);
+      reader.get(faulty);
+      reader.get(nElements);
+
+      DataType dataType(typeName);
+      if(dataType == DataType::none || dataType == DataType::Void) {
+        throw ChimeraTK::runtime_error(
+            "WarmRestartSnapshot: File '" + _fileName + "' contains the unknown type '" + typeName + "'.");
+      }
+      callForType(dataType, [&](auto t) {
+        using UserType = decltype(t);
+
+        // the value is always read, so the next entry can be found even if the variable is skipped
+        std::vector<UserType> value;
+        constexpr size_t minElementSize = std::is_same_v<UserType, std::string> ? sizeof(uint32_t) : sizeof(UserType);
+        if(nElements > fileSize / minElementSize) {
+          throw ChimeraTK::runtime_error("WarmRestartSnapshot: File '" + _fileName + "' is truncated.");
+        }
+        value.resize(nElements);
+        if constexpr(std::is_same_v<UserType, std::string>) {
+          for(auto& element : value) {
+            reader.get(element);
+          }
+        }
+        else {
+          reader.get(value.data(), nElements * sizeof(UserType));
+        }
+
+        if(!pvManager.hasProcessVariable(name)) {
+          return;
+        }
+        auto pv = boost::dynamic_pointer_cast<ProcessArray<UserType>>(pvManager.getProcessVariable(name));
+        if(!pv || !pv->isWriteable() || pv->isReadable() || pv->getNumberOfSamples() != nElements) {
+          return;
+        }
+        // The buffer and the validity of the sender are owned by the application, so they are only changed for this
+        // write. write() copies the buffer, so the application's buffer can be swapped back afterwards.
+        pv->accessChannel(0).swap(value);
+        auto previousValidity = pv->dataValidity();
+        pv->setDataValidity(faulty ? DataValidity::faulty : DataValidity::ok);
+        pv->write(VersionNumber(std::chrono::system_clock::time_point(
+            std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(timeStamp)))));
+        pv->setDataValidity(previousValidity);
+        pv->accessChannel(0).swap(value);
+        ++nRestored;
+      });
+    }
+    if(!reader.atEnd()) {
+      throw ChimeraTK::runtime_error("WarmRestartSnapshot: File '" + _fileName + "' has trailing data.");
+    }
+    return nRestored;
+  }
+
+  /*********************************************************************************************************************/
+
+} // namespace ChimeraTK
@@ -230,11 +230,7 @@ inline void ReferenceTestApplication::initialise() {
       boost::fusion::make_pair<ChimeraTK::Void>(
           TypedPVHolder<ChimeraTK::Void>(_processVariableManager, "VOID", _arrayLen))));
 
-  for(auto const& variable : _processVariableManager->getAllProcessVariables()) {
-    if(variable->isWriteable()) {
-      variable->write();
-    }
-  }
+  _processVariableManager->publishInitialValues();
 }
 
 inline void ReferenceTestApplication::run() {
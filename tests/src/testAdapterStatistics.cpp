@@ -0,0 +1,81 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#define BOOST_TEST_MODULE AdapterStatisticsTest
+// Only after defining the name include the unit test header.
+#include <boost/test/included/unit_test.hpp>
+using namespace boost::unit_test_framework;
+
+#include "AdapterStatistics.h"
+#include "ControlSystemPVManager.h"
+#include "DevicePVManager.h"
+
+using namespace ChimeraTK;
+
+/*********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testStatisticsPVs) {
+  auto pvManagers = createPVManager();
+  auto csManager = pvManagers.first;
+  auto devManager = pvManagers.second;
+
+  devManager->enableStatistics("/stats", std::chrono::milliseconds(20));
+  BOOST_CHECK_THROW(devManager->enableStatistics("/stats2"), ChimeraTK::logic_error);
+
+  auto devVar = devManager->createProcessArray<int32_t>(SynchronizationDirection::deviceToControlSystem, "/var", 1);
+  auto csVar = csManager->getProcessArray<int32_t>("/var");
+
+  auto dataLossCount = csManager->getProcessArray<uint64_t>("/stats/dataLossCount");
+  auto writesPerSecond = csManager->getProcessArray<double>("/stats/writesPerSecond");
+  auto readsPerSecond = csManager->getProcessArray<double>("/stats/readsPerSecond");
+  auto residentMemory = csManager->getProcessArray<uint64_t>("/stats/residentMemory");
+  BOOST_CHECK(csManager->hasProcessVariable("/stats/maxQueueOccupancy"));
+  BOOST_CHECK(csManager->hasProcessVariable("/stats/persistenceFlushDuration"));
+  BOOST_CHECK(csManager->hasProcessVariable("/stats/persistenceFileSize"));
+
+  // The queue holds 3 values, so writing 10 times without reading loses 7 values. Reading afterwards gives one read.
+  for(int32_t i = 0; i < 10; ++i) {
+    devVar->accessData(0) = i;
+    devVar->write();
+  }
+  csVar->read();
+
+  // wait until the statistics have caught up
+  bool sawWrites = false;
+  bool sawReads = false;
+  for(size_t i = 0; i < 500; ++i) {
+    dataLossCount->read();
+    writesPerSecond->read();
+    readsPerSecond->read();
+    residentMemory->read();
+    sawWrites |= writesPerSecond->accessData(0) > 0.;
+    sawReads |= readsPerSecond->accessData(0) > 0.;
+    if(dataLossCount->accessData(0) == 7 && sawWrites && sawReads) {
+      break;
+    }
+  }
+  BOOST_CHECK_EQUAL(dataLossCount->accessData(0), 7);
+  BOOST_CHECK(sawWrites);
+  BOOST_CHECK(sawReads);
+  BOOST_CHECK(residentMemory->accessData(0) > 0);
+}
+
+/*********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testDisabledWithLastPublisher) {
+  BOOST_CHECK(!detail::adapterStatisticsEnabled);
+  {
+    auto first = createPVManager().second;
+    auto second = createPVManager().second;
+    first->enableStatistics("/stats", std::chrono::milliseconds(20));
+    second->enableStatistics("/stats", std::chrono::milliseconds(20));
+    BOOST_CHECK(detail::adapterStatisticsEnabled);
+
+    // the counters keep running as long as one publisher is left
+    first.reset();
+    BOOST_CHECK(detail::adapterStatisticsEnabled);
+  }
+  BOOST_CHECK(!detail::adapterStatisticsEnabled);
+}
+
+/*********************************************************************************************************************/
@@ -0,0 +1,82 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#define BOOST_TEST_MODULE AsyncFileWriterTest
+// Only after defining the name include the unit test header.
+#include <boost/test/included/unit_test.hpp>
+using namespace boost::unit_test_framework;
+
+#include <ChimeraTK/ControlSystemAdapter/AsyncFileWriter.h>
+
+#include <boost/filesystem.hpp>
+
+#include <fstream>
+#include <sstream>
+#include <system_error>
+
+using namespace ChimeraTK;
+
+/*********************************************************************************************************************/
+
+static std::string readFile(const std::string& fileName) {
+  std::ifstream file(fileName);
+  std::stringstream content;
+  content << file.rdbuf();
+  return content.str();
+}
+
+/*********************************************************************************************************************/
+
+static void testWriter(bool allowIoUring) {
+  const std::string fileName = "testAsyncFileWriter.txt";
+  boost::filesystem::remove(fileName);
+  AsyncFileWriter writer(allowIoUring);
+  if(!allowIoUring) {
+    BOOST_CHECK(!writer.isUsingIoUring());
+  }
+
+  // write many chunks, so the queue of the writer overflows
+  std::string expected;
+  writer.open(fileName);
+  for(size_t i = 0; i < 1000; ++i) {
+    std::string chunk(i % 100 + 1, static_cast<char>('a' + i % 26));
+    expected += chunk;
+    writer.append(std::move(chunk));
+  }
+  // the target is only created by the commit
+  BOOST_CHECK(!boost::filesystem::exists(fileName));
+  writer.commit();
+  BOOST_CHECK_EQUAL(readFile(fileName), expected);
+  BOOST_CHECK(!boost::filesystem::exists(fileName + ".new"));
+
+  // replace the file with a shorter version
+  writer.open(fileName);
+  writer.append("short");
+  writer.commit();
+  BOOST_CHECK_EQUAL(readFile(fileName), "short");
+
+  // an aborted file does not touch the target
+  writer.open(fileName);
+  writer.append("aborted");
+  writer.abort();
+  BOOST_CHECK_EQUAL(readFile(fileName), "short");
+  BOOST_CHECK(!boost::filesystem::exists(fileName + ".new"));
+
+  // errors are reported as exception
+  BOOST_CHECK_THROW(writer.open("nonExistingDirectory/file.txt"), std::system_error);
+  boost::filesystem::remove(fileName);
+}
+
+/*********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testThreadBackend) {
+  testWriter(false);
+}
+
+/*********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testDefaultBackend) {
+  testWriter(true);
+}
+
+/*********************************************************************************************************************/
@@ -0,0 +1,133 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#define BOOST_TEST_MODULE ControlSystemCallbackDispatcherTest
+// Only after defining the name include the unit test header.
+#include <boost/test/included/unit_test.hpp>
+using namespace boost::unit_test_framework;
+
+#include <ChimeraTK/ControlSystemAdapter/ControlSystemCallbackDispatcher.h>
+#include <ChimeraTK/ControlSystemAdapter/DevicePVManager.h>
+
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <thread>
+
+using namespace ChimeraTK;
+
+/*********************************************************************************************************************/
+
+struct Fixture {
+  static constexpr size_t nVariables = 20;
+
+  Fixture() {
+    std::tie(csManager, devManager) = createPVManager();
+    for(size_t i = 0; i < nVariables; ++i) {
+      devManager->createProcessArray<int32_t>(
+          SynchronizationDirection::deviceToControlSystem, "/out" + std::to_string(i), 1, "", "", 0, 1000);
+    }
+    devManager->createProcessArray<int32_t>(SynchronizationDirection::controlSystemToDevice, "/in", 1);
+  }
+
+  boost::shared_ptr<ControlSystemPVManager> csManager;
+  boost::shared_ptr<DevicePVManager> devManager;
+};
+
+/*********************************************************************************************************************/
+
+BOOST_FIXTURE_TEST_CASE(testOrderPerProcessVariable, Fixture) {
+  ControlSystemCallbackDispatcher dispatcher(csManager, 4, 3);
+
+  // the values received per variable, and whether a callback of the variable is running
+  std::vector<std::vector<int32_t>> received(nVariables);
+  std::vector<std::atomic<bool>> running(nVariables);
+  std::atomic<bool> concurrentCall{false};
+  std::atomic<bool> wrongVariable{false};
+  std::atomic<size_t> nReceived{0};
+  std::mutex threadIdsMutex;
+  std::set<std::thread::id> threadIds;
+
+  for(size_t i = 0; i < nVariables; ++i) {
+    dispatcher.addCallback("/out" + std::to_string(i), [&, i](const ProcessVariable::SharedPtr& pv) {
+      if(running[i].exchange(true)) {
+        concurrentCall = true;
+      }
+      // Boost.Test assertions are not thread safe, so failures are only recorded here
+      if(pv->getName() != "/out" + std::to_string(i)) {
+        wrongVariable = true;
+      }
+      received[i].push_back(boost::dynamic_pointer_cast<ProcessArray<int32_t>>(pv)->accessData(0));
+      {
+        std::lock_guard<std::mutex> lock(threadIdsMutex);
+        threadIds.insert(std::this_thread::get_id());
+      }
+      running[i] = false;
+      ++nReceived;
+    });
+  }
+
+  // values sent before the start are dispatched as well
+  auto out0 = devManager->getProcessArray<int32_t>("/out0");
+  out0->accessData(0) = -1;
+  out0->write();
+
+  dispatcher.start();
+  BOOST_CHECK_THROW(dispatcher.addCallback("/out0", {}), ChimeraTK::logic_error);
+
+  constexpr int32_t nValues = 200;
+  for(int32_t value = 0; value < nValues; ++value) {
+    for(size_t i = 0; i < nVariables; ++i) {
+      auto out = devManager->getProcessArray<int32_t>("/out" + std::to_string(i));
+      out->accessData(0) = value;
+      out->write();
+    }
+  }
+
+  auto end = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while(nReceived < nVariables * nValues + 1 && std::chrono::steady_clock::now() < end) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  dispatcher.stop();
+
+  BOOST_CHECK(!concurrentCall);
+  BOOST_CHECK(!wrongVariable);
+  BOOST_CHECK_EQUAL(nReceived, nVariables * nValues + 1);
+  BOOST_CHECK_EQUAL(received[0].front(), -1);
+  for(size_t i = 0; i < nVariables; ++i) {
+    auto& values = received[i];
+    BOOST_REQUIRE(!values.empty());
+    BOOST_CHECK_EQUAL(values.back(), nValues - 1);
+    for(size_t k = 1; k < values.size(); ++k) {
+      BOOST_CHECK_EQUAL(values[k], values[k - 1] + 1);
+    }
+  }
+  BOOST_TEST_MESSAGE("Callbacks have been executed on " << threadIds.size() << " threads.");
+}
+
+/*********************************************************************************************************************/
+
+BOOST_FIXTURE_TEST_CASE(testInvalidRegistrations, Fixture) {
+  ControlSystemCallbackDispatcher dispatcher(csManager);
+  BOOST_CHECK_THROW(dispatcher.addCallback("/in", {}), ChimeraTK::logic_error);
+  BOOST_CHECK_THROW(dispatcher.addCallback("/doesNotExist", {}), ChimeraTK::logic_error);
+
+  dispatcher.start();
+  BOOST_CHECK_THROW(dispatcher.start(), ChimeraTK::logic_error);
+}
+
+/*********************************************************************************************************************/
+
+BOOST_FIXTURE_TEST_CASE(testStopWithoutCallbacks, Fixture) {
+  // stopping a dispatcher with running and never started workers does not hang
+  {
+    ControlSystemCallbackDispatcher dispatcher(csManager, 2);
+    dispatcher.start();
+  }
+  {
+    ControlSystemCallbackDispatcher dispatcher(csManager, 2);
+    dispatcher.addCallback("/out1", [](const ProcessVariable::SharedPtr&) {});
+  }
+}
+
+/*********************************************************************************************************************/
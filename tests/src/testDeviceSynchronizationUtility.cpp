@@ -0,0 +1,156 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#define BOOST_TEST_MODULE DeviceSynchronizationUtilityTest
+// Only after defining the name include the unit test header.
+#include <boost/test/included/unit_test.hpp>
+using namespace boost::unit_test_framework;
+
+#include <ChimeraTK/ControlSystemAdapter/ControlSystemPVManager.h>
+#include <ChimeraTK/ControlSystemAdapter/DevicePVManager.h>
+#include <ChimeraTK/ControlSystemAdapter/DeviceSynchronizationUtility.h>
+
+#include <boost/thread.hpp>
+
+#include <atomic>
+
+using namespace ChimeraTK;
+
+/*********************************************************************************************************************/
+
+struct Fixture {
+  Fixture() {
+    std::tie(csManager, devManager) = createPVManager();
+    for(int i = 0; i < 3; ++i) {
+      devManager->createProcessArray<int32_t>(
+          SynchronizationDirection::controlSystemToDevice, "/in" + std::to_string(i), 1);
+      devManager->createProcessArray<int32_t>(
+          SynchronizationDirection::deviceToControlSystem, "/out" + std::to_string(i), 1);
+    }
+  }
+
+  boost::shared_ptr<ControlSystemPVManager> csManager;
+  boost::shared_ptr<DevicePVManager> devManager;
+};
+
+/*********************************************************************************************************************/
+
+BOOST_FIXTURE_TEST_CASE(testReceiveChangedOnly, Fixture) {
+  DeviceSynchronizationUtility syncUtil(devManager);
+
+  BOOST_CHECK(syncUtil.receiveAllNonBlocking().empty());
+
+  size_t nCallbacks = 0;
+  syncUtil.addReceiveNotificationListener("/in1", [&](const ProcessVariable::SharedPtr& pv) {
+    BOOST_CHECK_EQUAL(pv->getName(), "/in1");
+    ++nCallbacks;
+  });
+  BOOST_CHECK_THROW(syncUtil.addReceiveNotificationListener("/out1", {}), ChimeraTK::logic_error);
+
+  auto in1 = csManager->getProcessArray<int32_t>("/in1");
+  in1->accessData(0) = 17;
+  in1->write();
+  in1->accessData(0) = 18;
+  in1->write();
+
+  auto received = syncUtil.receiveAll();
+  BOOST_REQUIRE_EQUAL(received.size(), 1);
+  BOOST_CHECK_EQUAL(received[0]->getName(), "/in1");
+  BOOST_CHECK_EQUAL(devManager->getProcessArray<int32_t>("/in1")->accessData(0), 18);
+  BOOST_CHECK_EQUAL(nCallbacks, 2);
+
+  // nothing left
+  BOOST_CHECK(syncUtil.receiveAllNonBlocking().empty());
+}
+
+/*********************************************************************************************************************/
+
+BOOST_FIXTURE_TEST_CASE(testBlockingReceive, Fixture) {
+  DeviceSynchronizationUtility syncUtil(devManager);
+
+  std::atomic<bool> hasReceived{false};
+  boost::thread deviceThread([&] {
+    syncUtil.receiveAll();
+    hasReceived = true;
+  });
+
+  boost::this_thread::sleep_for(boost::chrono::milliseconds(50));
+  BOOST_CHECK(!hasReceived);
+
+  auto in2 = csManager->getProcessArray<int32_t>("/in2");
+  in2->write();
+  deviceThread.join();
+  BOOST_CHECK(hasReceived);
+}
+
+/*********************************************************************************************************************/
+
+BOOST_FIXTURE_TEST_CASE(testInterrupt, Fixture) {
+  DeviceSynchronizationUtility syncUtil(devManager);
+
+  std::atomic<bool> wasInterrupted{false};
+  boost::thread deviceThread([&] {
+    try {
+      syncUtil.receiveAll();
+    }
+    catch(boost::thread_interrupted&) {
+      wasInterrupted = true;
+    }
+  });
+
+  boost::this_thread::sleep_for(boost::chrono::milliseconds(50));
+  syncUtil.interrupt();
+  deviceThread.join();
+  BOOST_CHECK(wasInterrupted);
+}
+
+/*********************************************************************************************************************/
+
+BOOST_FIXTURE_TEST_CASE(testSendModifiedOnly, Fixture) {
+  DeviceSynchronizationUtility syncUtil(devManager);
+
+  BOOST_CHECK_EQUAL(syncUtil.sendAll(), 0);
+
+  auto out0 = devManager->getProcessArray<int32_t>("/out0");
+  out0->accessData(0) = 5;
+  syncUtil.markModified(out0);
+  syncUtil.markModified("/out2");
+  syncUtil.markModified("/out2");
+  BOOST_CHECK_THROW(syncUtil.markModified("/in0"), ChimeraTK::logic_error);
+  BOOST_CHECK_EQUAL(syncUtil.sendAll(), 2);
+  BOOST_CHECK_EQUAL(syncUtil.sendAll(), 0);
+
+  auto csOut0 = csManager->getProcessArray<int32_t>("/out0");
+  auto csOut1 = csManager->getProcessArray<int32_t>("/out1");
+  auto csOut2 = csManager->getProcessArray<int32_t>("/out2");
+  BOOST_CHECK(csOut0->readNonBlocking());
+  BOOST_CHECK_EQUAL(csOut0->accessData(0), 5);
+  BOOST_CHECK(!csOut1->readNonBlocking());
+  BOOST_CHECK(csOut2->readNonBlocking());
+  BOOST_CHECK(!csOut2->readNonBlocking());
+  BOOST_CHECK(csOut0->getVersionNumber() == csOut2->getVersionNumber());
+}
+
+/*********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testNoPushReceivers) {
+  auto [csManager, devManager] = createPVManager();
+  devManager->createProcessArray<int32_t>(
+      SynchronizationDirection::controlSystemToDevice, "/poll", 1, "", "", 0, 3, AccessModeFlags{});
+  devManager->createProcessArray<int32_t>(SynchronizationDirection::deviceToControlSystem, "/out", 1);
+  DeviceSynchronizationUtility syncUtil(devManager);
+
+  // receiveAll() would never block, so a receive loop would spin
+  BOOST_CHECK_THROW(syncUtil.receiveAll(), ChimeraTK::logic_error);
+
+  // the poll-type variable can still be received without blocking once it has its initial value
+  auto poll = csManager->getProcessArray<int32_t>("/poll");
+  poll->accessData(0) = 3;
+  poll->write();
+  auto received = syncUtil.receiveAllNonBlocking();
+  BOOST_REQUIRE_EQUAL(received.size(), 1);
+  BOOST_CHECK_EQUAL(received[0]->getName(), "/poll");
+  BOOST_CHECK_EQUAL(devManager->getProcessArray<int32_t>("/poll")->accessData(0), 3);
+}
+
+/*********************************************************************************************************************/
@@ -0,0 +1,78 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#define BOOST_TEST_MODULE DirtyTrackingTest
+// Only after defining the name include the unit test header.
+#include <boost/test/included/unit_test.hpp>
+using namespace boost::unit_test_framework;
+
+#include <ChimeraTK/ControlSystemAdapter/ControlSystemPVManager.h>
+#include <ChimeraTK/ControlSystemAdapter/DevicePVManager.h>
+
+using namespace ChimeraTK;
+
+/*********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testPublishDirtyOnly) {
+  auto pvManagers = createPVManager();
+  auto csManager = pvManagers.first;
+  auto devManager = pvManagers.second;
+
+  // more than 64 outputs, so the bitmap has more than one word
+  const size_t nOutputs = 100;
+  std::vector<DirtyTrackingAccessor<int32_t>> outputs;
+  for(size_t i = 0; i < nOutputs; ++i) {
+    devManager->createProcessArray<int32_t>(
+        SynchronizationDirection::deviceToControlSystem, "/out" + std::to_string(i), 2);
+    outputs.push_back(devManager->getDirtyTrackingAccessor<int32_t>("/out" + std::to_string(i)));
+  }
+  devManager->createProcessArray<int32_t>(SynchronizationDirection::controlSystemToDevice, "/in", 1);
+  BOOST_CHECK_THROW(devManager->getDirtyTrackingAccessor<int32_t>("/in"), ChimeraTK::logic_error);
+  BOOST_CHECK_THROW(devManager->getDirtyTrackingAccessor<int32_t>("/doesNotExist"), ChimeraTK::logic_error);
+
+  BOOST_CHECK_EQUAL(devManager->publishDirty(), 0);
+
+  outputs[3].accessData(1) = 42;
+  outputs[70].set(0, 7);
+  outputs[71].set(0, 0); // unchanged, not marked
+  outputs[99].set({1, 2});
+  outputs[99].set({1, 2}); // marked only once
+  (void)outputs[5].get();   // read-only access does not mark
+  BOOST_CHECK_EQUAL(devManager->publishDirty(), 3);
+  BOOST_CHECK_EQUAL(devManager->publishDirty(), 0);
+
+  VersionNumber version{nullptr};
+  for(size_t i = 0; i < nOutputs; ++i) {
+    auto csOutput = csManager->getProcessArray<int32_t>("/out" + std::to_string(i));
+    bool received = csOutput->readNonBlocking();
+    BOOST_CHECK_EQUAL(received, i == 3 || i == 70 || i == 99);
+    if(!received) {
+      continue;
+    }
+    // all published with the same version number
+    if(version == VersionNumber{nullptr}) {
+      version = csOutput->getVersionNumber();
+    }
+    BOOST_CHECK(csOutput->getVersionNumber() == version);
+    if(i == 3) {
+      BOOST_CHECK_EQUAL(csOutput->accessData(1), 42);
+    }
+    else if(i == 70) {
+      BOOST_CHECK_EQUAL(csOutput->accessData(0), 7);
+    }
+    else {
+      BOOST_CHECK(csOutput->accessChannel(0) == std::vector<int32_t>({1, 2}));
+    }
+  }
+
+  // marking by name, also for outputs without an accessor
+  devManager->createProcessArray<int32_t>(SynchronizationDirection::deviceToControlSystem, "/untracked", 1);
+  devManager->markDirty("/untracked");
+  devManager->markDirty("/out0");
+  BOOST_CHECK_THROW(devManager->markDirty("/in"), ChimeraTK::logic_error);
+  BOOST_CHECK_EQUAL(devManager->publishDirty(), 2);
+  BOOST_CHECK(csManager->getProcessArray<int32_t>("/untracked")->readNonBlocking());
+  BOOST_CHECK(csManager->getProcessArray<int32_t>("/out0")->readNonBlocking());
+}
+
+/*********************************************************************************************************************/
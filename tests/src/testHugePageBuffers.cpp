@@ -0,0 +1,124 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#define BOOST_TEST_MODULE HugePageBuffersTest
+// Only after defining the name include the unit test header.
+#include <boost/test/included/unit_test.hpp>
+using namespace boost::unit_test_framework;
+
+#include <ChimeraTK/ControlSystemAdapter/ControlSystemPVManager.h>
+#include <ChimeraTK/ControlSystemAdapter/DevicePVManager.h>
+
+#include <boost/filesystem.hpp>
+
+#include <fstream>
+#include <sstream>
+
+using namespace ChimeraTK;
+
+/*********************************************************************************************************************/
+
+/** Check whether the memory mapping containing the given address has the huge page advice (VmFlags "hg") */
+static bool hasHugePageAdvice(const void* address) {
+  std::ifstream smaps("/proc/self/smaps");
+  auto target = reinterpret_cast<uintptr_t>(address);
+  bool inMapping = false;
+  std::string line;
+  while(std::getline(smaps, line)) {
+    uintptr_t begin, end;
+    char dash;
+    std::istringstream range(line);
+    if(range >> std::hex >> begin >> dash >> end && dash == '-') {
+      inMapping = target >= begin && target < end;
+    }
+    else if(inMapping && line.rfind("VmFlags:", 0) == 0) {
+      return line.find(" hg") != std::string::npos;
+    }
+  }
+  return false;
+}
+
+/*********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testAdvise) {
+  std::vector<int32_t> large(4 << 20, 42); // 16 MiB
+  std::vector<int32_t> small(1000, 42);
+
+  // disabled by default
+  BOOST_CHECK(!detail::adviseLargeBuffer(large));
+
+  setProcessArrayHugePageThreshold(8 << 20);
+  BOOST_CHECK(!detail::adviseLargeBuffer(small));
+  // a buffer above the threshold without a complete 2 MiB huge page inside is not advised
+  std::vector<int32_t> medium(1 << 18, 42); // 1 MiB
+  setProcessArrayHugePageThreshold(512 << 10);
+  BOOST_CHECK(!detail::adviseLargeBuffer(medium));
+  setProcessArrayHugePageThreshold(8 << 20);
+  // the advice can only be accepted if the kernel supports transparent huge pages
+  if(boost::filesystem::exists("/sys/kernel/mm/transparent_hugepage/enabled")) {
+    BOOST_CHECK(detail::adviseLargeBuffer(large));
+  }
+  // the content is not changed
+  BOOST_CHECK_EQUAL(large.front(), 42);
+  BOOST_CHECK_EQUAL(large[large.size() / 2], 42);
+  BOOST_CHECK_EQUAL(large.back(), 42);
+
+  setProcessArrayHugePageThreshold(0);
+  BOOST_CHECK(!detail::adviseLargeBuffer(large));
+}
+
+/*********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testLargeProcessArray) {
+  setProcessArrayHugePageThreshold(2 << 20);
+
+  auto pvManagers = createPVManager();
+  const size_t nElements = 3 << 20; // 12 MiB per buffer
+  auto image = pvManagers.second->createProcessArray<int32_t>(
+      SynchronizationDirection::deviceToControlSystem, "/image", nElements, "", "", 1);
+  auto csImage = pvManagers.first->getProcessArray<int32_t>("/image");
+  BOOST_CHECK_EQUAL(csImage->accessData(nElements - 1), 1);
+
+  for(size_t i = 0; i < nElements; ++i) {
+    image->accessData(i) = static_cast<int32_t>(i);
+  }
+  image->write();
+  BOOST_CHECK(csImage->readNonBlocking());
+  BOOST_CHECK_EQUAL(csImage->accessData(0), 0);
+  BOOST_CHECK_EQUAL(csImage->accessData(nElements - 1), static_cast<int32_t>(nElements - 1));
+
+  setProcessArrayHugePageThreshold(0);
+}
+
+/*********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testQueueBuffersAdvised) {
+  if(!boost::filesystem::exists("/sys/kernel/mm/transparent_hugepage/enabled")) {
+    BOOST_TEST_MESSAGE("Transparent huge pages not supported, skipping test.");
+    return;
+  }
+  setProcessArrayHugePageThreshold(2 << 20);
+
+  auto pvManagers = createPVManager();
+  const size_t nElements = 1 << 20; // 4 MiB per buffer
+  const size_t numberOfBuffers = 3;
+  auto image = pvManagers.second->createProcessArray<int32_t>(
+      SynchronizationDirection::deviceToControlSystem, "/image", nElements, "", "", 0, numberOfBuffers);
+  auto csImage = pvManagers.first->getProcessArray<int32_t>("/image");
+
+  // The buffers are swapped between the application buffers and the queue on each transfer. After cycling through
+  // more buffers than the queue holds, both ends must have seen every buffer of the queue. Only the complete huge
+  // pages are advised, for a 4 MiB buffer this always is the 2 MiB page containing the middle of the buffer.
+  for(size_t i = 0; i < 2 * (numberOfBuffers + 2); ++i) {
+    image->accessData(0) = static_cast<int32_t>(i);
+    image->write();
+    BOOST_CHECK(hasHugePageAdvice(image->accessChannel(0).data() + nElements / 2));
+    BOOST_REQUIRE(csImage->readNonBlocking());
+    BOOST_CHECK_EQUAL(csImage->accessData(0), static_cast<int32_t>(i));
+    BOOST_CHECK(hasHugePageAdvice(csImage->accessChannel(0).data() + nElements / 2));
+  }
+
+  setProcessArrayHugePageThreshold(0);
+}
+
+/*********************************************************************************************************************/
@@ -0,0 +1,136 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#define BOOST_TEST_MODULE LatestValueViewTest
+// Only after defining the name include the unit test header.
+#include <boost/test/included/unit_test.hpp>
+using namespace boost::unit_test_framework;
+
+#include <ChimeraTK/ControlSystemAdapter/ControlSystemPVManager.h>
+#include <ChimeraTK/ControlSystemAdapter/DevicePVManager.h>
+
+#include <atomic>
+#include <thread>
+
+using namespace ChimeraTK;
+
+/*********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testUpdateOnRead) {
+  auto [csManager, devManager] = createPVManager();
+  auto dev = devManager->createProcessArray<int32_t>(
+      SynchronizationDirection::deviceToControlSystem, "/out", 3, "", "", 42, 10);
+  auto cs = csManager->getProcessArray<int32_t>("/out");
+
+  // only readable process arrays have a view
+  BOOST_CHECK_THROW(dev->getLatestValueView(), ChimeraTK::logic_error);
+
+  auto view = cs->getLatestValueView();
+  BOOST_REQUIRE(view);
+  BOOST_CHECK_EQUAL(view.getNumberOfSamples(), 3);
+  auto latest = view.get();
+  BOOST_CHECK(latest.value == std::vector<int32_t>({42, 42, 42}));
+  BOOST_CHECK_EQUAL(latest.updateCount, 1);
+
+  // a write alone does not change the view, only the read does
+  dev->accessChannel(0) = {1, 2, 3};
+  VersionNumber version;
+  dev->setDataValidity(DataValidity::faulty);
+  dev->write(version);
+  BOOST_CHECK_EQUAL(view.getUpdateCount(), 1);
+  cs->read();
+  view.get(latest);
+  BOOST_CHECK(latest.value == std::vector<int32_t>({1, 2, 3}));
+  BOOST_CHECK(latest.timeStamp == version.getTime());
+  BOOST_CHECK(latest.dataValidity == DataValidity::faulty);
+  BOOST_CHECK_EQUAL(latest.updateCount, 2);
+
+  // reads without new data do not count as update
+  BOOST_CHECK(!cs->readNonBlocking());
+  BOOST_CHECK_EQUAL(view.getUpdateCount(), 2);
+
+  // views share the same value, and survive the process array
+  auto copy = cs->getLatestValueView();
+  cs.reset();
+  csManager.reset();
+  BOOST_CHECK(copy.get().value == std::vector<int32_t>({1, 2, 3}));
+}
+
+/*********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testBidirectionalAndStrings) {
+  auto [csManager, devManager] = createPVManager();
+  auto dev = devManager->createProcessArray<std::string>(SynchronizationDirection::bidirectional, "/string", 2);
+  auto cs = csManager->getProcessArray<std::string>("/string");
+
+  auto view = dev->getLatestValueView();
+  BOOST_CHECK(view.get().value == std::vector<std::string>({"", ""}));
+
+  cs->accessChannel(0) = {"hello", "world"};
+  cs->write();
+  dev->read();
+  auto latest = view.get();
+  BOOST_CHECK(latest.value == std::vector<std::string>({"hello", "world"}));
+  BOOST_CHECK_EQUAL(latest.updateCount, 2);
+}
+
+/*********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testConcurrentReaders) {
+  auto [csManager, devManager] = createPVManager();
+  constexpr size_t nElements = 1000;
+  auto dev = devManager->createProcessArray<int64_t>(
+      SynchronizationDirection::deviceToControlSystem, "/out", nElements, "", "", 0, 10);
+  auto cs = csManager->getProcessArray<int64_t>("/out");
+  auto view = cs->getLatestValueView();
+
+  // The device side writes arrays with all elements equal and the value increasing. Readers must never see a mixture
+  // of two values, and the values they see must not go backwards.
+  constexpr int64_t nValues = 2000;
+  std::atomic<bool> done{false};
+  std::atomic<bool> tornRead{false};
+  std::atomic<bool> wentBackwards{false};
+  std::atomic<size_t> nSnapshots{0};
+  std::vector<std::thread> readers;
+  for(size_t i = 0; i < 4; ++i) {
+    readers.emplace_back([&, view] {
+      LatestValue<int64_t> latest;
+      int64_t previous = 0;
+      while(!done) {
+        view.get(latest);
+        for(auto element : latest.value) {
+          if(element != latest.value[0]) {
+            tornRead = true;
+          }
+        }
+        if(latest.value[0] < previous) {
+          wentBackwards = true;
+        }
+        previous = latest.value[0];
+        ++nSnapshots;
+      }
+    });
+  }
+
+  std::thread receiver([&, cs = cs] {
+    while(cs->accessData(0) < nValues) {
+      cs->read();
+    }
+  });
+  for(int64_t value = 1; value <= nValues; ++value) {
+    std::fill(dev->accessChannel(0).begin(), dev->accessChannel(0).end(), value);
+    dev->write();
+  }
+  receiver.join();
+  done = true;
+  for(auto& reader : readers) {
+    reader.join();
+  }
+
+  BOOST_CHECK(!tornRead);
+  BOOST_CHECK(!wentBackwards);
+  BOOST_CHECK_EQUAL(view.get().value[0], nValues);
+  BOOST_TEST_MESSAGE(nSnapshots << " snapshots have been read concurrently.");
+}
+
+/*********************************************************************************************************************/
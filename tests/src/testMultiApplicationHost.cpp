@@ -0,0 +1,109 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#define BOOST_TEST_MODULE MultiApplicationHostTest
+// Only after defining the name include the unit test header.
+#include <boost/test/included/unit_test.hpp>
+using namespace boost::unit_test_framework;
+
+#include <ChimeraTK/ControlSystemAdapter/MultiApplicationHost.h>
+
+#include <boost/filesystem.hpp>
+
+#include <fstream>
+
+using namespace ChimeraTK;
+
+/*********************************************************************************************************************/
+
+class HostedApplication : public ApplicationBase {
+ public:
+  explicit HostedApplication(const std::string& name) : ApplicationBase(name) {}
+  ~HostedApplication() override { shutdown(); }
+
+  void initialise() override {
+    // getInstance() must return this application while it is initialised
+    BOOST_CHECK(&ApplicationBase::getInstance() == this);
+    input = _processVariableManager->createProcessArray<int32_t>(
+        SynchronizationDirection::controlSystemToDevice, "/input", 1);
+    output = _processVariableManager->createProcessArray<int32_t>(
+        SynchronizationDirection::deviceToControlSystem, "/output", 1);
+  }
+
+  void optimiseUnmappedVariables(const std::set<std::string>& unmappedVariables) override {
+    unmapped = unmappedVariables;
+  }
+
+  void run() override { hasRun = true; }
+
+  ProcessArray<int32_t>::SharedPtr input;
+  ProcessArray<int32_t>::SharedPtr output;
+  std::set<std::string> unmapped;
+  bool hasRun{false};
+};
+
+/*********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testTwoApplications) {
+  boost::filesystem::remove("hostedApp1.persist");
+  boost::filesystem::remove("hostedApp2.persist");
+
+  {
+    MultiApplicationHost host;
+    auto& app1 = host.addApplication<HostedApplication>("/app1", "hostedApp1");
+    auto& app2 = host.addApplication<HostedApplication>("/app2", "hostedApp2");
+    BOOST_CHECK_EQUAL(host.getNumberOfApplications(), 2);
+
+    // duplicate prefix or name
+    BOOST_CHECK_THROW(host.addApplication<HostedApplication>("/app1", "hostedApp3"), ChimeraTK::logic_error);
+    BOOST_CHECK_THROW(host.addApplication<HostedApplication>("/app3", "hostedApp1"), ChimeraTK::logic_error);
+    BOOST_CHECK_EQUAL(host.getNumberOfApplications(), 2);
+
+    host.initialise();
+    host.enablePersistentDataStorage();
+
+    auto csManager = host.getControlSystemPVManager();
+    BOOST_CHECK_EQUAL(csManager->getAllProcessVariables().size(), 4);
+    BOOST_CHECK(csManager->hasProcessVariable("/app1/input"));
+    BOOST_CHECK(csManager->hasProcessVariable("/app2/output"));
+    BOOST_CHECK_EQUAL(app1.getPVManager()->getAllProcessVariables().size(), 2);
+    BOOST_CHECK(app1.getPVManager()->hasProcessVariable("/input"));
+    BOOST_CHECK(!app1.getPVManager()->hasProcessVariable("/app2/input"));
+
+    // the applications are independent of each other
+    auto input1 = csManager->getProcessArray<int32_t>("/app1/input");
+    auto input2 = csManager->getProcessArray<int32_t>("/app2/input");
+    input1->accessData(0) = 42;
+    input1->write();
+    input2->accessData(0) = 120;
+    input2->write();
+    while(app1.input->readNonBlocking()) {
+    }
+    while(app2.input->readNonBlocking()) {
+    }
+    BOOST_CHECK_EQUAL(app1.input->accessData(0), 42);
+    BOOST_CHECK_EQUAL(app2.input->accessData(0), 120);
+
+    host.optimiseUnmappedVariables({"/app1/output", "/app2/input"});
+    BOOST_CHECK(app1.unmapped == std::set<std::string>({"/output"}));
+    BOOST_CHECK(app2.unmapped == std::set<std::string>({"/input"}));
+
+    host.run();
+    BOOST_CHECK(app1.hasRun);
+    BOOST_CHECK(app2.hasRun);
+
+    // the hosted applications do not occupy the global instance
+    BOOST_CHECK_THROW((void)ApplicationBase::getInstance(), ChimeraTK::logic_error);
+  }
+
+  // each application has its own persistency file with the names relative to its prefix
+  for(const std::string name : {"hostedApp1", "hostedApp2"}) {
+    std::ifstream file(name + ".persist");
+    BOOST_REQUIRE(file.good());
+    std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    BOOST_CHECK(content.find("name=\"/input\"") != std::string::npos);
+    BOOST_CHECK(content.find("/app") == std::string::npos);
+  }
+}
+
+/*********************************************************************************************************************/
@@ -0,0 +1,147 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#define BOOST_TEST_MODULE MultiProducerProcessArrayTest
+// Only after defining the name include the unit test header.
+#include <boost/test/included/unit_test.hpp>
+using namespace boost::unit_test_framework;
+
+#include <ChimeraTK/ControlSystemAdapter/AdapterStatistics.h>
+#include <ChimeraTK/ControlSystemAdapter/ControlSystemPVManager.h>
+#include <ChimeraTK/ControlSystemAdapter/DevicePVManager.h>
+#include <ChimeraTK/ControlSystemAdapter/PersistentDataStorage.h>
+
+#include <boost/filesystem.hpp>
+
+#include <thread>
+
+using namespace ChimeraTK;
+
+/*********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testConcurrentProducers) {
+  auto pvManagers = createPVManager();
+  auto devManager = pvManagers.second;
+
+  const size_t nProducers = 4;
+  const int32_t nWritesPerProducer = 250;
+
+  std::vector<ProcessArray<int32_t>::SharedPtr> producers;
+  producers.push_back(devManager->createMultiProducerProcessArray<int32_t>("/shared", 2,
+      MultiProducerOrdering::lastWriterWins, "", "", 0, nProducers * nWritesPerProducer));
+  for(size_t i = 1; i < nProducers; ++i) {
+    producers.push_back(devManager->createAdditionalProducer<int32_t>("/shared"));
+  }
+
+  std::vector<std::thread> threads;
+  for(size_t i = 0; i < nProducers; ++i) {
+    threads.emplace_back([&, i] {
+      auto& producer = producers[i];
+      for(int32_t k = 0; k < nWritesPerProducer; ++k) {
+        producer->accessData(0) = static_cast<int32_t>(i);
+        producer->accessData(1) = k;
+        producer->write();
+      }
+    });
+  }
+  for(auto& thread : threads) {
+    thread.join();
+  }
+
+  // the queue was large enough, so all values have arrived and the values of each producer are in order
+  auto receiver = pvManagers.first->getProcessArray<int32_t>("/shared");
+  std::vector<int32_t> nextValue(nProducers, 0);
+  size_t nReceived = 0;
+  while(receiver->readNonBlocking()) {
+    auto producer = static_cast<size_t>(receiver->accessData(0));
+    BOOST_REQUIRE(producer < nProducers);
+    BOOST_CHECK_EQUAL(receiver->accessData(1), nextValue[producer]);
+    nextValue[producer] = receiver->accessData(1) + 1;
+    ++nReceived;
+  }
+  BOOST_CHECK_EQUAL(nReceived, nProducers * nWritesPerProducer);
+}
+
+/*********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testOrderedByVersion) {
+  auto pvManagers = createPVManager();
+  auto devManager = pvManagers.second;
+
+  auto first = devManager->createMultiProducerProcessArray<int32_t>(
+      "/ordered", 1, MultiProducerOrdering::orderedByVersion);
+  auto second = devManager->createAdditionalProducer<int32_t>("/ordered");
+  auto receiver = pvManagers.first->getProcessArray<int32_t>("/ordered");
+
+  VersionNumber older;
+  VersionNumber newer;
+  first->accessData(0) = 2;
+  BOOST_CHECK(!first->write(newer));
+  // the older value of the other producer is discarded and reported as lost
+  second->accessData(0) = 1;
+  BOOST_CHECK(second->write(older));
+
+  BOOST_CHECK(receiver->readNonBlocking());
+  BOOST_CHECK_EQUAL(receiver->accessData(0), 2);
+  BOOST_CHECK(receiver->getVersionNumber() == newer);
+  BOOST_CHECK(!receiver->readNonBlocking());
+
+  // values with the same or a newer version are delivered
+  second->accessData(0) = 3;
+  BOOST_CHECK(!second->write(newer));
+  BOOST_CHECK(receiver->readNonBlocking());
+  BOOST_CHECK_EQUAL(receiver->accessData(0), 3);
+}
+
+/*********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testDiscardedNotPersisted) {
+  const std::string fileName = "multiProducerProcessArrayTest.persist";
+  boost::filesystem::remove(fileName);
+  {
+    auto pvManagers = createPVManager();
+    auto devManager = pvManagers.second;
+
+    auto first = devManager->createMultiProducerProcessArray<int32_t>(
+        "/ordered", 1, MultiProducerOrdering::orderedByVersion);
+    auto second = devManager->createAdditionalProducer<int32_t>("/ordered");
+    auto receiver = pvManagers.first->getProcessArray<int32_t>("/ordered");
+
+    // both senders write their initial value when the storage is set
+    auto storage = boost::make_shared<PersistentDataStorage>("multiProducerProcessArrayTest", 3600);
+    first->setPersistentDataStorage(storage);
+    second->setPersistentDataStorage(storage);
+    receiver->readLatest();
+
+    detail::adapterStatisticsEnabled = true;
+    auto discardedBefore = detail::adapterStatisticsCounters.discarded.load();
+    auto dataLostBefore = detail::adapterStatisticsCounters.dataLost.load();
+
+    VersionNumber older;
+    VersionNumber newer;
+    first->accessData(0) = 2;
+    first->write(newer);
+    second->accessData(0) = 1;
+    BOOST_CHECK(second->write(older));
+
+    // the discarded value neither reaches the storage nor counts as a queue overflow
+    auto id = storage->registerVariable<int32_t>("/ordered", 1);
+    BOOST_CHECK(storage->retrieveValue<int32_t>(id) == std::vector<int32_t>{2});
+    BOOST_CHECK_EQUAL(detail::adapterStatisticsCounters.discarded.load(), discardedBefore + 1);
+    BOOST_CHECK_EQUAL(detail::adapterStatisticsCounters.dataLost.load(), dataLostBefore);
+    detail::adapterStatisticsEnabled = false;
+  }
+  boost::filesystem::remove(fileName);
+}
+
+/*********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testSingleProducerRejected) {
+  auto pvManagers = createPVManager();
+  auto devManager = pvManagers.second;
+  devManager->createProcessArray<int32_t>(SynchronizationDirection::deviceToControlSystem, "/single", 1);
+  BOOST_CHECK_THROW(devManager->createAdditionalProducer<int32_t>("/single"), ChimeraTK::logic_error);
+  BOOST_CHECK_THROW(devManager->createAdditionalProducer<int32_t>("/doesNotExist"), ChimeraTK::logic_error);
+}
+
+/*********************************************************************************************************************/
@@ -9,6 +9,8 @@
 #include <boost/make_shared.hpp>
 #include <boost/test/included/unit_test.hpp>
 
+#include <atomic>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -508,5 +510,122 @@ BOOST_AUTO_TEST_CASE(bidirectionalProcessVariable) {
   stopDeviceThread->write();
 }
 
+BOOST_AUTO_TEST_CASE(testPublishInitialValues) {
+  auto [csManager, devManager] = createPVManager();
+  devManager->createProcessArray<int32_t>(SynchronizationDirection::deviceToControlSystem, "/a/out", 1, "", "", 5);
+  devManager->createProcessArray<double>(SynchronizationDirection::bidirectional, "/a/bidirectional", 2, "", "", 1.5);
+  devManager->createProcessArray<int32_t>(SynchronizationDirection::controlSystemToDevice, "/a/in", 1);
+  devManager->createProcessArray<int32_t>(SynchronizationDirection::deviceToControlSystem, "/b/out", 1);
+
+  BOOST_CHECK(!csManager->waitForInitialValues(std::chrono::milliseconds(10)));
+
+  // the control system side waits for the signal instead of for the individual values
+  boost::thread waiter([csManager = csManager] { csManager->waitForInitialValues(); });
+
+  // a sub manager only publishes its own process variables, the signal waits for the remaining ones
+  BOOST_CHECK_EQUAL(devManager->getSubManager("/a")->publishInitialValues(), 2);
+  BOOST_CHECK(!csManager->waitForInitialValues(std::chrono::milliseconds(10)));
+  BOOST_CHECK(!waiter.try_join_for(boost::chrono::milliseconds(10)));
+
+  auto out = csManager->getProcessArray<int32_t>("/a/out");
+  auto bidirectional = csManager->getProcessArray<double>("/a/bidirectional");
+  BOOST_CHECK(out->readNonBlocking());
+  BOOST_CHECK_EQUAL(out->accessData(0), 5);
+  BOOST_CHECK(bidirectional->readNonBlocking());
+  BOOST_CHECK_EQUAL(bidirectional->accessData(1), 1.5);
+  auto bOut = csManager->getProcessArray<int32_t>("/b/out");
+  BOOST_CHECK(!bOut->readNonBlocking());
+
+  // all initial values of one call share one version number
+  BOOST_CHECK(out->getVersionNumber() == bidirectional->getVersionNumber());
+
+  // the signal is given once all prefixes have been published
+  BOOST_CHECK_EQUAL(devManager->getSubManager("/b")->publishInitialValues(), 1);
+  waiter.join();
+  BOOST_CHECK(csManager->waitForInitialValues(std::chrono::milliseconds(0)));
+  BOOST_CHECK(bOut->readNonBlocking());
+}
+
+BOOST_AUTO_TEST_CASE(testStringNameLookup) {
+  // the string lookups do not change the key of the public map type
+  static_assert(std::is_same_v<PVManager::ProcessVariableMap::key_type, RegisterPath>);
+  auto [csManager, devManager] = createPVManager();
+  devManager->createProcessArray<int32_t>(SynchronizationDirection::deviceToControlSystem, "/some/variable", 1);
+
+  BOOST_CHECK(PVManager::isNormalisedName("/some/variable"));
+  BOOST_CHECK(!PVManager::isNormalisedName("some/variable"));
+  BOOST_CHECK(!PVManager::isNormalisedName("/some//variable"));
+  BOOST_CHECK(!PVManager::isNormalisedName("/some/variable/"));
+  BOOST_CHECK(!PVManager::isNormalisedName(""));
+
+  // normalised names take the fast path, other names are normalised like a RegisterPath
+  std::string_view normalised = "/some/variable";
+  for(std::string_view name : {normalised, std::string_view("some/variable"), std::string_view("/some//variable/")}) {
+    BOOST_CHECK(csManager->hasProcessVariable(name));
+    BOOST_CHECK_EQUAL(csManager->getProcessVariable(name)->getName(), "/some/variable");
+    BOOST_CHECK(csManager->getProcessArray<int32_t>(name) == csManager->getProcessVariable(normalised));
+  }
+  BOOST_CHECK(csManager->hasProcessVariable(std::string("/some/variable")));
+  BOOST_CHECK(csManager->hasProcessVariable("/some/variable"));
+  BOOST_CHECK(csManager->hasProcessVariable(RegisterPath("/some/variable")));
+  BOOST_CHECK(!csManager->hasProcessVariable("/some"));
+  BOOST_CHECK_THROW(csManager->getProcessVariable("/some"), ChimeraTK::logic_error);
+  BOOST_CHECK_THROW(csManager->getProcessArray<double>("/some/variable"), ChimeraTK::logic_error);
+
+  // the device side resolves names relative to the prefix of the manager
+  auto subManager = devManager->getSubManager("/some");
+  for(std::string_view name : {std::string_view("/variable"), std::string_view("variable")}) {
+    BOOST_CHECK(subManager->hasProcessVariable(name));
+    BOOST_CHECK(subManager->getProcessArray<int32_t>(name) == devManager->getProcessVariable(normalised));
+  }
+  BOOST_CHECK(devManager->hasProcessVariable("/some/variable"));
+  BOOST_CHECK(
+      devManager->getProcessVariable(std::string("some//variable")) == subManager->getProcessVariable("/variable"));
+  BOOST_CHECK(!subManager->hasProcessVariable("/some/variable"));
+}
+
+BOOST_AUTO_TEST_CASE(testInterruptAll) {
+  auto [csManager, devManager] = createPVManager();
+  devManager->createProcessArray<int32_t>(SynchronizationDirection::deviceToControlSystem, "/out", 1);
+  devManager->createProcessArray<int32_t>(SynchronizationDirection::controlSystemToDevice, "/in", 1);
+  devManager->createProcessArray<int32_t>(SynchronizationDirection::controlSystemToDevice, "/poll", 1, "", "", 0, 3,
+      AccessModeFlags{});
+
+  // a blocked reader on each side
+  auto blockedRead = [](const ProcessArray<int32_t>::SharedPtr& pv, std::atomic<bool>& interrupted) {
+    return boost::thread([pv, &interrupted] {
+      try {
+        pv->read();
+      }
+      catch(boost::thread_interrupted&) {
+        interrupted = true;
+      }
+    });
+  };
+  std::atomic<bool> csInterrupted{false}, devInterrupted{false};
+  auto csReader = blockedRead(csManager->getProcessArray<int32_t>("/out"), csInterrupted);
+  auto devReader = blockedRead(devManager->getProcessArray<int32_t>("/in"), devInterrupted);
+  boost::this_thread::sleep_for(boost::chrono::milliseconds(50));
+
+  // only readable process variables with wait_for_new_data are interrupted
+  BOOST_CHECK_EQUAL(csManager->interruptAll(), 1);
+  csReader.join();
+  BOOST_CHECK(csInterrupted);
+  BOOST_CHECK(!devInterrupted);
+
+  csManager->shutdown();
+  devReader.join();
+  BOOST_CHECK(devInterrupted);
+
+  // the process variables stay usable
+  auto out = devManager->getProcessArray<int32_t>("/out");
+  out->accessData(0) = 42;
+  out->write();
+  auto csOut = csManager->getProcessArray<int32_t>("/out");
+  BOOST_CHECK_THROW(csOut->read(), boost::thread_interrupted);
+  csOut->read();
+  BOOST_CHECK_EQUAL(csOut->accessData(0), 42);
+}
+
 // After you finished all test you have to end the test suite.
 BOOST_AUTO_TEST_SUITE_END()
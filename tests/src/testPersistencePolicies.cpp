@@ -0,0 +1,190 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#define BOOST_TEST_MODULE PersistencePoliciesTest
+// Only after defining the name include the unit test header.
+#include <boost/test/included/unit_test.hpp>
+using namespace boost::unit_test_framework;
+
+#include <ChimeraTK/ControlSystemAdapter/PersistentDataStorage.h>
+#include <ChimeraTK/ControlSystemAdapter/TimerWheel.h>
+
+#include <boost/filesystem.hpp>
+
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <thread>
+
+using namespace ChimeraTK;
+
+/*********************************************************************************************************************/
+
+static std::string readFile(const std::string& fileName) {
+  std::ifstream file(fileName);
+  std::stringstream content;
+  content << file.rdbuf();
+  return content.str();
+}
+
+/*********************************************************************************************************************/
+
+/** Wait until the file contains the given string. Returns false on timeout. */
+static bool waitForFileContent(const std::string& fileName, const std::string& expected,
+    std::chrono::milliseconds timeout = std::chrono::milliseconds(5000)) {
+  auto end = std::chrono::steady_clock::now() + timeout;
+  while(std::chrono::steady_clock::now() < end) {
+    if(readFile(fileName).find(expected) != std::string::npos) {
+      return true;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  }
+  return false;
+}
+
+/*********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testTimerWheel) {
+  using Clock = std::chrono::steady_clock;
+  auto start = Clock::now();
+  detail::TimerWheel<int> wheel(std::chrono::milliseconds(10), 8, start);
+
+  BOOST_CHECK(!wheel.nextDeadline());
+  // more than one revolution ahead
+  wheel.schedule(start + std::chrono::milliseconds(105), 3);
+  BOOST_CHECK(wheel.nextDeadline() == start + std::chrono::milliseconds(110));
+  wheel.schedule(start + std::chrono::milliseconds(50), 2);
+  // lands in the same slot as the previous timer, but is due earlier
+  wheel.schedule(start + std::chrono::milliseconds(25), 1);
+  BOOST_CHECK_EQUAL(wheel.size(), 3);
+  BOOST_CHECK(wheel.nextDeadline() == start + std::chrono::milliseconds(30));
+
+  std::vector<int> expired;
+  auto collect = [&](int payload) { expired.push_back(payload); };
+
+  wheel.advance(start + std::chrono::milliseconds(20), collect);
+  BOOST_CHECK(expired.empty());
+  wheel.advance(start + std::chrono::milliseconds(30), collect);
+  BOOST_CHECK(expired == std::vector<int>({1}));
+  expired.clear();
+  BOOST_CHECK(wheel.nextDeadline() == start + std::chrono::milliseconds(50));
+
+  // skipping more than one revolution expires everything due
+  wheel.advance(start + std::chrono::milliseconds(200), collect);
+  std::sort(expired.begin(), expired.end());
+  BOOST_CHECK(expired == std::vector<int>({2, 3}));
+  BOOST_CHECK_EQUAL(wheel.size(), 0);
+  expired.clear();
+
+  // deadlines in the past expire with the next tick, and the callback may schedule new timers
+  wheel.schedule(start, 4);
+  wheel.advance(start + std::chrono::milliseconds(200), collect);
+  BOOST_CHECK(expired.empty());
+  wheel.advance(start + std::chrono::milliseconds(210), [&](int payload) {
+    expired.push_back(payload);
+    wheel.schedule(start + std::chrono::milliseconds(300), payload + 1);
+  });
+  BOOST_CHECK(expired == std::vector<int>({4}));
+  BOOST_CHECK_EQUAL(wheel.size(), 1);
+}
+
+/*********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testPolicies) {
+  const std::string fileName = "persistencePoliciesTest.persist";
+  boost::filesystem::remove(fileName);
+  {
+    // the default policy is periodic with the write interval, which is longer than the test
+    PersistentDataStorage storage{"persistencePoliciesTest", 3600};
+    storage.setPersistencePolicy("/setpoint", PersistencePolicy::onChange(std::chrono::milliseconds(200)));
+    storage.setPersistencePolicy("/counter", PersistencePolicy::shutdownOnly());
+
+    auto idUnimportant = storage.registerVariable<int32_t>("/unimportant", 1);
+    auto idSetpoint = storage.registerVariable<int32_t>("/setpoint", 1);
+    auto idCounter = storage.registerVariable<int32_t>("/counter", 1);
+    auto idFast = storage.registerVariable<int32_t>("/fast", 1);
+    storage.setPersistencePolicy("/fast", PersistencePolicy::periodic(std::chrono::milliseconds(300)));
+
+    // changes of variables with the default policy do not cause a write
+    storage.updateValue(idUnimportant, std::vector<int32_t>{11});
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    BOOST_CHECK(!boost::filesystem::exists(fileName));
+
+    // changes of onChange variables are written after the delay, including the other changed values
+    storage.updateValue(idCounter, std::vector<int32_t>{33});
+    storage.updateValue(idSetpoint, std::vector<int32_t>{22});
+    BOOST_CHECK(waitForFileContent(fileName, "<val i=\"0\" v=\"22\"/>"));
+    auto content = readFile(fileName);
+    BOOST_CHECK(content.find("<val i=\"0\" v=\"11\"/>") != std::string::npos);
+    // shutdown-only variables are written with their previous value
+    BOOST_CHECK(content.find("<val i=\"0\" v=\"33\"/>") == std::string::npos);
+
+    // changes of variables with a short period are written within their period
+    storage.updateValue(idFast, std::vector<int32_t>{44});
+    BOOST_CHECK(waitForFileContent(fileName, "<val i=\"0\" v=\"44\"/>", std::chrono::milliseconds(1000)));
+    BOOST_CHECK(readFile(fileName).find("<val i=\"0\" v=\"33\"/>") == std::string::npos);
+  }
+
+  // all values are written when the storage is destroyed
+  auto content = readFile(fileName);
+  BOOST_CHECK(content.find("<val i=\"0\" v=\"33\"/>") != std::string::npos);
+
+  // the values are restored from the file
+  PersistentDataStorage storage{"persistencePoliciesTest", 3600};
+  BOOST_CHECK(storage.retrieveValue<int32_t>(storage.registerVariable<int32_t>("/counter", 1)) ==
+      std::vector<int32_t>({33}));
+  BOOST_CHECK(storage.retrieveValue<int32_t>(storage.registerVariable<int32_t>("/setpoint", 1)) ==
+      std::vector<int32_t>({22}));
+}
+
+/*********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testOnChangeRateLimit) {
+  const std::string fileName = "persistencePoliciesTest.persist";
+  boost::filesystem::remove(fileName);
+  PersistentDataStorage storage{"persistencePoliciesTest", 3600};
+  storage.setPersistencePolicy("/setpoint", PersistencePolicy::onChange(std::chrono::milliseconds(200)));
+  auto id = storage.registerVariable<int32_t>("/setpoint", 1);
+
+  // the delay is not restarted by further changes, so a continuously changing variable is still written
+  bool written = false;
+  for(int32_t i = 0; i < 100 && !written; ++i) {
+    storage.updateValue(id, std::vector<int32_t>{i});
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    written = boost::filesystem::exists(fileName);
+  }
+  BOOST_CHECK(written);
+}
+
+/*********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testShutdownLatency) {
+  boost::filesystem::remove("persistencePoliciesTest.persist");
+  auto storage = std::make_unique<PersistentDataStorage>("persistencePoliciesTest", 3600);
+  auto id = storage->registerVariable<int32_t>("/value", 1);
+  storage->updateValue(id, std::vector<int32_t>{55});
+
+  // the writer thread is sleeping until the write is due in an hour, but the destruction does not wait for it
+  auto start = std::chrono::steady_clock::now();
+  storage.reset();
+  BOOST_CHECK(std::chrono::steady_clock::now() - start < std::chrono::milliseconds(500));
+  BOOST_CHECK(readFile("persistencePoliciesTest.persist").find("<val i=\"0\" v=\"55\"/>") != std::string::npos);
+}
+
+/*********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testStopWriterThread) {
+  boost::filesystem::remove("persistencePoliciesTest.persist");
+  auto storage = std::make_unique<PersistentDataStorage>("persistencePoliciesTest", 3600);
+  auto id = storage->registerVariable<int32_t>("/value", 1);
+  storage->updateValue(id, std::vector<int32_t>{66});
+
+  // stopping the writer thread early does not lose the final write, and may be repeated
+  storage->stopWriterThread();
+  storage->stopWriterThread();
+  storage->updateValue(id, std::vector<int32_t>{77});
+  storage.reset();
+  BOOST_CHECK(readFile("persistencePoliciesTest.persist").find("<val i=\"0\" v=\"77\"/>") != std::string::npos);
+}
+
+/*********************************************************************************************************************/
@@ -0,0 +1,114 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#define BOOST_TEST_MODULE PinnedBufferTest
+// Only after defining the name include the unit test header.
+#include <boost/test/included/unit_test.hpp>
+using namespace boost::unit_test_framework;
+
+#include <ChimeraTK/ControlSystemAdapter/ControlSystemPVManager.h>
+#include <ChimeraTK/ControlSystemAdapter/DevicePVManager.h>
+
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <thread>
+
+using namespace ChimeraTK;
+
+/*********************************************************************************************************************/
+
+struct PipeFixture {
+  PipeFixture() { BOOST_REQUIRE(pipe(fds) == 0); }
+  ~PipeFixture() {
+    close(fds[0]);
+    close(fds[1]);
+  }
+
+  /** Read the given number of bytes from the pipe */
+  std::vector<int32_t> receive(size_t nElements) const {
+    std::vector<int32_t> received(nElements);
+    auto* data = reinterpret_cast<char*>(received.data());
+    size_t remaining = nElements * sizeof(int32_t);
+    while(remaining > 0) {
+      auto n = ::read(fds[0], data, remaining);
+      BOOST_REQUIRE(n > 0);
+      data += n;
+      remaining -= static_cast<size_t>(n);
+    }
+    return received;
+  }
+
+  int fds[2]{};
+};
+
+/*********************************************************************************************************************/
+
+BOOST_FIXTURE_TEST_CASE(testWritev, PipeFixture) {
+  auto pvManagers = createPVManager();
+  auto devArray = pvManagers.second->createProcessArray<int32_t>(
+      SynchronizationDirection::deviceToControlSystem, "/trace", 1000);
+  auto csArray = pvManagers.first->getProcessArray<int32_t>("/trace");
+
+  for(int32_t i = 0; i < 1000; ++i) {
+    devArray->accessData(static_cast<size_t>(i)) = i * 3;
+  }
+  devArray->write();
+  BOOST_REQUIRE(csArray->readNonBlocking());
+  auto expected = csArray->accessChannel(0);
+
+  // pin and send the buffer without copying it
+  auto pinned = csArray->pinBuffer();
+  BOOST_CHECK(pinned.isPinned());
+  BOOST_CHECK_EQUAL(pinned.size(), 1000);
+  const int32_t* pinnedData = pinned.data();
+  iovec vec = pinned.getIovec();
+  BOOST_CHECK_EQUAL(vec.iov_len, 1000 * sizeof(int32_t));
+
+  std::thread reader([&] { BOOST_CHECK(receive(1000) == expected); });
+  auto nWritten = writev(fds[1], &vec, 1);
+  BOOST_CHECK_EQUAL(nWritten, static_cast<ssize_t>(vec.iov_len));
+  reader.join();
+
+  // the process array is still usable while the buffer is pinned
+  BOOST_CHECK_EQUAL(csArray->accessChannel(0).size(), 1000);
+  devArray->write();
+  BOOST_CHECK(csArray->readNonBlocking());
+  BOOST_CHECK(csArray->accessChannel(0) == expected);
+
+  // after the release, the pinned buffer is reused as spare buffer by the next pin
+  pinned.release();
+  BOOST_CHECK(!pinned.isPinned());
+  auto pinnedAgain = csArray->pinBuffer();
+  BOOST_CHECK(csArray->accessChannel(0).data() == pinnedData);
+  BOOST_CHECK(pinnedAgain.getIovec().iov_base != static_cast<const void*>(pinnedData));
+}
+
+/*********************************************************************************************************************/
+
+BOOST_FIXTURE_TEST_CASE(testReleaseCallback, PipeFixture) {
+  auto pvManagers = createPVManager();
+  auto devArray = pvManagers.second->createProcessArray<int32_t>(
+      SynchronizationDirection::deviceToControlSystem, "/trace", 10, "", "", 5);
+  auto csArray = pvManagers.first->getProcessArray<int32_t>("/trace");
+  devArray->write();
+  BOOST_REQUIRE(csArray->readNonBlocking());
+
+  std::function<void()> release;
+  iovec vec{};
+  {
+    auto pinned = csArray->pinBuffer();
+    vec = pinned.getIovec();
+    release = std::move(pinned).releaseCallback();
+    BOOST_CHECK(!pinned.isPinned());
+  }
+  // the pinned buffer outlives the process array and can be released from another thread
+  csArray.reset();
+  pvManagers = {};
+  BOOST_CHECK_EQUAL(writev(fds[1], &vec, 1), static_cast<ssize_t>(10 * sizeof(int32_t)));
+  BOOST_CHECK(receive(10) == std::vector<int32_t>(10, 5));
+  std::thread releaser(release);
+  releaser.join();
+}
+
+/*********************************************************************************************************************/
@@ -0,0 +1,88 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#define BOOST_TEST_MODULE PublishCounterTableTest
+// Only after defining the name include the unit test header.
+#include <boost/test/included/unit_test.hpp>
+using namespace boost::unit_test_framework;
+
+#include <ChimeraTK/ControlSystemAdapter/ControlSystemPVManager.h>
+#include <ChimeraTK/ControlSystemAdapter/DevicePVManager.h>
+#include <ChimeraTK/ControlSystemAdapter/PublishCounterTable.h>
+
+using namespace ChimeraTK;
+
+/*********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testScanChangedProcessVariables) {
+  auto [csManager, devManager] = createPVManager();
+
+  // enough variables to span several chunks
+  constexpr size_t nVariables = 2 * PublishCounterTable::chunkSize + 10;
+  std::vector<ProcessArray<int32_t>::SharedPtr> devArrays;
+  for(size_t i = 0; i < nVariables; ++i) {
+    devArrays.push_back(devManager->createProcessArray<int32_t>(
+        SynchronizationDirection::deviceToControlSystem, "/out" + std::to_string(i), 1));
+  }
+  devManager->createProcessArray<int32_t>(SynchronizationDirection::controlSystemToDevice, "/in", 1);
+  auto bidirectional =
+      devManager->createProcessArray<int32_t>(SynchronizationDirection::bidirectional, "/bidirectional", 1);
+
+  auto& table = csManager->getPublishCounterTable();
+  BOOST_CHECK_EQUAL(table.size(), nVariables + 2);
+
+  PublishCounterScanner scanner(csManager);
+  BOOST_CHECK(scanner.scan().empty());
+
+  // writes of the device side are found, the control system side of the process variable can be looked up
+  devArrays[3]->write();
+  devArrays[3]->write();
+  devArrays[PublishCounterTable::chunkSize + 1]->write();
+  devArrays[nVariables - 1]->write();
+  auto changed = scanner.scan();
+  BOOST_REQUIRE_EQUAL(changed.size(), 3);
+  BOOST_CHECK_EQUAL(changed[0], 3);
+  BOOST_CHECK_EQUAL(changed[1], PublishCounterTable::chunkSize + 1);
+  BOOST_CHECK_EQUAL(changed[2], nVariables - 1);
+  BOOST_CHECK_EQUAL(scanner.getProcessVariable(3)->getName(), "/out3");
+  BOOST_CHECK(scanner.getProcessVariable(3) == csManager->getProcessVariable("/out3"));
+  BOOST_CHECK_EQUAL(table.getCounter(3).load(), 2);
+
+  // nothing changed since the last scan
+  BOOST_CHECK(scanner.scan().empty());
+
+  // writes of the control system side are not counted
+  csManager->getProcessArray<int32_t>("/in")->write();
+  csManager->getProcessArray<int32_t>("/bidirectional")->write();
+  BOOST_CHECK(scanner.scan().empty());
+
+  // the device side of bidirectional process variables is counted
+  bidirectional->write();
+  changed = scanner.scan();
+  BOOST_REQUIRE_EQUAL(changed.size(), 1);
+  BOOST_CHECK_EQUAL(scanner.getProcessVariable(changed[0])->getName(), "/bidirectional");
+
+  // variables created after the scanner are picked up as well
+  auto late = devManager->createProcessArray<int32_t>(SynchronizationDirection::deviceToControlSystem, "/late", 1);
+  BOOST_CHECK(scanner.scan().empty());
+  late->write();
+  changed = scanner.scan();
+  BOOST_REQUIRE_EQUAL(changed.size(), 1);
+  BOOST_CHECK_EQUAL(changed[0], nVariables + 2);
+}
+
+/*********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testMultiProducer) {
+  auto [csManager, devManager] = createPVManager();
+  auto sender = devManager->createMultiProducerProcessArray<int32_t>("/multi", 1);
+  auto additional = devManager->createAdditionalProducer<int32_t>("/multi");
+
+  PublishCounterScanner scanner(csManager);
+  sender->write();
+  additional->write();
+  BOOST_CHECK_EQUAL(csManager->getPublishCounterTable().getCounter(0).load(), 2);
+  BOOST_CHECK_EQUAL(scanner.scan().size(), 1);
+}
+
+/*********************************************************************************************************************/
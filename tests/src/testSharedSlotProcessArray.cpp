@@ -0,0 +1,133 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#define BOOST_TEST_MODULE SharedSlotProcessArrayTest
+// Only after defining the name include the unit test header.
+#include <boost/test/included/unit_test.hpp>
+using namespace boost::unit_test_framework;
+
+#include <ChimeraTK/ControlSystemAdapter/ControlSystemPVManager.h>
+#include <ChimeraTK/ControlSystemAdapter/DevicePVManager.h>
+#include <ChimeraTK/ControlSystemAdapter/SharedSlotProcessArray.h>
+
+#include <boost/thread.hpp>
+
+using namespace ChimeraTK;
+
+/*********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testBothDirections) {
+  auto pvs = createSharedSlotProcessArray<int32_t>({1, 2, 3}, "/setpoint");
+  auto a = pvs.first;
+  auto b = pvs.second;
+  BOOST_CHECK(a->isReadable() && a->isWriteable());
+  BOOST_CHECK_EQUAL(a->getUniqueId(), b->getUniqueId());
+  BOOST_CHECK(b->accessChannel(0) == std::vector<int32_t>({1, 2, 3}));
+  BOOST_CHECK(!a->readNonBlocking());
+  BOOST_CHECK(!b->readNonBlocking());
+
+  a->accessData(1) = 20;
+  BOOST_CHECK(!a->write());
+  // writing does not take the value away
+  BOOST_CHECK_EQUAL(a->accessData(1), 20);
+  BOOST_CHECK(!a->readNonBlocking());
+  BOOST_CHECK(b->readNonBlocking());
+  BOOST_CHECK(b->accessChannel(0) == std::vector<int32_t>({1, 20, 3}));
+  BOOST_CHECK(b->getVersionNumber() == a->getVersionNumber());
+  BOOST_CHECK(!b->readNonBlocking());
+
+  b->accessData(0) = 10;
+  b->setDataValidity(DataValidity::faulty);
+  b->writeDestructively();
+  BOOST_CHECK(a->readNonBlocking());
+  BOOST_CHECK(a->accessChannel(0) == std::vector<int32_t>({10, 20, 3}));
+  BOOST_CHECK(a->dataValidity() == DataValidity::faulty);
+
+  // values written before the other side has read are merged, reported as lost data
+  a->accessData(2) = 30;
+  BOOST_CHECK(!a->write());
+  a->accessData(2) = 31;
+  BOOST_CHECK(a->write());
+  BOOST_CHECK(b->readNonBlocking());
+  BOOST_CHECK_EQUAL(b->accessData(2), 31);
+  BOOST_CHECK(!b->readNonBlocking());
+}
+
+/*********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testLastVersionWins) {
+  auto pvs = createSharedSlotProcessArray<int32_t>({0}, "/setpoint");
+  auto a = boost::dynamic_pointer_cast<SharedSlotProcessArray<int32_t>>(pvs.first);
+  auto b = boost::dynamic_pointer_cast<SharedSlotProcessArray<int32_t>>(pvs.second);
+  size_t nRejectedA = 0;
+  size_t nRejectedB = 0;
+  a->setValueRejectCallback([&] { ++nRejectedA; });
+  b->setValueRejectCallback([&] { ++nRejectedB; });
+
+  VersionNumber older;
+  VersionNumber newer;
+
+  // both sides write concurrently, the older value is rejected by the other side
+  b->accessData(0) = 2;
+  b->write(newer);
+  a->accessData(0) = 1;
+  a->write(older);
+
+  BOOST_CHECK(!b->readNonBlocking());
+  BOOST_CHECK_EQUAL(nRejectedB, 1);
+  BOOST_CHECK_EQUAL(b->accessData(0), 2);
+
+  BOOST_CHECK(a->readNonBlocking());
+  BOOST_CHECK_EQUAL(nRejectedA, 0);
+  BOOST_CHECK_EQUAL(a->accessData(0), 2);
+  BOOST_CHECK(a->getVersionNumber() == newer);
+}
+
+/*********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testBlockingReadAndInterrupt) {
+  auto pvs = createSharedSlotProcessArray<int32_t>({0}, "/setpoint");
+  auto a = pvs.first;
+  auto b = pvs.second;
+
+  boost::thread reader([&] { b->read(); });
+  boost::this_thread::sleep_for(boost::chrono::milliseconds(50));
+  a->accessData(0) = 5;
+  a->write();
+  reader.join();
+  BOOST_CHECK_EQUAL(b->accessData(0), 5);
+
+  bool interrupted = false;
+  boost::thread interruptedReader([&] {
+    try {
+      b->read();
+    }
+    catch(boost::thread_interrupted&) {
+      interrupted = true;
+    }
+  });
+  boost::this_thread::sleep_for(boost::chrono::milliseconds(50));
+  b->interrupt();
+  interruptedReader.join();
+  BOOST_CHECK(interrupted);
+}
+
+/*********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testPVManager) {
+  auto pvManagers = createPVManager();
+  auto devSetpoint = pvManagers.second->createSharedSlotProcessArray<double>("/setpoint", 2, "V", "", 1.5);
+  auto csSetpoint = pvManagers.first->getProcessArray<double>("/setpoint");
+  BOOST_CHECK_EQUAL(csSetpoint->accessData(1), 1.5);
+  BOOST_CHECK_EQUAL(csSetpoint->getUnit(), "V");
+
+  csSetpoint->accessData(0) = 4.;
+  csSetpoint->write();
+  BOOST_CHECK(devSetpoint->readNonBlocking());
+  BOOST_CHECK_EQUAL(devSetpoint->accessData(0), 4.);
+
+  // only the control system side may have a persistent data storage
+  BOOST_CHECK_THROW(devSetpoint->setPersistentDataStorage({}), ChimeraTK::logic_error);
+}
+
+/*********************************************************************************************************************/
@@ -0,0 +1,117 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#define BOOST_TEST_MODULE StagedInitialisationTest
+// Only after defining the name include the unit test header.
+#include <boost/test/included/unit_test.hpp>
+using namespace boost::unit_test_framework;
+
+#include <ChimeraTK/ControlSystemAdapter/ApplicationBase.h>
+#include <ChimeraTK/ControlSystemAdapter/ControlSystemPVManager.h>
+#include <ChimeraTK/ControlSystemAdapter/DevicePVManager.h>
+
+#include <algorithm>
+
+using namespace ChimeraTK;
+
+/*********************************************************************************************************************/
+
+class ModularApplication : public ApplicationBase {
+ public:
+  ModularApplication() : ApplicationBase("modularApplication") {}
+  ~ModularApplication() override { shutdown(); }
+
+  void initialise() override { initialiseModules(4); }
+  void run() override {}
+
+  // record the order in which the modules have completed
+  void addModule(const std::string& name, const std::vector<std::string>& dependencies, size_t nPVs = 10) {
+    registerInitialisationModule(
+        name, dependencies,
+        [this, name, nPVs](DevicePVManager& pvManager) {
+          for(size_t i = 0; i < nPVs; ++i) {
+            pvManager.createProcessArray<int32_t>(
+                SynchronizationDirection::deviceToControlSystem, "/var" + std::to_string(i), 1);
+          }
+          std::lock_guard<std::mutex> lock(orderMutex);
+          order.push_back(name);
+        },
+        "/" + name);
+  }
+
+  size_t position(const std::string& name) {
+    return std::find(order.begin(), order.end(), name) - order.begin();
+  }
+
+  std::mutex orderMutex;
+  std::vector<std::string> order;
+};
+
+/*********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testDependencyOrder) {
+  auto pvManagers = createPVManager();
+  ModularApplication app;
+  app.setPVManager(pvManagers.second);
+
+  app.addModule("a", {});
+  app.addModule("b", {"a"});
+  app.addModule("c", {});
+  app.addModule("d", {"b", "c"});
+  app.addModule("e", {});
+  BOOST_CHECK_THROW(app.addModule("a", {}), ChimeraTK::logic_error);
+
+  app.initialise();
+
+  BOOST_REQUIRE_EQUAL(app.order.size(), 5);
+  BOOST_CHECK(app.position("a") < app.position("b"));
+  BOOST_CHECK(app.position("b") < app.position("d"));
+  BOOST_CHECK(app.position("c") < app.position("d"));
+
+  // all modules have created their PVs in their own PV set
+  BOOST_CHECK_EQUAL(pvManagers.first->getAllProcessVariables().size(), 50);
+  BOOST_CHECK(pvManagers.first->hasProcessVariable("/d/var9"));
+
+  // the modules have been consumed
+  app.initialise();
+  BOOST_CHECK_EQUAL(app.order.size(), 5);
+}
+
+/*********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testInvalidDependencies) {
+  auto pvManagers = createPVManager();
+  ModularApplication app;
+  app.setPVManager(pvManagers.second);
+
+  app.addModule("a", {"unknown"});
+  BOOST_CHECK_THROW(app.initialise(), ChimeraTK::logic_error);
+
+  app.addModule("a", {"c"});
+  app.addModule("b", {"a"});
+  app.addModule("c", {"b"});
+  app.addModule("d", {});
+  BOOST_CHECK_THROW(app.initialise(), ChimeraTK::logic_error);
+
+  // nothing has been started
+  BOOST_CHECK(app.order.empty());
+}
+
+/*********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testException) {
+  auto pvManagers = createPVManager();
+  ModularApplication app;
+  app.setPVManager(pvManagers.second);
+
+  app.addModule("a", {});
+  app.registerInitialisationModule("failing", {"a"}, [](DevicePVManager&) { throw std::runtime_error("failed"); });
+  app.addModule("c", {"failing"});
+
+  BOOST_CHECK_THROW(app.initialise(), std::runtime_error);
+  // the module depending on the failed one has not been started
+  BOOST_CHECK_EQUAL(app.order.size(), 1);
+  BOOST_CHECK_EQUAL(app.order[0], "a");
+}
+
+/*********************************************************************************************************************/
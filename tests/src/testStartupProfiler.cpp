@@ -0,0 +1,104 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#define BOOST_TEST_MODULE StartupProfilerTest
+// Only after defining the name include the unit test header.
+#include <boost/test/included/unit_test.hpp>
+using namespace boost::unit_test_framework;
+
+#include <ChimeraTK/ControlSystemAdapter/ApplicationFactory.h>
+#include <ChimeraTK/ControlSystemAdapter/ControlSystemPVManager.h>
+#include <ChimeraTK/ControlSystemAdapter/DevicePVManager.h>
+#include <ChimeraTK/ControlSystemAdapter/StartupProfiler.h>
+
+#include <boost/filesystem.hpp>
+
+#include <sstream>
+
+using namespace ChimeraTK;
+
+/*********************************************************************************************************************/
+
+class ProfiledApplication : public ApplicationBase {
+ public:
+  ProfiledApplication() : ApplicationBase("profiledApplication") {}
+  ~ProfiledApplication() override { shutdown(); }
+
+  void initialise() override {
+    for(int i = 0; i < 3; ++i) {
+      _processVariableManager->createProcessArray<int32_t>(
+          SynchronizationDirection::controlSystemToDevice, "/var" + std::to_string(i), 1);
+    }
+  }
+
+  void run() override {}
+};
+
+/*********************************************************************************************************************/
+
+static const StartupPhaseStatistics* findPhase(
+    const std::vector<StartupPhaseStatistics>& profile, const std::string& name) {
+  for(auto& phase : profile) {
+    if(phase.name == name) {
+      return &phase;
+    }
+  }
+  return nullptr;
+}
+
+/*********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testDisabledByDefault) {
+  {
+    StartupPhase phase("notRecorded");
+  }
+  BOOST_CHECK(getStartupProfile().empty());
+}
+
+/*********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testStartupPhases) {
+  boost::filesystem::remove("profiledApplication.persist");
+  setEnableStartupProfiling(true);
+
+  ApplicationFactory<ProfiledApplication> factory;
+  auto pvManagers = createPVManager();
+  auto& application = ApplicationBase::getInstance();
+  application.setPVManager(pvManagers.second);
+  application.initialiseProfiled();
+  pvManagers.first->enablePersistentDataStorage();
+  auto pvs = pvManagers.first->getAllProcessVariables();
+  BOOST_CHECK_EQUAL(pvs.size(), 3);
+
+  setEnableStartupProfiling(false);
+
+  auto profile = getStartupProfile();
+  const std::vector<std::pair<std::string, size_t>> expected{{"ApplicationFactory::createApplication", 1},
+      {"ApplicationBase::initialise", 1}, {"PVManager::createProcessArray", 3},
+      {"PersistentDataStorage::readFromFile", 1}, {"ControlSystemPVManager::getAllProcessVariables", 1},
+      {"PersistentDataStorage::registerVariable", 3}, {"setPersistentDataStorage initial value write", 3}};
+  for(auto& [name, count] : expected) {
+    auto* phase = findPhase(profile, name);
+    BOOST_REQUIRE_MESSAGE(phase != nullptr, "Phase " + name + " not found");
+    BOOST_CHECK_EQUAL(phase->count, count);
+    BOOST_CHECK(phase->wallTime >= 0.);
+    BOOST_CHECK(phase->cpuTime >= 0.);
+  }
+
+  // nested phases are included in the outer phase
+  BOOST_CHECK(findPhase(profile, "ApplicationBase::initialise")->wallTime >=
+      findPhase(profile, "PVManager::createProcessArray")->wallTime);
+
+  std::stringstream summary;
+  printStartupProfile(summary);
+  BOOST_CHECK(summary.str().find("PVManager::createProcessArray") != std::string::npos);
+
+  std::stringstream csv;
+  writeStartupProfileCsv(csv);
+  BOOST_CHECK(csv.str().find("PVManager::createProcessArray,3,") != std::string::npos);
+
+  clearStartupProfile();
+  BOOST_CHECK(getStartupProfile().empty());
+}
+
+/*********************************************************************************************************************/
@@ -0,0 +1,149 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#define BOOST_TEST_MODULE SynchronisationExecutorTest
+// Only after defining the name include the unit test header.
+#include <boost/test/included/unit_test.hpp>
+using namespace boost::unit_test_framework;
+
+#include <ChimeraTK/ControlSystemAdapter/ControlSystemPVManager.h>
+#include <ChimeraTK/ControlSystemAdapter/DevicePVManager.h>
+
+#include <atomic>
+#include <thread>
+
+using namespace ChimeraTK;
+
+/*********************************************************************************************************************/
+
+/** Wait until the counter reaches the given value. Returns false on timeout. */
+static bool waitFor(const std::atomic<int>& counter, int value) {
+  auto end = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while(counter < value) {
+    if(std::chrono::steady_clock::now() > end) {
+      return false;
+    }
+    std::this_thread::yield();
+  }
+  return true;
+}
+
+/*********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testDisjointGroupsRunConcurrently) {
+  auto pvManagers = createPVManager();
+  auto devManager = pvManagers.second;
+
+  // both functions only return once the other one has been entered, which requires concurrent execution
+  std::atomic<int> entered{0};
+  bool concurrent1 = false;
+  bool concurrent2 = false;
+  std::thread other([&] {
+    devManager->executeSynchronisationFunction({"/location1"}, [&] {
+      ++entered;
+      concurrent1 = waitFor(entered, 2);
+    });
+  });
+  devManager->executeSynchronisationFunction({"/location2"}, [&] {
+    ++entered;
+    concurrent2 = waitFor(entered, 2);
+  });
+  other.join();
+  BOOST_CHECK(concurrent1);
+  BOOST_CHECK(concurrent2);
+}
+
+/*********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testReadOnlyFunctionsRunConcurrently) {
+  auto pvManagers = createPVManager();
+  auto devManager = pvManagers.second;
+
+  std::atomic<int> entered{0};
+  bool concurrent1 = false;
+  bool concurrent2 = false;
+  std::thread other([&] {
+    devManager->executeSynchronisationFunction(
+        {"/location1", "/location2"},
+        [&] {
+          ++entered;
+          concurrent1 = waitFor(entered, 2);
+        },
+        SynchronisationExecutor::AccessMode::readOnly);
+  });
+  devManager->executeSynchronisationFunction(
+      {"/location2"},
+      [&] {
+        ++entered;
+        concurrent2 = waitFor(entered, 2);
+      },
+      SynchronisationExecutor::AccessMode::readOnly);
+  other.join();
+  BOOST_CHECK(concurrent1);
+  BOOST_CHECK(concurrent2);
+}
+
+/*********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testExclusiveAccess) {
+  auto pvManagers = createPVManager();
+  auto devManager = pvManagers.second;
+  auto devArray = devManager->createProcessArray<int32_t>(
+      SynchronizationDirection::deviceToControlSystem, "/location/counter", 1);
+  devManager->addToSynchronisationGroup("/location", "/location/counter");
+
+  // the control system side locks the group of the process variable it accesses
+  auto& executor = pvManagers.first->getSynchronisationExecutor();
+  BOOST_CHECK(executor.getGroups("/location/counter") == std::vector<RegisterPath>({"/location"}));
+
+  // concurrent increments with overlapping groups in different orders neither deadlock nor lose updates
+  std::vector<std::thread> threads;
+  for(size_t i = 0; i < 4; ++i) {
+    threads.emplace_back([&, i] {
+      for(size_t k = 0; k < 1000; ++k) {
+        if(i % 2 == 0) {
+          devManager->executeSynchronisationFunction(
+              {"/other", "/location"}, [&] { devArray->accessData(0) = devArray->accessData(0) + 1; });
+        }
+        else {
+          auto lock = executor.lockProcessVariables({"/location/counter"});
+          devArray->accessData(0) = devArray->accessData(0) + 1;
+        }
+      }
+    });
+  }
+  for(auto& thread : threads) {
+    thread.join();
+  }
+  BOOST_CHECK_EQUAL(devArray->accessData(0), 4000);
+
+  // the lock is released when the GroupLock is destroyed or unlocked
+  {
+    auto lock = executor.lock({"/location"});
+    lock.unlock();
+    auto readLock = executor.lock({"/location"}, SynchronisationExecutor::AccessMode::readOnly);
+  }
+
+  BOOST_CHECK_THROW(auto lock = executor.lockProcessVariables({"/location/unknown"}), ChimeraTK::logic_error);
+}
+
+/*********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testSubManagerPrefix) {
+  auto pvManagers = createPVManager();
+  auto subManager = pvManagers.second->getSubManager("/app1");
+  subManager->createProcessArray<int32_t>(SynchronizationDirection::deviceToControlSystem, "/value", 1);
+  subManager->addToSynchronisationGroup("/location", "/value");
+
+  // the names are absolute for the shared executor
+  auto& executor = pvManagers.first->getSynchronisationExecutor();
+  BOOST_CHECK(executor.getGroups("/app1/value") == std::vector<RegisterPath>({"/app1/location"}));
+
+  // holding the group of another application does not block
+  auto lock = executor.lock({"/app2/location"});
+  bool executed = false;
+  subManager->executeSynchronisationFunction({"/location"}, [&] { executed = true; });
+  BOOST_CHECK(executed);
+}
+
+/*********************************************************************************************************************/
@@ -0,0 +1,134 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#define BOOST_TEST_MODULE TransferTracerTest
+// Only after defining the name include the unit test header.
+#include <boost/test/included/unit_test.hpp>
+using namespace boost::unit_test_framework;
+
+#include "BidirectionalProcessArray.h"
+#include "TransferTracer.h"
+#include "UnidirectionalProcessArray.h"
+
+#include <boost/thread.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+using namespace ChimeraTK;
+
+/*********************************************************************************************************************/
+
+static size_t countOccurrences(const std::string& text, const std::string& pattern) {
+  size_t count = 0;
+  for(auto pos = text.find(pattern); pos != std::string::npos; pos = text.find(pattern, pos + 1)) {
+    ++count;
+  }
+  return count;
+}
+
+/*********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testDisabledByDefault) {
+  clearTransferTrace();
+  auto senderReceiver = createSynchronizedProcessArray<int32_t>(1, "disabledVar");
+  senderReceiver.first->write();
+  senderReceiver.second->read();
+
+  std::stringstream trace;
+  writeTransferTrace(trace);
+  BOOST_CHECK(trace.str().find("disabledVar") == std::string::npos);
+}
+
+/*********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testWriteAndRead) {
+  clearTransferTrace();
+  setEnableTransferTracing(true);
+
+  auto senderReceiver = createSynchronizedProcessArray<int32_t>(1, "tracedVar");
+  auto sender = senderReceiver.first;
+  auto receiver = senderReceiver.second;
+
+  // write from a different thread, so the trace shows two threads
+  boost::thread writer([&] {
+    for(int i = 0; i < 3; ++i) {
+      sender->accessData(0) = i;
+      sender->write();
+    }
+  });
+  writer.join();
+  receiver->read();
+  receiver->readNonBlocking(); // no new data
+
+  setEnableTransferTracing(false);
+  sender->write(); // must not be recorded any more
+
+  std::stringstream trace;
+  writeTransferTrace(trace);
+  auto text = trace.str();
+  BOOST_CHECK_EQUAL(countOccurrences(text, R"("name":"/tracedVar","cat":"write")"), 3);
+  BOOST_CHECK_EQUAL(countOccurrences(text, R"("name":"/tracedVar","cat":"read")"), 2);
+  BOOST_CHECK_EQUAL(countOccurrences(text, R"("hasNewData":1)"), 1);
+  BOOST_CHECK_EQUAL(countOccurrences(text, R"("hasNewData":0)"), 1);
+  BOOST_CHECK(text.find("\"traceEvents\"") != std::string::npos);
+
+  // clearing removes all events but keeps the thread metadata
+  clearTransferTrace();
+  std::stringstream cleared;
+  writeTransferTrace(cleared);
+  BOOST_CHECK(cleared.str().find("/tracedVar") == std::string::npos);
+  BOOST_CHECK(cleared.str().find("thread_name") != std::string::npos);
+}
+
+/*********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testBidirectionalReject) {
+  clearTransferTrace();
+  setEnableTransferTracing(true);
+
+  auto pvs = createBidirectionalSynchronizedProcessArray<int32_t>(1, "bidirVar");
+  auto a = pvs.first;
+  auto b = pvs.second;
+
+  // b sends a newer value than a, so the value from a will be rejected when b reads it
+  VersionNumber older;
+  VersionNumber newer;
+  b->write(newer);
+  a->write(older);
+  BOOST_CHECK(!b->readNonBlocking());
+
+  setEnableTransferTracing(false);
+
+  std::stringstream trace;
+  writeTransferTrace(trace);
+  BOOST_CHECK_EQUAL(countOccurrences(trace.str(), R"("name":"/bidirVar","cat":"reject")"), 1);
+}
+
+/*********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testDumpBeforeExit) {
+  clearTransferTrace();
+  std::string fileName = "testTransferTracer.json";
+  std::remove(fileName.c_str());
+
+  // nothing to write without a file name
+  BOOST_CHECK(!dumpTransferTrace());
+
+  setEnableTransferTracing(true);
+  setTransferTraceFileAtExit(fileName);
+  auto senderReceiver = createSynchronizedProcessArray<int32_t>(1, "dumpedVar");
+  senderReceiver.first->write();
+  setEnableTransferTracing(false);
+
+  // the trace is written once, not again at exit
+  BOOST_CHECK(dumpTransferTrace());
+  BOOST_CHECK(!dumpTransferTrace());
+  std::ifstream file(fileName);
+  std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  BOOST_CHECK_EQUAL(countOccurrences(text, R"("name":"/dumpedVar","cat":"write")"), 1);
+  std::remove(fileName.c_str());
+}
+
+/*********************************************************************************************************************/
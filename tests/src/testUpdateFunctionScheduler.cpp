@@ -0,0 +1,141 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#define BOOST_TEST_MODULE UpdateFunctionSchedulerTest
+// Only after defining the name include the unit test header.
+#include <boost/test/included/unit_test.hpp>
+using namespace boost::unit_test_framework;
+
+#include <ChimeraTK/ControlSystemAdapter/UpdateFunctionScheduler.h>
+#include <ChimeraTK/Exception.h>
+
+#include <atomic>
+#include <thread>
+
+using namespace ChimeraTK;
+using namespace std::chrono_literals;
+
+/*********************************************************************************************************************/
+
+/** Wait until the counter reaches the given value. Returns false on timeout. */
+static bool waitFor(const std::atomic<int>& counter, int value) {
+  auto end = std::chrono::steady_clock::now() + 5s;
+  while(counter < value) {
+    if(std::chrono::steady_clock::now() > end) {
+      return false;
+    }
+    std::this_thread::sleep_for(1ms);
+  }
+  return true;
+}
+
+/*********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testPeriodic) {
+  UpdateFunctionScheduler scheduler;
+  std::atomic<int> fastCount{0};
+  std::atomic<int> slowCount{0};
+  auto fast = scheduler.addPeriodicFunction(10ms, [&] { ++fastCount; });
+  auto slow = scheduler.addPeriodicFunction(50ms, [&] { ++slowCount; });
+
+  BOOST_REQUIRE(waitFor(slowCount, 4));
+  scheduler.removeFunction(slow);
+  scheduler.removeFunction(fast);
+
+  // releases are at fixed points in time, so the ratio is exact apart from the phase (and skipped releases on a busy
+  // machine)
+  BOOST_CHECK_GE(fastCount, 15);
+  BOOST_CHECK_LE(fastCount, 21);
+
+  BOOST_CHECK_THROW(auto statistics = scheduler.getStatistics(fast), ChimeraTK::logic_error);
+
+  // no more executions after the removal
+  int count = fastCount;
+  std::this_thread::sleep_for(30ms);
+  BOOST_CHECK_EQUAL(fastCount, count);
+}
+
+/*********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testStatistics) {
+  UpdateFunctionScheduler scheduler;
+  std::atomic<int> count{0};
+  auto id = scheduler.addPeriodicFunction(10ms, [&] { ++count; });
+  BOOST_REQUIRE(waitFor(count, 5));
+  auto statistics = scheduler.getStatistics(id);
+  BOOST_CHECK_GE(statistics.nExecutions, 4);
+  BOOST_CHECK_GE(statistics.maxJitter.count(), 0);
+  BOOST_CHECK(statistics.meanJitter() <= statistics.maxJitter);
+
+  // a function taking longer than its period misses its deadlines
+  std::atomic<int> slowCount{0};
+  auto slow = scheduler.addPeriodicFunction(5ms, [&] {
+    std::this_thread::sleep_for(12ms);
+    ++slowCount;
+  });
+  BOOST_REQUIRE(waitFor(slowCount, 3));
+  statistics = scheduler.getStatistics(slow);
+  BOOST_CHECK_GE(statistics.nDeadlineMisses, 3);
+  BOOST_CHECK(statistics.maxDuration >= 12ms);
+}
+
+/*********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testTriggered) {
+  UpdateFunctionScheduler scheduler;
+  std::atomic<int> count{0};
+  std::atomic<bool> block{true};
+  auto id = scheduler.addTriggeredFunction([&] {
+    ++count;
+    while(block) {
+      std::this_thread::sleep_for(1ms);
+    }
+  });
+
+  std::this_thread::sleep_for(20ms);
+  BOOST_CHECK_EQUAL(count, 0);
+
+  scheduler.trigger(id);
+  BOOST_REQUIRE(waitFor(count, 1));
+
+  // triggers while running cause exactly one more execution
+  scheduler.trigger(id);
+  scheduler.trigger(id);
+  block = false;
+  BOOST_REQUIRE(waitFor(count, 2));
+  std::this_thread::sleep_for(20ms);
+  BOOST_CHECK_EQUAL(count, 2);
+  BOOST_CHECK_EQUAL(scheduler.getStatistics(id).nExecutions, 2);
+
+  // a triggered function completing after its deadline is counted
+  auto late = scheduler.addTriggeredFunction([&] { std::this_thread::sleep_for(5ms); }, 1ms);
+  scheduler.trigger(late);
+  auto end = std::chrono::steady_clock::now() + 5s;
+  while(scheduler.getStatistics(late).nExecutions == 0 && std::chrono::steady_clock::now() < end) {
+    std::this_thread::sleep_for(1ms);
+  }
+  BOOST_CHECK_EQUAL(scheduler.getStatistics(late).nDeadlineMisses, 1);
+
+  BOOST_CHECK_THROW(scheduler.trigger(12345), ChimeraTK::logic_error);
+}
+
+/*********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testSynchronisationGroups) {
+  SynchronisationExecutor executor;
+  UpdateFunctionScheduler scheduler(2, 1000us, &executor);
+  std::atomic<int> count{0};
+  auto id = scheduler.addTriggeredFunction([&] { ++count; }, {}, {"/location"});
+
+  // the function is blocked while the group is locked
+  {
+    auto lock = executor.lock({"/location"});
+    scheduler.trigger(id);
+    std::this_thread::sleep_for(20ms);
+    BOOST_CHECK_EQUAL(count, 0);
+  }
+  BOOST_CHECK(waitFor(count, 1));
+  BOOST_CHECK(scheduler.getStatistics(id).maxDuration >= 10ms);
+}
+
+/*********************************************************************************************************************/
@@ -0,0 +1,102 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#define BOOST_TEST_MODULE VersionNumberBatchTest
+// Only after defining the name include the unit test header.
+#include <boost/test/included/unit_test.hpp>
+using namespace boost::unit_test_framework;
+
+#include <ChimeraTK/ControlSystemAdapter/ControlSystemPVManager.h>
+#include <ChimeraTK/ControlSystemAdapter/DevicePVManager.h>
+#include <ChimeraTK/ControlSystemAdapter/VersionNumberBatch.h>
+
+#include <boost/filesystem.hpp>
+
+#include <thread>
+
+using namespace ChimeraTK;
+
+/*********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testBatchScope) {
+  BOOST_CHECK(!VersionNumberBatch::isActive());
+  VersionNumber before = VersionNumberBatch::next();
+  BOOST_CHECK(VersionNumberBatch::next() > before);
+
+  VersionNumber batchVersion{nullptr};
+  {
+    VersionNumberBatch batch;
+    BOOST_CHECK(VersionNumberBatch::isActive());
+    batchVersion = batch.getVersionNumber();
+    BOOST_CHECK(batchVersion > before);
+    BOOST_CHECK(VersionNumberBatch::next() == batchVersion);
+    BOOST_CHECK(VersionNumberBatch::next() == batchVersion);
+
+    {
+      // nested batches share the version of the outermost batch
+      VersionNumberBatch inner;
+      BOOST_CHECK(inner.getVersionNumber() == batchVersion);
+    }
+    BOOST_CHECK(VersionNumberBatch::isActive());
+    BOOST_CHECK(VersionNumberBatch::next() == batchVersion);
+
+    // other threads are not affected
+    std::thread other([&] {
+      BOOST_CHECK(!VersionNumberBatch::isActive());
+      BOOST_CHECK(VersionNumberBatch::next() != batchVersion);
+    });
+    other.join();
+  }
+
+  BOOST_CHECK(!VersionNumberBatch::isActive());
+  BOOST_CHECK(VersionNumberBatch::next() > batchVersion);
+}
+
+/*********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testPublishDirtyInBatch) {
+  auto pvManagers = createPVManager();
+  auto devManager = pvManagers.second;
+  auto a = devManager->createProcessArray<int32_t>(SynchronizationDirection::deviceToControlSystem, "/a", 1);
+  auto b = devManager->createProcessArray<int32_t>(SynchronizationDirection::deviceToControlSystem, "/b", 1);
+  auto c = devManager->createProcessArray<int32_t>(SynchronizationDirection::deviceToControlSystem, "/c", 1);
+  auto dirtyA = devManager->getDirtyTrackingAccessor<int32_t>("/a");
+
+  // the bulk write of the adapter and the writes of the application share one version number
+  {
+    VersionNumberBatch batch;
+    dirtyA.set(0, 1);
+    devManager->publishDirty();
+    b->write(batch.getVersionNumber());
+  }
+  c->write();
+
+  auto csA = pvManagers.first->getProcessArray<int32_t>("/a");
+  auto csB = pvManagers.first->getProcessArray<int32_t>("/b");
+  auto csC = pvManagers.first->getProcessArray<int32_t>("/c");
+  BOOST_REQUIRE(csA->readNonBlocking());
+  BOOST_REQUIRE(csB->readNonBlocking());
+  BOOST_REQUIRE(csC->readNonBlocking());
+  BOOST_CHECK(csA->getVersionNumber() == csB->getVersionNumber());
+  BOOST_CHECK(csC->getVersionNumber() > csA->getVersionNumber());
+}
+
+/*********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testInitialValuesShareVersion) {
+  auto pvManagers = createPVManager();
+  auto devManager = pvManagers.second;
+  auto csManager = pvManagers.first;
+  auto x = devManager->createProcessArray<int32_t>(SynchronizationDirection::controlSystemToDevice, "/app/x", 1);
+  auto y = devManager->createProcessArray<int32_t>(SynchronizationDirection::controlSystemToDevice, "/app/y", 1);
+
+  boost::filesystem::remove("versionNumberBatchTest.persist");
+  csManager->enablePersistentDataStorage("/app", boost::make_shared<PersistentDataStorage>("versionNumberBatchTest"));
+  (void)csManager->getAllProcessVariables();
+
+  BOOST_REQUIRE(x->readNonBlocking());
+  BOOST_REQUIRE(y->readNonBlocking());
+  BOOST_CHECK(x->getVersionNumber() == y->getVersionNumber());
+}
+
+/*********************************************************************************************************************/
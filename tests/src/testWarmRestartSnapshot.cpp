@@ -0,0 +1,159 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#define BOOST_TEST_MODULE WarmRestartSnapshotTest
+// Only after defining the name include the unit test header.
+#include <boost/test/included/unit_test.hpp>
+using namespace boost::unit_test_framework;
+
+#include <ChimeraTK/ControlSystemAdapter/ControlSystemPVManager.h>
+#include <ChimeraTK/ControlSystemAdapter/DevicePVManager.h>
+#include <ChimeraTK/ControlSystemAdapter/WarmRestartSnapshot.h>
+
+#include <cstdio>
+#include <fstream>
+
+using namespace ChimeraTK;
+
+/*********************************************************************************************************************/
+
+struct Fixture {
+  Fixture() { std::remove(fileName.c_str()); }
+  ~Fixture() { std::remove(fileName.c_str()); }
+
+  /** Create the process variables as the application would do at each start */
+  static std::pair<boost::shared_ptr<ControlSystemPVManager>, boost::shared_ptr<DevicePVManager>> createApplication(
+      size_t arraySize = 3) {
+    auto [csManager, devManager] = createPVManager();
+    devManager->createProcessArray<int32_t>(SynchronizationDirection::deviceToControlSystem, "/array", arraySize);
+    devManager->createProcessArray<double>(SynchronizationDirection::deviceToControlSystem, "/double", 1);
+    devManager->createProcessArray<std::string>(SynchronizationDirection::deviceToControlSystem, "/string", 2);
+    devManager->createProcessArray<int32_t>(SynchronizationDirection::deviceToControlSystem, "/neverWritten", 1);
+    devManager->createProcessArray<int32_t>(SynchronizationDirection::controlSystemToDevice, "/setpoint", 1);
+    return {csManager, devManager};
+  }
+
+  std::string fileName{WarmRestartSnapshot::getDefaultFileName("testWarmRestartSnapshot")};
+};
+
+/*********************************************************************************************************************/
+
+BOOST_FIXTURE_TEST_CASE(testSaveAndRestore, Fixture) {
+  WarmRestartSnapshot snapshot(fileName);
+  VersionNumber version;
+  {
+    auto [csManager, devManager] = createApplication();
+    auto array = devManager->getProcessArray<int32_t>("/array");
+    array->accessChannel(0) = {1, 2, 3};
+    array->write(version);
+    auto doubleValue = devManager->getProcessArray<double>("/double");
+    doubleValue->accessData(0) = 4.5;
+    doubleValue->setDataValidity(DataValidity::faulty);
+    doubleValue->write();
+    auto string = devManager->getProcessArray<std::string>("/string");
+    string->accessChannel(0) = {"hello", ""};
+    string->write();
+
+    // the control system adapter saves what it has received
+    for(const auto& pv : csManager->getAllProcessVariables()) {
+      if(pv->isReadable()) {
+        pv->readNonBlocking();
+      }
+    }
+    snapshot.save(*csManager);
+  }
+
+  // without a file nothing is restored
+  BOOST_CHECK_EQUAL(WarmRestartSnapshot(fileName + ".missing").restore(*createApplication().second), 0);
+
+  // after the restart, the control system sees the saved values before the application has written anything
+  auto [csManager, devManager] = createApplication();
+  BOOST_CHECK_EQUAL(snapshot.restore(*devManager), 3);
+
+  auto array = csManager->getProcessArray<int32_t>("/array");
+  BOOST_CHECK(array->readNonBlocking());
+  BOOST_CHECK(array->accessChannel(0) == std::vector<int32_t>({1, 2, 3}));
+  BOOST_CHECK(array->getVersionNumber().getTime() == version.getTime());
+  BOOST_CHECK(array->dataValidity() == DataValidity::ok);
+
+  auto doubleValue = csManager->getProcessArray<double>("/double");
+  BOOST_CHECK(doubleValue->readNonBlocking());
+  BOOST_CHECK_EQUAL(doubleValue->accessData(0), 4.5);
+  BOOST_CHECK(doubleValue->dataValidity() == DataValidity::faulty);
+
+  // the restored value and validity do not stick to the sender of the application
+  auto devDouble = devManager->getProcessArray<double>("/double");
+  BOOST_CHECK(devDouble->dataValidity() == DataValidity::ok);
+  BOOST_CHECK_EQUAL(devDouble->accessData(0), 0.);
+  BOOST_CHECK(devManager->getProcessArray<int32_t>("/array")->accessChannel(0) == std::vector<int32_t>({0, 0, 0}));
+  devDouble->accessData(0) = 5.5;
+  devDouble->write();
+  BOOST_CHECK(doubleValue->readNonBlocking());
+  BOOST_CHECK_EQUAL(doubleValue->accessData(0), 5.5);
+  BOOST_CHECK(doubleValue->dataValidity() == DataValidity::ok);
+
+  auto string = csManager->getProcessArray<std::string>("/string");
+  BOOST_CHECK(string->readNonBlocking());
+  BOOST_CHECK(string->accessChannel(0) == std::vector<std::string>({"hello", ""}));
+
+  BOOST_CHECK(!csManager->getProcessArray<int32_t>("/neverWritten")->readNonBlocking());
+
+  // values written by the application afterwards are newer
+  auto devArray = devManager->getProcessArray<int32_t>("/array");
+  devArray->accessChannel(0) = {7, 8, 9};
+  devArray->write();
+  BOOST_CHECK(array->readNonBlocking());
+  BOOST_CHECK(array->accessChannel(0) == std::vector<int32_t>({7, 8, 9}));
+}
+
+/*********************************************************************************************************************/
+
+BOOST_FIXTURE_TEST_CASE(testChangedApplication, Fixture) {
+  WarmRestartSnapshot snapshot(fileName);
+  {
+    auto [csManager, devManager] = createApplication();
+    devManager->getProcessArray<int32_t>("/array")->write();
+    devManager->getProcessArray<double>("/double")->write();
+    csManager->getProcessArray<int32_t>("/array")->read();
+    csManager->getProcessArray<double>("/double")->read();
+    snapshot.save(*csManager);
+  }
+
+  // variables which have changed their size or no longer exist are skipped
+  auto [csManager, devManager] = createPVManager();
+  devManager->createProcessArray<int32_t>(SynchronizationDirection::deviceToControlSystem, "/array", 5);
+  BOOST_CHECK_EQUAL(snapshot.restore(*devManager), 0);
+  BOOST_CHECK(!csManager->getProcessArray<int32_t>("/array")->readNonBlocking());
+}
+
+/*********************************************************************************************************************/
+
+BOOST_FIXTURE_TEST_CASE(testCorruptFile, Fixture) {
+  WarmRestartSnapshot snapshot(fileName);
+  {
+    auto [csManager, devManager] = createApplication();
+    devManager->getProcessArray<int32_t>("/array")->write();
+    csManager->getProcessArray<int32_t>("/array")->read();
+    snapshot.save(*csManager);
+  }
+
+  // truncate the file
+  std::string content;
+  {
+    std::ifstream file(fileName, std::ios::binary);
+    content.assign(std::istreambuf_iterator<char>(file), {});
+  }
+  {
+    std::ofstream file(fileName, std::ios::binary | std::ios::trunc);
+    file.write(content.data(), static_cast<std::streamsize>(content.size() - 1));
+  }
+  BOOST_CHECK_THROW(snapshot.restore(*createApplication().second), ChimeraTK::runtime_error);
+
+  {
+    std::ofstream file(fileName, std::ios::binary | std::ios::trunc);
+    file << "<PersistentData/>";
+  }
+  BOOST_CHECK_THROW(snapshot.restore(*createApplication().second), ChimeraTK::runtime_error);
+}
+
+/*********************************************************************************************************************/